@@ -0,0 +1,82 @@
+#include <libratss/Calc.h>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+//Compares the continued fraction engines used by ST_CF for different numbers of significands
+
+void help() {
+	std::cout << "prg [-r <number of random values>] [-s <significands>]..." << std::endl;
+}
+
+using namespace LIB_RATSS_NAMESPACE;
+
+int main(int argc, char ** argv) {
+	std::size_t num_rand_values = 1000;
+	std::vector<int> significands;
+
+	for(int i(1); i < argc; ++i) {
+		std::string token(argv[i]);
+		if (token == "-r" && i+1 < argc) {
+			num_rand_values = ::atoi(argv[i+1]);
+			++i;
+		}
+		else if (token == "-s" && i+1 < argc) {
+			significands.push_back(::atoi(argv[i+1]));
+			++i;
+		}
+		else if (token == "-h" || token == "--help") {
+			help();
+			return 0;
+		}
+	}
+	if (!num_rand_values) {
+		help();
+		return -1;
+	}
+	if (significands.empty()) {
+		significands = {128, 256, 512, 1024, 4096, 16384, 65536};
+	}
+
+	gmp_randclass rnd(gmp_randinit_default);
+	rnd.seed(0);
+	Calc calc;
+	Calc::Scratch scratch;
+	std::size_t mismatches = 0;
+	for(int sig : significands) {
+		//the input of contFrac in Calc::snap is a fixpoint number with significands+2 bits
+		std::vector<mpq_class> values(num_rand_values);
+		for(mpq_class & v : values) {
+			v = mpq_class(rnd.get_z_bits(sig+2), mpz_class(1) << (sig+2));
+			v.canonicalize();
+		}
+		std::cout << "Significands: " << sig << std::endl;
+		for(int mode : {ST_GUARANTEE_DISTANCE, ST_GUARANTEE_SIZE}) {
+			std::vector<mpq_class> expected(values.size()), result(values.size());
+			double tClassic = 0;
+			for(int engine : {ST_NONE, ST_CF_LEHMER, ST_CF_HALF_GCD}) {
+				auto start = std::chrono::steady_clock::now();
+				for(std::size_t i(0); i < values.size(); ++i) {
+					calc.contFrac(result[i], values[i], sig+1, mode | engine, scratch);
+				}
+				auto stop = std::chrono::steady_clock::now();
+				double t = std::chrono::duration<double>(stop-start).count();
+				if (engine == ST_NONE) {
+					tClassic = t;
+					expected.swap(result);
+				}
+				else {
+					for(std::size_t i(0); i < values.size(); ++i) {
+						mismatches += (expected[i] != result[i]);
+					}
+				}
+				std::cout << '\t' << (mode == ST_GUARANTEE_DISTANCE ? "GD" : "GS") << ' '
+					<< (engine == ST_NONE ? "classic" : (engine == ST_CF_LEHMER ? "lehmer" : "half-gcd"))
+					<< ": " << t << "s, speedup " << tClassic/t << std::endl;
+			}
+		}
+	}
+	std::cout << "Mismatches: " << mismatches << std::endl;
+	return mismatches ? 1 : 0;
+}
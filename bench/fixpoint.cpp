@@ -0,0 +1,109 @@
+#include <libratss/ProjectSN.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+//Compares fixpoint snapping via mpfr/gmp with the machine integer path used for significands <= 52
+
+void help() {
+	std::cout << "prg [-r <number of random points>] [-s <significands>]" << std::endl;
+}
+
+using namespace LIB_RATSS_NAMESPACE;
+
+namespace {
+
+template<typename T_FUNC>
+double measure(T_FUNC func) {
+	auto start = std::chrono::steady_clock::now();
+	func();
+	auto stop = std::chrono::steady_clock::now();
+	return std::chrono::duration<double>(stop-start).count();
+}
+
+} //end namespace
+
+int main(int argc, char ** argv) {
+	std::size_t num_rand_points = 100000;
+	int significands = 31;
+	const std::size_t dims = 3;
+
+	for(int i(1); i < argc; ++i) {
+		std::string token(argv[i]);
+		if (token == "-r" && i+1 < argc) {
+			num_rand_points = ::atoi(argv[i+1]);
+			++i;
+		}
+		else if (token == "-s" && i+1 < argc) {
+			significands = ::atoi(argv[i+1]);
+			++i;
+		}
+		else if (token == "-h" || token == "--help") {
+			help();
+			return 0;
+		}
+	}
+	if (!num_rand_points || significands < 1) {
+		help();
+		return -1;
+	}
+
+	std::mt19937 gen(0);
+	std::uniform_real_distribution<double> dist(-1, 1);
+	std::vector<double> points;
+	std::vector<mpfr::mpreal> mpPoints;
+	for(std::size_t i(0); i < num_rand_points*dims; ++i) {
+		points.push_back(dist(gen));
+		mpPoints.emplace_back(points.back(), 53);
+	}
+
+	Calc calc;
+	Calc::Scratch scratch;
+	ProjectSN proj;
+	std::vector<mpq_class> general(points.size()), fast(points.size());
+
+	std::cout << "Points: " << num_rand_points << std::endl;
+	std::cout << "Dimension: " << dims << std::endl;
+	std::cout << "Significands: " << significands << std::endl;
+
+	double tGeneral = measure([&]() {
+		for(std::size_t i(0); i < mpPoints.size(); ++i) {
+			general[i] = Conversion<mpfr::mpreal>::toMpq( calc.toFixpoint(mpPoints[i], significands) );
+		}
+	});
+	double tFastMp = measure([&]() {
+		for(std::size_t i(0); i < mpPoints.size(); ++i) {
+			calc.snap(fast[i], mpPoints[i], ST_FX, significands, scratch);
+		}
+	});
+	bool mpEqual = (general == fast);
+	double tFastDouble = measure([&]() {
+		for(std::size_t i(0); i < points.size(); ++i) {
+			calc.snap(fast[i], points[i], ST_FX, significands, scratch);
+		}
+	});
+	bool doubleEqual = (general == fast);
+
+	ProjectSN::SnapConfig sc(ST_FX|ST_PLANE, 53, significands);
+	SnapWorkspace<double> ws(dims);
+	double tProjDouble = measure([&]() {
+		for(std::size_t i(0); i < points.size(); i += dims) {
+			proj.snap(points.cbegin()+i, points.cbegin()+i+dims, fast.begin()+i, sc, ws);
+		}
+	});
+	SnapWorkspace<mpfr::mpreal> mpWs(dims);
+	double tProjMp = measure([&]() {
+		for(std::size_t i(0); i < mpPoints.size(); i += dims) {
+			proj.snap(mpPoints.cbegin()+i, mpPoints.cbegin()+i+dims, general.begin()+i, sc, mpWs);
+		}
+	});
+
+	std::cout << std::setw(40) << std::left << "coordinates: mpfr/gmp" << tGeneral << "s" << std::endl;
+	std::cout << std::setw(40) << std::left << "coordinates: mpreal, machine integers" << tFastMp << "s, speedup " << tGeneral/tFastMp << (mpEqual ? "" : " MISMATCH") << std::endl;
+	std::cout << std::setw(40) << std::left << "coordinates: double, machine integers" << tFastDouble << "s, speedup " << tGeneral/tFastDouble << (doubleEqual ? "" : " MISMATCH") << std::endl;
+	std::cout << std::setw(40) << std::left << "ST_FX|ST_PLANE points: mpreal" << tProjMp << "s" << std::endl;
+	std::cout << std::setw(40) << std::left << "ST_FX|ST_PLANE points: double" << tProjDouble << "s" << std::endl;
+	return (mpEqual && doubleEqual) ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+#include <libratss/GeoCalc.h>
+#include <libratss/ProjectS2.h>
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+//Compares the mpfr and the double-double conversion of geo coordinates to cartesian coordinates
+
+void help() {
+	std::cout << "prg [-r <number of random points>] [-p <precision of mpfr>] [-s <significands>]" << std::endl;
+}
+
+using namespace LIB_RATSS_NAMESPACE;
+
+namespace {
+
+template<typename T_FUNC>
+double measure(T_FUNC func) {
+	auto start = std::chrono::steady_clock::now();
+	func();
+	auto stop = std::chrono::steady_clock::now();
+	return std::chrono::duration<double>(stop-start).count();
+}
+
+} //end namespace
+
+int main(int argc, char ** argv) {
+	std::size_t num_rand_points = 100000;
+	int precision = 128;
+	int significands = 31;
+
+	for(int i(1); i < argc; ++i) {
+		std::string token(argv[i]);
+		if (token == "-r" && i+1 < argc) {
+			num_rand_points = ::atoi(argv[i+1]);
+			++i;
+		}
+		else if (token == "-p" && i+1 < argc) {
+			precision = ::atoi(argv[i+1]);
+			++i;
+		}
+		else if (token == "-s" && i+1 < argc) {
+			significands = ::atoi(argv[i+1]);
+			++i;
+		}
+		else if (token == "-h" || token == "--help") {
+			help();
+			return 0;
+		}
+	}
+	if (!num_rand_points || precision < 53 || significands < 1) {
+		help();
+		return -1;
+	}
+
+	std::mt19937 gen(0);
+	std::uniform_real_distribution<double> latDist(-90, 90);
+	std::uniform_real_distribution<double> lonDist(-180, 180);
+	std::vector<double> lat, lon;
+	std::vector<mpfr::mpreal> mpLat, mpLon;
+	for(std::size_t i(0); i < num_rand_points; ++i) {
+		lat.push_back(latDist(gen));
+		lon.push_back(lonDist(gen));
+		mpLat.emplace_back(lat.back(), precision);
+		mpLon.emplace_back(lon.back(), precision);
+	}
+
+	GeoCalc gc;
+	std::vector<mpfr::mpreal> mpCartesian(3*num_rand_points);
+	std::vector<internal::DoubleDouble> ddCartesian(3*num_rand_points);
+
+	std::cout << "Points: " << num_rand_points << std::endl;
+	std::cout << "Precision: " << precision << std::endl;
+	std::cout << "Significands: " << significands << std::endl;
+
+	double tMpfr = measure([&]() {
+		for(std::size_t i(0); i < num_rand_points; ++i) {
+			gc.cartesian(mpLat[i], mpLon[i], mpCartesian[3*i], mpCartesian[3*i+1], mpCartesian[3*i+2]);
+		}
+	});
+	double tDD = measure([&]() {
+		for(std::size_t i(0); i < num_rand_points; ++i) {
+			gc.cartesian(lat[i], lon[i], ddCartesian[3*i], ddCartesian[3*i+1], ddCartesian[3*i+2]);
+		}
+	});
+	//the error is only meaningful if mpfr is more accurate than the double-double kernel
+	mpfr::mpreal maxError(0, precision), error(0, precision);
+	for(std::size_t i(0); i < mpCartesian.size(); ++i) {
+		error = abs(mpCartesian[i] - ddCartesian[i].hi - ddCartesian[i].lo);
+		if (error > maxError) {
+			maxError = error;
+		}
+	}
+
+	ProjectS2 proj;
+	mpq_class x, y, z;
+	double tProjMpfr = measure([&]() {
+		for(std::size_t i(0); i < num_rand_points; ++i) {
+			//geo input with more digits than a double
+			proj.projectFromGeo(mpLat[i] + mpfr::mpreal(1e-30, precision), mpLon[i], x, y, z, significands);
+		}
+	});
+	double tProjDD = measure([&]() {
+		for(std::size_t i(0); i < num_rand_points; ++i) {
+			proj.projectFromGeo(mpLat[i], mpLon[i], x, y, z, significands);
+		}
+	});
+
+	std::cout << std::setw(40) << std::left << "cartesian: mpfr" << tMpfr << "s" << std::endl;
+	std::cout << std::setw(40) << std::left << "cartesian: double-double" << tDD << "s, speedup " << tMpfr/tDD << std::endl;
+	std::cout << std::setw(40) << std::left << "max error: double-double" << "2^" << std::log2(maxError.toDouble()) << std::endl;
+	std::cout << std::setw(40) << std::left << "projectFromGeo: mpfr" << tProjMpfr << "s" << std::endl;
+	std::cout << std::setw(40) << std::left << "projectFromGeo: double-double" << tProjDD << "s, speedup " << tProjMpfr/tProjDD << std::endl;
+	return 0;
+}
@@ -0,0 +1,137 @@
+#include <libratss/ProjectSN.h>
+
+#include "../common/stats.h"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+//Compares simultaneous approximation by multidimensional continued fractions (ST_JP) with lattice reduction (ST_FPLLL)
+//on uniformly distributed random points of the unit sphere of any dimension.
+//These are not the inputs of the nd_projection test, getRandomPolarPoints only generates points on S^2 and needs CGAL.
+//--json prints the SnapStats of every snap type as one json object per line, distances are in units of 2^-significands
+
+void help() {
+	std::cout << "prg [-r <number of random points>] [-d <dimension>] [-p <precision>] [-s <significands>] [--json]" << std::endl;
+}
+
+using namespace LIB_RATSS_NAMESPACE;
+
+int main(int argc, char ** argv) {
+	std::size_t num_rand_points = 1000;
+	std::size_t dims = 4;
+	int precision = 128;
+	int significands = 31;
+	bool json = false;
+
+	for(int i(1); i < argc; ++i) {
+		std::string token(argv[i]);
+		if (token == "-r" && i+1 < argc) {
+			num_rand_points = ::atoi(argv[i+1]);
+			++i;
+		}
+		else if (token == "-d" && i+1 < argc) {
+			dims = ::atoi(argv[i+1]);
+			++i;
+		}
+		else if (token == "-p" && i+1 < argc) {
+			precision = ::atoi(argv[i+1]);
+			++i;
+		}
+		else if (token == "-s" && i+1 < argc) {
+			significands = ::atoi(argv[i+1]);
+			++i;
+		}
+		else if (token == "--json") {
+			json = true;
+		}
+		else if (token == "-h" || token == "--help") {
+			help();
+			return 0;
+		}
+	}
+	if (!num_rand_points || dims < 2 || significands < 2) {
+		help();
+		return -1;
+	}
+
+	ProjectSN proj;
+	const Calc & calc = proj.calc();
+
+	//normally distributed coordinates give uniformly distributed points on the sphere
+	std::mt19937 gen(0);
+	std::normal_distribution<double> dist;
+	std::vector<mpfr::mpreal> points;
+	points.reserve(num_rand_points*dims);
+	for(std::size_t i(0); i < num_rand_points*dims; ++i) {
+		points.emplace_back(dist(gen), precision);
+	}
+	for(std::size_t i(0); i < num_rand_points; ++i) {
+		auto it = points.begin()+i*dims;
+		calc.normalize(it, it+dims, it);
+	}
+
+	std::vector<int> snapTypes = {
+		ST_CF_GUARANTEE_DISTANCE|ST_PLANE,
+		ST_JP_GUARANTEE_DISTANCE|ST_PLANE, ST_JP_GUARANTEE_SIZE|ST_PLANE
+	};
+#if defined(LIB_RATSS_WITH_FPLLL)
+	snapTypes.insert(snapTypes.end(), {ST_FPLLL_GUARANTEE_DISTANCE|ST_PLANE, ST_FPLLL_GUARANTEE_SIZE|ST_PLANE});
+#else
+	std::cerr << "libratss was built without fplll, lattice reduction is skipped" << std::endl;
+#endif
+
+	if (!json) {
+		std::cout << "Points: " << num_rand_points << std::endl;
+		std::cout << "Dimension: " << dims << std::endl;
+		std::cout << "Precision: " << precision << std::endl;
+		std::cout << "Significands: " << significands << std::endl;
+		std::cout << std::setw(40) << std::left << "Snap type"
+			<< std::setw(12) << "time [s]"
+			<< std::setw(16) << "p99 [us/point]"
+			<< std::setw(24) << "avg max denom [bits]"
+			<< "max distance [2^-significands]" << std::endl;
+	}
+
+	mpq_class eps(mpz_class(1), mpz_class(1) << significands);
+	std::vector<mpq_class> result(num_rand_points*dims);
+	for(int st : snapTypes) {
+		ProjectSN::SnapConfig sc(st, precision, significands);
+		SnapWorkspace<mpfr::mpreal> ws;
+		SnapStats stats;
+		auto start = std::chrono::steady_clock::now();
+		for(std::size_t i(0); i < num_rand_points; ++i) {
+			auto it = points.cbegin()+i*dims;
+			auto pointStart = std::chrono::steady_clock::now();
+			proj.snap(it, it+dims, result.begin()+i*dims, sc, ws);
+			stats.latency.record(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - pointStart).count());
+		}
+		auto stop = std::chrono::steady_clock::now();
+
+		std::size_t sumMaxDenom = 0;
+		mpq_class maxNorm(0);
+		for(std::size_t i(0); i < num_rand_points; ++i) {
+			auto it = points.cbegin()+i*dims;
+			auto rit = result.cbegin()+i*dims;
+			sumMaxDenom += calc.maxDenom(rit, rit+dims);
+			mpq_class norm = calc.maxNorm(it, it+dims, rit);
+			maxNorm = std::max(maxNorm, norm);
+			stats.update(rit, rit+dims);
+			stats.distance.record(mpq_class(norm/eps).get_d());
+		}
+		if (json) {
+			std::cout << "{\"snapType\": \"" << ProjectSN::toString((SnapType) st) << "\", \"stats\": ";
+			stats.printJson(std::cout);
+			std::cout << '}' << std::endl;
+			continue;
+		}
+		std::cout << std::setw(40) << std::left << ProjectSN::toString((SnapType) st)
+			<< std::setw(12) << std::chrono::duration<double>(stop-start).count()
+			<< std::setw(16) << stats.latency.quantile(0.99)/1000
+			<< std::setw(24) << double(sumMaxDenom)/num_rand_points
+			<< mpq_class(maxNorm/eps).get_d() << std::endl;
+	}
+	return 0;
+}
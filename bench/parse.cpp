@@ -0,0 +1,115 @@
+#include <libratss/util/InputOutputPoints.h>
+#include <libratss/util/MappedFile.h>
+#include <libratss/util/TextPointParser.h>
+#include <libratss/internal/WorkStealingExecutor.h>
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+//Compares parsing a point file with iostreams to parsing a memory mapped file with TextPointParser
+
+void help() {
+	std::cout << "prg -i <file> [-if float|rational|split] [-t <threads>]" << std::endl;
+}
+
+using namespace LIB_RATSS_NAMESPACE;
+
+namespace {
+
+template<typename T_FUNC>
+double measure(T_FUNC func) {
+	auto start = std::chrono::steady_clock::now();
+	func();
+	auto stop = std::chrono::steady_clock::now();
+	return std::chrono::duration<double>(stop-start).count();
+}
+
+} //end namespace
+
+int main(int argc, char ** argv) {
+	std::string fileName;
+	PointBase::Format fmt = PointBase::FM_CARTESIAN_FLOAT;
+	std::size_t threads = 0;
+
+	for(int i(1); i < argc; ++i) {
+		std::string token(argv[i]);
+		if (token == "-i" && i+1 < argc) {
+			fileName = argv[i+1];
+			++i;
+		}
+		else if (token == "-if" && i+1 < argc) {
+			token = argv[i+1];
+			if (token == "rational") {
+				fmt = PointBase::FM_CARTESIAN_RATIONAL;
+			}
+			else if (token == "split") {
+				fmt = PointBase::FM_CARTESIAN_SPLIT_RATIONAL;
+			}
+			++i;
+		}
+		else if (token == "-t" && i+1 < argc) {
+			threads = ::atoi(argv[i+1]);
+			++i;
+		}
+		else if (token == "-h" || token == "--help") {
+			help();
+			return 0;
+		}
+	}
+	if (fileName.empty()) {
+		help();
+		return -1;
+	}
+
+	std::size_t streamPoints = 0;
+	double tStream = measure([&]() {
+		std::ifstream is(fileName);
+		FloatPoint p;
+		while (is.good()) {
+			for( ; is.good() && is.peek() == '\n'; is.get()) {}
+			if (!is.good()) {
+				break;
+			}
+			p.assign(is, fmt, 53);
+			++streamPoints;
+		}
+	});
+
+	MappedFile file(fileName);
+	std::size_t mappedPoints = 0;
+	double tMapped = measure([&]() {
+		TextPointParser parser;
+		FloatPoint p;
+		const char * end = file.span().end;
+		for(const char * it = file.data(); (it = TextPointParser::skipLineBreaks(it, end)) != end; ++mappedPoints) {
+			it = parser.parse(it, end, fmt, 53, p);
+		}
+	});
+
+	internal::WorkStealingExecutor executor(threads);
+	std::vector<MappedFile::Span> chunks = file.chunks(4*executor.threadCount());
+	std::vector<std::size_t> chunkPoints(chunks.size(), 0);
+	double tParallel = measure([&]() {
+		std::vector<TextPointParser> parsers(executor.threadCount(chunks.size()));
+		std::vector<FloatPoint> points(parsers.size());
+		executor.run(chunks.size(), [&](std::size_t workerId, std::size_t chunkId) {
+			const char * end = chunks[chunkId].end;
+			for(const char * it = chunks[chunkId].begin; (it = TextPointParser::skipLineBreaks(it, end)) != end; ++chunkPoints[chunkId]) {
+				it = parsers[workerId].parse(it, end, fmt, 53, points[workerId]);
+			}
+		});
+	});
+	std::size_t parallelPoints = 0;
+	for(std::size_t x : chunkPoints) {
+		parallelPoints += x;
+	}
+
+	std::cout << "File size: " << file.size() << " bytes" << std::endl;
+	std::cout << "Points: " << streamPoints << std::endl;
+	std::cout << std::setw(32) << std::left << "iostream" << tStream << "s, " << file.size()/tStream/(1<<20) << " MiB/s" << std::endl;
+	std::cout << std::setw(32) << std::left << "mapped" << tMapped << "s, " << file.size()/tMapped/(1<<20) << " MiB/s" << std::endl;
+	std::cout << std::setw(32) << std::left << ("mapped, " + std::to_string(executor.threadCount(chunks.size())) + " threads") << tParallel << "s, " << file.size()/tParallel/(1<<20) << " MiB/s" << std::endl;
+	return (streamPoints == mappedPoints && streamPoints == parallelPoints) ? 0 : 1;
+}
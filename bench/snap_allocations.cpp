@@ -0,0 +1,139 @@
+#include <libratss/ProjectSN.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+
+//Counts heap allocations done by gmp/mpfr and by operator new while snapping points
+//with and without a reusable SnapWorkspace
+
+namespace {
+
+std::atomic<std::size_t> allocCount{0};
+
+void * countingAlloc(std::size_t size) {
+	++allocCount;
+	return std::malloc(size);
+}
+
+void * countingRealloc(void * ptr, std::size_t /*oldSize*/, std::size_t newSize) {
+	++allocCount;
+	return std::realloc(ptr, newSize);
+}
+
+void countingFree(void * ptr, std::size_t /*size*/) {
+	std::free(ptr);
+}
+
+} //end namespace
+
+void * operator new(std::size_t size) {
+	++allocCount;
+	void * ptr = std::malloc(size ? size : 1);
+	if (!ptr) {
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void operator delete(void * ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+void help() {
+	std::cout << "prg [-r <number of random points>] [-d <dimension>] [-p <precision>] [-s <significands>]" << std::endl;
+}
+
+using namespace LIB_RATSS_NAMESPACE;
+
+int main(int argc, char ** argv) {
+	std::size_t num_rand_points = 10000;
+	std::size_t dims = 3;
+	int precision = 128;
+	int significands = 31;
+
+	for(int i(1); i < argc; ++i) {
+		std::string token(argv[i]);
+		if (token == "-r" && i+1 < argc) {
+			num_rand_points = ::atoi(argv[i+1]);
+			++i;
+		}
+		else if (token == "-d" && i+1 < argc) {
+			dims = ::atoi(argv[i+1]);
+			++i;
+		}
+		else if (token == "-p" && i+1 < argc) {
+			precision = ::atoi(argv[i+1]);
+			++i;
+		}
+		else if (token == "-s" && i+1 < argc) {
+			significands = ::atoi(argv[i+1]);
+			++i;
+		}
+		else if (token == "-h" || token == "--help") {
+			help();
+			return 0;
+		}
+	}
+	if (!num_rand_points || dims < 2) {
+		help();
+		return -1;
+	}
+
+	mp_set_memory_functions(&countingAlloc, &countingRealloc, &countingFree);
+	mpfr::mpreal::set_default_prec(precision);
+
+	std::mt19937 gen(0);
+	std::uniform_real_distribution<double> dist(-1, 1);
+	std::vector<mpfr::mpreal> points;
+	points.reserve(num_rand_points*dims);
+	for(std::size_t i(0); i < num_rand_points*dims; ++i) {
+		points.emplace_back(dist(gen), precision);
+	}
+	std::vector<mpq_class> result(dims);
+
+	ProjectSN proj;
+	SnapWorkspace<mpfr::mpreal> ws;
+	ws.reserve(dims);
+
+	std::cout << "Points: " << num_rand_points << std::endl;
+	std::cout << "Dimension: " << dims << std::endl;
+	std::cout << "Precision: " << precision << std::endl;
+	std::cout << "Significands: " << significands << std::endl;
+	std::cout << std::setw(32) << std::left << "Snap type" << std::setw(16) << "allocs/point" << "allocs/point with workspace" << std::endl;
+	for(int st : {
+		ST_FX|ST_PLANE, ST_FX|ST_SPHERE, ST_FX|ST_PLANE|ST_NORMALIZE,
+		ST_FL|ST_PLANE, ST_FL|ST_SPHERE, ST_FL|ST_PLANE|ST_NORMALIZE,
+		ST_CF|ST_PLANE|ST_NORMALIZE})
+	{
+		ProjectSN::SnapConfig sc(st, precision, significands);
+		double perPoint[2];
+		for(int withWs(0); withWs < 2; ++withWs) {
+			//warm up: the result and the workspace reach their final size
+			for(std::size_t i(0); i < std::min<std::size_t>(num_rand_points, 16); ++i) {
+				auto it = points.cbegin()+i*dims;
+				proj.snap(it, it+dims, result.begin(), sc, ws);
+			}
+			std::size_t before = allocCount;
+			for(std::size_t i(0); i < num_rand_points; ++i) {
+				auto it = points.cbegin()+i*dims;
+				if (withWs) {
+					proj.snap(it, it+dims, result.begin(), sc, ws);
+				}
+				else {
+					proj.snap(it, it+dims, result.begin(), sc);
+				}
+			}
+			perPoint[withWs] = double(allocCount-before)/num_rand_points;
+		}
+		std::cout << std::setw(32) << std::left << ProjectSN::toString((SnapType) st) << std::setw(16) << perPoint[0] << perPoint[1] << std::endl;
+	}
+	return 0;
+}
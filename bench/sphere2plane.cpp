@@ -0,0 +1,80 @@
+#include <libratss/ProjectSN.h>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+//Compares ProjectSN::sphere2Plane point by point with the blocked kernel used by ProjectSN::snapBatch
+
+void help() {
+	std::cout << "prg [-r <number of random points>] [-d <dimension>]" << std::endl;
+}
+
+using namespace LIB_RATSS_NAMESPACE;
+
+int main(int argc, char ** argv) {
+	std::size_t num_rand_points = 1000000;
+	std::size_t dims = 3;
+
+	for(int i(1); i < argc; ++i) {
+		std::string token(argv[i]);
+		if (token == "-r" && i+1 < argc) {
+			num_rand_points = ::atoi(argv[i+1]);
+			++i;
+		}
+		else if (token == "-d" && i+1 < argc) {
+			dims = ::atoi(argv[i+1]);
+			++i;
+		}
+		else if (token == "-h" || token == "--help") {
+			help();
+			return 0;
+		}
+	}
+	if (!num_rand_points || dims < 2) {
+		help();
+		return -1;
+	}
+
+	std::mt19937 gen(0);
+	std::uniform_real_distribution<double> dist(-1, 1);
+	std::vector<double> points(num_rand_points*dims); //one point after the other
+	std::vector<double> soa(points.size()); //one coordinate after the other
+	for(std::size_t i(0); i < num_rand_points; ++i) {
+		for(std::size_t j(0); j < dims; ++j) {
+			points[i*dims+j] = soa[j*num_rand_points+i] = dist(gen);
+		}
+	}
+
+	ProjectSN proj;
+	std::vector<double> plane(points.size()), soaPlane(points.size());
+	std::vector<int> pos(num_rand_points), soaPos(num_rand_points);
+
+	auto start = std::chrono::steady_clock::now();
+	for(std::size_t i(0); i < num_rand_points; ++i) {
+		pos[i] = proj.sphere2Plane(points.cbegin()+i*dims, points.cbegin()+(i+1)*dims, plane.begin()+i*dims);
+	}
+	auto stop = std::chrono::steady_clock::now();
+	double tScalar = std::chrono::duration<double>(stop-start).count();
+
+	start = std::chrono::steady_clock::now();
+	internal::SphereToPlaneBatch::run(soa.data(), dims, num_rand_points, num_rand_points, soaPlane.data(), soaPos.data());
+	stop = std::chrono::steady_clock::now();
+	double tBatch = std::chrono::duration<double>(stop-start).count();
+
+	std::size_t mismatches = 0;
+	for(std::size_t i(0); i < num_rand_points; ++i) {
+		mismatches += (pos[i] != soaPos[i]);
+		for(std::size_t j(0); j < dims; ++j) {
+			mismatches += (plane[i*dims+j] != soaPlane[j*num_rand_points+i]);
+		}
+	}
+
+	std::cout << "Points: " << num_rand_points << std::endl;
+	std::cout << "Dimension: " << dims << std::endl;
+	std::cout << "Instruction set: " << internal::SphereToPlaneBatch::instructionSet() << std::endl;
+	std::cout << "ProjectSN::sphere2Plane: " << tScalar << "s" << std::endl;
+	std::cout << "SphereToPlaneBatch: " << tBatch << "s, speedup " << tScalar/tBatch << std::endl;
+	std::cout << "Mismatches: " << mismatches << std::endl;
+	return mismatches ? 1 : 0;
+}
@@ -1,5 +1,7 @@
 #include "stats.h"
 
+#include <cmath>
+#include <stdexcept>
 
 namespace LIB_RATSS_NAMESPACE {
 
@@ -21,6 +23,13 @@ void BitCount::update(mpq_class v) {
 	
 }
 
+void BitCount::merge(const BitCount & other) {
+	numBits.merge(other.numBits);
+	denomBits.merge(other.denomBits);
+	numLimbs.merge(other.numLimbs);
+	denomLimbs.merge(other.denomLimbs);
+}
+
 void BitCount::print(std::ostream & out) const {
 	out << "Bit counts:\n";
 	numBits.print(out, "\tNumerator ");
@@ -38,6 +47,188 @@ std::ostream & operator<<(std::ostream& out, const BitCount & bc) {
 	return out;
 }
 
+LogHistogram::LogHistogram(int precision) :
+m_precision(precision)
+{
+	if (precision < 0 || precision > 20) {
+		throw std::invalid_argument("ratss::LogHistogram: precision has to be in [0, 20]");
+	}
+}
+
+void LogHistogram::record(double v) {
+	if (!(v >= 0) || !std::isfinite(v)) {
+		throw std::domain_error("ratss::LogHistogram::record: value has to be finite and >= 0");
+	}
+	if (!m_count) {
+		m_min = m_max = v;
+	}
+	else {
+		m_min = std::min(m_min, v);
+		m_max = std::max(m_max, v);
+	}
+	++m_count;
+	m_sum += v;
+	if (v == 0) {
+		++m_zeros;
+		return;
+	}
+	int k = key(v);
+	if (m_counts.empty()) {
+		m_firstKey = k;
+	}
+	else if (k < m_firstKey) {
+		m_counts.insert(m_counts.begin(), m_firstKey - k, 0);
+		m_firstKey = k;
+	}
+	std::size_t pos = k - m_firstKey;
+	if (pos >= m_counts.size()) {
+		m_counts.resize(pos+1, 0);
+	}
+	++m_counts[pos];
+}
+
+void LogHistogram::merge(const LogHistogram & other) {
+	if (m_precision != other.m_precision) {
+		throw std::invalid_argument("ratss::LogHistogram::merge: histograms have different precisions");
+	}
+	if (!other.m_count) {
+		return;
+	}
+	if (!m_count) {
+		*this = other;
+		return;
+	}
+	m_min = std::min(m_min, other.m_min);
+	m_max = std::max(m_max, other.m_max);
+	m_count += other.m_count;
+	m_sum += other.m_sum;
+	m_zeros += other.m_zeros;
+	if (other.m_counts.empty()) {
+		return;
+	}
+	if (m_counts.empty()) {
+		m_counts = other.m_counts;
+		m_firstKey = other.m_firstKey;
+		return;
+	}
+	if (other.m_firstKey < m_firstKey) {
+		m_counts.insert(m_counts.begin(), m_firstKey - other.m_firstKey, 0);
+		m_firstKey = other.m_firstKey;
+	}
+	std::size_t offset = other.m_firstKey - m_firstKey;
+	if (offset + other.m_counts.size() > m_counts.size()) {
+		m_counts.resize(offset + other.m_counts.size(), 0);
+	}
+	for(std::size_t i(0), s(other.m_counts.size()); i < s; ++i) {
+		m_counts[offset+i] += other.m_counts[i];
+	}
+}
+
+void LogHistogram::reset() {
+	m_count = m_zeros = 0;
+	m_min = m_max = m_sum = 0;
+	m_firstKey = 0;
+	m_counts.clear();
+}
+
+double LogHistogram::quantile(double q) const {
+	if (!m_count) {
+		return 0;
+	}
+	if (q <= 0) {
+		return m_min;
+	}
+	if (q >= 1) {
+		return m_max;
+	}
+	std::size_t rank = std::max<std::size_t>(1, std::ceil(q*m_count));
+	if (rank <= m_zeros) {
+		return 0;
+	}
+	rank -= m_zeros;
+	for(std::size_t i(0), s(m_counts.size()); i < s; ++i) {
+		if (rank <= m_counts[i]) {
+			int k = m_firstKey + int(i);
+			double lower = lowerBound(k);
+			double upper = lowerBound(k+1);
+			//buckets of width 1 hold a single integer
+			double v = (upper - lower <= 1) ? lower : (lower+upper)/2;
+			return std::min(std::max(v, m_min), m_max);
+		}
+		rank -= m_counts[i];
+	}
+	return m_max;
+}
+
+void LogHistogram::printJson(std::ostream & out) const {
+	out << "{\"count\": " << count()
+		<< ", \"min\": " << min()
+		<< ", \"max\": " << max()
+		<< ", \"mean\": " << mean()
+		<< ", \"p50\": " << quantile(0.5)
+		<< ", \"p90\": " << quantile(0.9)
+		<< ", \"p99\": " << quantile(0.99)
+		<< ", \"p999\": " << quantile(0.999) << '}';
+}
+
+void LogHistogram::printCsv(std::ostream & out) const {
+	out << count() << ',' << min() << ',' << max() << ',' << mean() << ','
+		<< quantile(0.5) << ',' << quantile(0.9) << ',' << quantile(0.99) << ',' << quantile(0.999);
+}
+
+const char * LogHistogram::csvHeader() {
+	return "count,min,max,mean,p50,p90,p99,p999";
+}
+
+int LogHistogram::key(double v) const {
+	int e;
+	double m = std::frexp(v, &e); //v = m*2^e with m in [0.5, 1)
+	int sub = int((2*m - 1) * (1 << m_precision));
+	return e*(1 << m_precision) + sub;
+}
+
+double LogHistogram::lowerBound(int key) const {
+	int buckets = 1 << m_precision;
+	int e = key >= 0 ? key/buckets : -((-key + buckets - 1)/buckets);
+	int sub = key - e*buckets;
+	return std::ldexp(1 + double(sub)/buckets, e-1);
+}
+
+SnapStats::SnapStats() {}
+
+void SnapStats::merge(const SnapStats & other) {
+	points += other.points;
+	denomBits.merge(other.denomBits);
+	limbs.merge(other.limbs);
+	distance.merge(other.distance);
+	latency.merge(other.latency);
+}
+
+void SnapStats::printJson(std::ostream & out) const {
+	out << "{\"points\": " << points;
+	out << ", \"denominatorBits\": ";
+	denomBits.printJson(out);
+	out << ", \"limbs\": ";
+	limbs.printJson(out);
+	out << ", \"distance\": ";
+	distance.printJson(out);
+	out << ", \"latencyNs\": ";
+	latency.printJson(out);
+	out << '}';
+}
+
+void SnapStats::printCsv(std::ostream & out) const {
+	out << "metric," << LogHistogram::csvHeader() << '\n';
+	out << "denominatorBits,";
+	denomBits.printCsv(out);
+	out << "\nlimbs,";
+	limbs.printCsv(out);
+	out << "\ndistance,";
+	distance.printCsv(out);
+	out << "\nlatencyNs,";
+	latency.printCsv(out);
+}
+
 template<>
 void
 MinMaxMeanStats<mpfr::mpreal>::update(const mpfr::mpreal & ft) {
@@ -5,6 +5,7 @@
 #include <libratss/constants.h>
 #include <limits>
 #include <ostream>
+#include <vector>
 #include <gmpxx.h>
 #include <mpreal/mpreal.h>
 
@@ -28,6 +29,17 @@ public:
 		m_max = max(m_max, ft);
 		m_sum += ft;
 	}
+	void merge(const MinMaxMeanStats & other) {
+		using std::min;
+		using std::max;
+		if (!other.m_count) {
+			return;
+		}
+		m_count += other.m_count;
+		m_min = min(m_min, other.m_min);
+		m_max = max(m_max, other.m_max);
+		m_sum += other.m_sum;
+	}
 	std::size_t count() const { return m_count; }
 	FT min() const { return m_min; }
 	FT max() const { return m_max; }
@@ -56,11 +68,72 @@ struct BitCount {
 	void update(mpq_class v);
 	template<typename T_INPUT_ITERATOR>
 	void update(T_INPUT_ITERATOR begin, const T_INPUT_ITERATOR & end);
+	void merge(const BitCount & other);
 	void print(std::ostream & out) const;
 };
 
 std::ostream & operator<<(std::ostream& out, const BitCount & bc);
 
+///Histogram of non-negative values with logarithmic buckets similar to HdrHistogram
+///Every power of two is split into 2^precision buckets, so quantiles have a relative error of at most 2^-precision.
+///Histograms with the same precision can be merged, which allows per-thread accumulation.
+class LogHistogram {
+public:
+	explicit LogHistogram(int precision = 5);
+public:
+	///throws std::domain_error if v is negative or not finite
+	void record(double v);
+	///throws std::invalid_argument if the precisions differ
+	void merge(const LogHistogram & other);
+	void reset();
+public:
+	inline int precision() const { return m_precision; }
+	inline std::size_t count() const { return m_count; }
+	inline double min() const { return m_count ? m_min : 0; }
+	inline double max() const { return m_count ? m_max : 0; }
+	inline double sum() const { return m_sum; }
+	inline double mean() const { return m_count ? m_sum/m_count : 0; }
+	///@param q in [0, 1], the result is exact for integers up to 2^(precision+1)
+	double quantile(double q) const;
+	///json object with count, min, max, mean and the 50th, 90th, 99th and 99.9th percentile
+	void printJson(std::ostream & out) const;
+	///csv fields in the same order as printJson()
+	void printCsv(std::ostream & out) const;
+	static const char * csvHeader();
+private:
+	int key(double v) const;
+	double lowerBound(int key) const;
+private:
+	int m_precision;
+	std::size_t m_count{0};
+	std::size_t m_zeros{0};
+	double m_min{0};
+	double m_max{0};
+	double m_sum{0};
+	int m_firstKey{0}; //key of m_counts[0]
+	std::vector<std::size_t> m_counts;
+};
+
+///Snapping quality and latency of a point set
+///Each thread should use its own accumulator, they are combined with merge() at the end
+struct SnapStats {
+	std::size_t points{0};
+	LogHistogram denomBits; //bits of the denominator of each coordinate
+	LogHistogram limbs; //limbs of numerator and denominator of each coordinate
+	LogHistogram distance; //maximum norm of the difference between input and snapped point
+	LogHistogram latency; //nanoseconds needed to snap a point
+	
+	SnapStats();
+	///@param begin iterator of canonical mpq_class coordinates of a snapped point
+	template<typename T_INPUT_ITERATOR>
+	void update(T_INPUT_ITERATOR begin, const T_INPUT_ITERATOR & end);
+	void merge(const SnapStats & other);
+	///single line json object with one entry per histogram
+	void printJson(std::ostream & out) const;
+	///one line per histogram
+	void printCsv(std::ostream & out) const;
+};
+
 template<>
 void MinMaxMeanStats<mpfr::mpreal>::update(const mpfr::mpreal & ft);
 
@@ -76,6 +149,17 @@ void BitCount::update(T_INPUT_ITERATOR begin, const T_INPUT_ITERATOR & end) {
 	}
 }
 
+template<typename T_INPUT_ITERATOR>
+void SnapStats::update(T_INPUT_ITERATOR begin, const T_INPUT_ITERATOR & end) {
+	++points;
+	for(; begin != end; ++begin) {
+		mpz_srcptr num = begin->get_num_mpz_t();
+		mpz_srcptr den = begin->get_den_mpz_t();
+		denomBits.record(mpz_sizeinbase(den, 2));
+		limbs.record(mpz_size(num) + mpz_size(den));
+	}
+}
+
 }//end namespace LIB_RATSS_NAMESPACE
 
 
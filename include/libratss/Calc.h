@@ -5,7 +5,12 @@
 #include <libratss/constants.h>
 #include <libratss/enum.h>
 #include <libratss/Conversion.h>
+#include <libratss/LLLConfig.h>
 #include <libratss/SimApxBruteForce.h>
+#include <libratss/internal/ContinuedFraction.h>
+
+#include <algorithm>
+#include <memory>
 
 #ifdef LIB_RATSS_WITH_FPLLL
 	#include <libratss/SimApxLLL.h>
@@ -16,6 +21,14 @@ namespace LIB_RATSS_NAMESPACE {
 class Calc {
 public:
 	using SnapType = LIB_RATSS_NAMESPACE::SnapType;
+	///Temporaries used by the functions that write into an existing result
+	struct Scratch {
+		mpfr::mpreal ft;
+		mpf_class f;
+		mpq_class q;
+		internal::ContinuedFraction cf;
+		mpz_class intPart, t0, t1;
+	};
 public:
 	template<typename T_FT>
 	inline T_FT add(const T_FT & a, const T_FT & b) const { return a+b; }
@@ -66,6 +79,8 @@ public:
 	///hence abs(v) < 1
 	///everthing above is clipped to infinity
 	mpfr::mpreal toFixpoint(const mpfr::mpreal & v, int significands = -1) const;
+	///same as above but reuses the storage of result, result must not alias v
+	void toFixpoint(mpfr::mpreal & result, const mpfr::mpreal & v, int significands) const;
 #if defined(LIB_RATSS_WITH_CGAL)
 	///create a fixpoint number with abs(p) < 1
 	///hence abs(v) < 1
@@ -95,25 +110,55 @@ public:
 public:
 	///@return r a number satisfying the following conditions:
 	/// r is a fraction with the smallest denominator such that lower <= r <= upper
-	mpq_class within(const mpq_class& lower, const mpq_class& upper) const;
+	///@param cfEngine ST_CF_LEHMER or ST_CF_HALF_GCD select the engine used for the continued fractions
+	mpq_class within(const mpq_class& lower, const mpq_class& upper, int cfEngine = ST_NONE) const;
 	
 	mpq_class contFrac(const mpq_class& value, int significands, int mode) const;
+	///same as above but reuses the storage of result and scratch, result must not be value
+	///ST_CF_LEHMER or ST_CF_HALF_GCD in mode select the engine used for the continued fraction
+	void contFrac(mpq_class & result, const mpq_class & value, int significands, int mode, Scratch & scratch) const;
 	
 	void jacobiPerron2D(const mpq_class& input1, const mpq_class& input2, mpq_class& output1, mpq_class& output2, int significands, int snapTypeGuarantee) const;
+	///Simultaneous approximation of input of any dimension with a multidimensional continued fraction.
+	///Dimension 1 uses contFrac, dimension 2 jacobiPerron2D and higher dimensions the multiplicative algorithm of Brun.
+	///The guarantees of snapTypeGuarantee are the same as for jacobiPerron2D.
+	void jacobiPerron(const std::vector<mpq_class>& input, std::vector<mpq_class>& output, int significands, int snapTypeGuarantee) const;
 	
 	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
 	void apply_common_denominator(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, const mpz_class & common_denom) const;
+	///Exact variant of the above: sets denominator to the least common denominator of the canonical rationals in begin->end
+	///and writes their numerators with respect to it to out, which has to dereference to mpz_class&
+	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+	void commonDenominator(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, mpz_class & denominator) const;
+	///Same as commonDenominator for canonical rationals whose denominators are powers of two like the results of ST_FX:
+	///the common denominator is the largest one and the numerators are shifted instead of divided
+	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+	void commonDenominatorPow2(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, mpz_class & denominator) const;
 	///this will first set common_denom and the write all numerators to out
+	///@param config backend of the LLL reduction, by default the cheapest safe one is selected
 	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
-	void lll(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, mpz_class & common_denom, int significands) const;
+	void lll(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, mpz_class & common_denom, int significands, const LLLConfig & config = LLLConfig()) const;
 	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
-	void lll(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, mpz_class & common_denom, mpq_class epsilon) const;
+	void lll(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, mpz_class & common_denom, mpq_class epsilon, const LLLConfig & config = LLLConfig()) const;
+	///lll for numPoints points with dims coordinates each, point i is [begin+i*dims, begin+(i+1)*dims)
+	///Every point is snapped on its own, see SimApxLLL::runEach
+	///The common denominator of point i is written to denominators[i] and its numerators to numerators[i*dims, (i+1)*dims)
+	///@param threads number of worker threads, 0 uses all available cores
+	template<typename T_RANDOM_ACCESS_INPUT_ITERATOR>
+	void lllEach(T_RANDOM_ACCESS_INPUT_ITERATOR begin, std::size_t numPoints, std::size_t dims, std::vector<mpz_class> & denominators, std::vector<mpz_class> & numerators, int significands, const LLLConfig & config = LLLConfig(), std::size_t threads = 0) const;
 	
 	///In the following v_real is the real unkown value of v and v is an approimation thereof
 	///For ST_CF this computes a snapped rational r with |r - v_real| <= 3/4*2^-significands and r.den <= 2^(significands+2)
 	///For ST_FX|ST_FL this computes a snapped rational r with |r - v_real| <= 2^-significands
 	///ST_FX also guarantees r.den <= 2^significands
 	mpq_class snap(const mpfr::mpreal & v, int st, int significands = -1) const;
+	///same as above but reuses the storage of result and scratch
+	///ST_FX and ST_FL for abs(v) < 1 do not allocate memory once result and scratch are large enough
+	void snap(mpq_class & result, const mpfr::mpreal & v, int st, int significands, Scratch & scratch) const;
+	///Same as snap(mpfr::mpreal(v), st, significands)
+	///ST_FX with significands <= 52 is computed with machine integers
+	mpq_class snap(double v, int st, int significands = -1) const;
+	void snap(mpq_class & result, double v, int st, int significands, Scratch & scratch) const;
 	mpq_class snap(const mpq_class & v, int st, int significands = -1) const;
 	mpq_class snap(const mpq_class & v, int st, const mpq_class & eps) const;
 	//
@@ -125,8 +170,9 @@ public:
 	mpq_class snap(CORE_TWO::BigFloat const & v, int st, int significands = -1) const;
 #endif
 public:
+	///@param lllConfig backend of the LLL reduction used by ST_FPLLL
 	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
-	void toRational(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int eps = -1) const;
+	void toRational(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int eps = -1, const LLLConfig & lllConfig = LLLConfig()) const;
 public:
 	std::size_t maxBitCount(const mpq_class &v) const;
 	std::size_t numBits(const mpz_class &v) const;
@@ -139,6 +185,37 @@ public:
 namespace LIB_RATSS_NAMESPACE {
 	
 
+template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+void Calc::commonDenominator(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, mpz_class & denominator) const {
+	denominator = 1;
+	for(auto it(begin); it != end; ++it) {
+		//denominators of snapped points are often the same
+		if (it->get_den() != denominator) {
+			mpz_lcm(denominator.get_mpz_t(), denominator.get_mpz_t(), it->get_den_mpz_t());
+		}
+	}
+	for(auto it(begin); it != end; ++it, ++out) {
+		mpz_class & num = *out;
+		mpz_divexact(num.get_mpz_t(), denominator.get_mpz_t(), it->get_den_mpz_t());
+		num *= it->get_num();
+	}
+}
+
+template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+void Calc::commonDenominatorPow2(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, mpz_class & denominator) const {
+	mp_bitcnt_t exponent = 0;
+	for(auto it(begin); it != end; ++it) {
+		assert(mpz_popcount(it->get_den_mpz_t()) == 1);
+		exponent = std::max(exponent, mpz_scan1(it->get_den_mpz_t(), 0));
+	}
+	mpz_set_ui(denominator.get_mpz_t(), 1);
+	mpz_mul_2exp(denominator.get_mpz_t(), denominator.get_mpz_t(), exponent);
+	for(auto it(begin); it != end; ++it, ++out) {
+		mpz_class & num = *out;
+		mpz_mul_2exp(num.get_mpz_t(), it->get_num_mpz_t(), exponent - mpz_scan1(it->get_den_mpz_t(), 0));
+	}
+}
+
 template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
 void Calc::apply_common_denominator(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, const mpz_class & common_denom) const {
 	assert(common_denom > 0);
@@ -170,29 +247,49 @@ void Calc::apply_common_denominator(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end
 ///
 #ifdef LIB_RATSS_WITH_FPLLL
 template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
-void Calc::lll(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, mpz_class & common_denom, int significands) const {
+void Calc::lll(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, mpz_class & common_denom, int significands, const LLLConfig & config) const {
 	SimApxLLL<T_INPUT_ITERATOR> worker(begin, end, significands);
-	common_denom = worker.run(true);
+	worker.setLLLConfig(config);
+	worker.run(ST_GUARANTEE_DISTANCE);
+	common_denom = worker.denominator();
 	for(auto it(worker.numerators_begin()); it != worker.numerators_end(); ++it, ++out) {
 		*out = std::move(*it);
 	}
 }
 
 template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
-void Calc::lll(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, mpz_class & common_denom, mpq_class eps) const {
+void Calc::lll(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, mpz_class & common_denom, mpq_class eps, const LLLConfig & config) const {
 	SimApxLLL<T_INPUT_ITERATOR> worker(begin, end, eps);
-	common_denom = worker.run(true);
+	worker.setLLLConfig(config);
+	worker.run(ST_GUARANTEE_DISTANCE);
+	common_denom = worker.denominator();
 	for(auto it(worker.numerators_begin()); it != worker.numerators_end(); ++it, ++out) {
 		*out = std::move(*it);
 	}
 }
+
+template<typename T_RANDOM_ACCESS_INPUT_ITERATOR>
+void Calc::lllEach(T_RANDOM_ACCESS_INPUT_ITERATOR begin, std::size_t numPoints, std::size_t dims, std::vector<mpz_class> & denominators, std::vector<mpz_class> & numerators, int significands, const LLLConfig & config, std::size_t threads) const {
+	if (!numPoints) {
+		denominators.clear();
+		numerators.clear();
+		return;
+	}
+	SimApxLLL<T_RANDOM_ACCESS_INPUT_ITERATOR> prototype(begin, begin+dims, significands);
+	prototype.setLLLConfig(config);
+	prototype.runEach(begin, numPoints, ST_GUARANTEE_DISTANCE, denominators, numerators, threads);
+}
 #else
 template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
-void Calc::lll(T_INPUT_ITERATOR, T_INPUT_ITERATOR, T_OUTPUT_ITERATOR, mpz_class &, int) const {
+void Calc::lll(T_INPUT_ITERATOR, T_INPUT_ITERATOR, T_OUTPUT_ITERATOR, mpz_class &, int, const LLLConfig &) const {
 	throw std::runtime_error("libratss was compiled without snapping using the lll algorithm");
 }
 template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
-void Calc::lll(T_INPUT_ITERATOR, T_INPUT_ITERATOR, T_OUTPUT_ITERATOR, mpz_class &, mpq_class) const {
+void Calc::lll(T_INPUT_ITERATOR, T_INPUT_ITERATOR, T_OUTPUT_ITERATOR, mpz_class &, mpq_class, const LLLConfig &) const {
+	throw std::runtime_error("libratss was compiled without snapping using the lll algorithm");
+}
+template<typename T_RANDOM_ACCESS_INPUT_ITERATOR>
+void Calc::lllEach(T_RANDOM_ACCESS_INPUT_ITERATOR, std::size_t, std::size_t, std::vector<mpz_class> &, std::vector<mpz_class> &, int, const LLLConfig &, std::size_t) const {
 	throw std::runtime_error("libratss was compiled without snapping using the lll algorithm");
 }
 #endif
@@ -217,33 +314,30 @@ void Calc::normalize(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITER
 
 template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
 void
-Calc::toRational(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands) const {
+Calc::toRational(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands, [[maybe_unused]] const LLLConfig & lllConfig) const {
 	using input_ft = typename std::iterator_traits<T_INPUT_ITERATOR>::value_type;
 	if (snapType & ST_JP) {
-		using std::distance;
-		if (distance(begin, end) != 2) {
-			throw std::domain_error("ratss::Calc::toRational: Snapping with jacobiPerron only supports dimension 2");
+		std::vector<mpq_class> input;
+		std::vector<mpq_class> output;
+		for(; begin != end; ++begin) {
+			input.emplace_back( convert<mpq_class>(*begin) );
 		}
-		mpq_class input1( convert<mpq_class>(*begin) );
-		++begin;
-		mpq_class input2( convert<mpq_class>(*begin) );
-		mpq_class output1, output2;
 		if (snapType & ST_GUARANTEE_DISTANCE) {
 			//we have to user one bit more since the input point may not be the exact point that we want to approximate
 			if (snapType & ST_INPUT_IS_EXACT) {
-				jacobiPerron2D(input1, input2, output1, output2, significands, ST_GUARANTEE_DISTANCE);
+				jacobiPerron(input, output, significands, ST_GUARANTEE_DISTANCE);
 			}
 			else {
-				jacobiPerron2D(input1, input2, output1, output2, significands+1, ST_GUARANTEE_DISTANCE);
+				jacobiPerron(input, output, significands+1, ST_GUARANTEE_DISTANCE);
 			}
 		}
 		else {
-			jacobiPerron2D(input1, input2, output1, output2, significands, ST_GUARANTEE_SIZE);
+			jacobiPerron(input, output, significands, ST_GUARANTEE_SIZE);
+		}
+		for(mpq_class & x : output) {
+			*out = std::move(x);
+			++out;
 		}
-		*out = output1;
-		++out;
-		*out = output2;
-		++out;
 	}
 	else if (snapType & (ST_FPLLL_MASK)) {
 		#if defined(LIB_RATSS_WITH_FPLLL)
@@ -255,6 +349,7 @@ Calc::toRational(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR
 			}
 			
 			SimApxLLL<std::vector<mpq_class>::const_iterator> sapx(tmp.cbegin(), tmp.cend());
+			sapx.setLLLConfig(lllConfig);
 			if (snapType & ST_GUARANTEE_DISTANCE) {
 				if (snapType & ST_INPUT_IS_EXACT) {
 					sapx.setSignificands(significands+1);
@@ -286,11 +381,31 @@ Calc::toRational(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR
 				tmp.emplace_back( snap(*it, ST_FX, significands+2) );
 			}
 			
-			SimApxBruteForce<mpq_class,0> sapx(tmp.cbegin(), tmp.cend());
-			sapx.run(significands+1);
-			
-			for(auto it(sapx.numerators_begin()); it != sapx.numerators_end(); ++it, ++out) {
-				*out = *it/sapx.denominator();
+			//the common denominator D of the input is at most 2^(significands+2)
+			//the machine integer engine needs D*2^(significands+1) to fit into int64, check the actual D since it is usually much smaller
+			std::unique_ptr< SimApxBruteForce<std::int64_t,0> > isapx;
+			if (significands+2 < std::numeric_limits<std::int64_t>::digits) {
+				isapx.reset(new SimApxBruteForce<std::int64_t,0>(tmp.cbegin(), tmp.cend()));
+				if (!isapx->fits(std::size_t(1) << (significands+1))) {
+					isapx.reset();
+				}
+			}
+			if (isapx) {
+				isapx->run(significands+1);
+				
+				for(auto it(isapx->numerators_begin()); it != isapx->numerators_end(); ++it, ++out) {
+					mpq_class pq(*it, isapx->denominator());
+					pq.canonicalize();
+					*out = pq;
+				}
+			}
+			else {
+				SimApxBruteForce<mpq_class,0> sapx(tmp.cbegin(), tmp.cend());
+				sapx.run(significands+1);
+				
+				for(auto it(sapx.numerators_begin()); it != sapx.numerators_end(); ++it, ++out) {
+					*out = *it/sapx.denominator();
+				}
 			}
 	}
 	else {
@@ -91,6 +91,8 @@ struct Conversion<mpfr::mpreal> {
 	using type = mpfr::mpreal;
 	static type moveFrom(const mpq_class & v);
 	static mpq_class toMpq(const type & v);
+	///same as toMpq(v) but reuses the storage of result and of tmp which needs the default mpf precision
+	static void toMpq(const type & v, mpq_class & result, mpf_class & tmp);
 	static const mpfr::mpreal & toMpreal(const type & v, int precision);
 };
 
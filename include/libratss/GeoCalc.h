@@ -4,10 +4,50 @@
 
 #include <libratss/constants.h>
 #include <libratss/Calc.h>
+#include <libratss/internal/DoubleDouble.h>
+
+#include <string>
+#include <unordered_map>
 
 namespace LIB_RATSS_NAMESPACE {
 
 class GeoCalc: public Calc {
+public:
+	///Memoizes sine and cosine of the latitudes and longitudes passed to cartesian.
+	///Latitude and longitude enter the cartesian coordinates separately, hence the points of an n x m grid need n+m evaluations instead of n*m.
+	///Angles are keyed on their exact value and precision and the precision of the computation, results are the same as without a cache.
+	///A full cache is cleared. Not thread-safe, use one per thread.
+	class TrigCache {
+	public:
+		static constexpr std::size_t default_max_entries = std::size_t(1) << 16;
+	public:
+		explicit TrigCache(std::size_t maxEntries = default_max_entries);
+	public:
+		void clear();
+		inline std::size_t size() const { return m_entries.size(); }
+		inline std::size_t hits() const { return m_hits; }
+		inline std::size_t misses() const { return m_misses; }
+	private:
+		friend class GeoCalc;
+		struct Entry {
+			mpfr::mpreal sin;
+			mpfr::mpreal cos;
+		};
+	private:
+		///Clears the cache if there is no room for count more entries, entries returned by get stay valid otherwise
+		void reserve(std::size_t count);
+		///@return sine and cosine of deg/180*pi where pi has calcPrecision bits
+		const Entry & get(const mpfr::mpreal & deg, int calcPrecision);
+	private:
+		std::unordered_map<std::string, Entry> m_entries;
+		std::string m_key;
+		std::size_t m_maxEntries;
+		std::size_t m_hits;
+		std::size_t m_misses;
+	};
+public:
+	///Every coordinate computed by the double-double variant of cartesian is within 2^-cartesian_dd_accuracy of the exact value
+	static constexpr int cartesian_dd_accuracy = 99;
 public:
 	bool isOnSphere(const mpfr::mpreal & mpdx, const mpfr::mpreal & mpdy, const mpfr::mpreal & mpdz) const;
 
@@ -16,6 +56,15 @@ public:
 	
 	///lat and lon are in DEGREE! -90 <= lat <= 90 && (0 <= lon <= 360 || -180 <= lon <= 180)
 	void cartesian(const mpfr::mpreal & lat, const mpfr::mpreal & lon, mpfr::mpreal & x, mpfr::mpreal & y, mpfr::mpreal & z) const;
+	///Same as cartesian above but takes sine and cosine from cache
+	void cartesian(const mpfr::mpreal & lat, const mpfr::mpreal & lon, mpfr::mpreal & x, mpfr::mpreal & y, mpfr::mpreal & z, TrigCache & cache) const;
+	///lat and lon are in DEGREE! Uses double-double arithmetic instead of mpfr, see internal::DegreeSinCos
+	void cartesian(double lat, double lon, internal::DoubleDouble & x, internal::DoubleDouble & y, internal::DoubleDouble & z) const;
+	///Uses the double-double variant if lat and lon are doubles and an absolute error of 2^-accuracy suffices, mpfr otherwise.
+	///The double-double result is rounded to the precision the mpfr variant would use.
+	///@param cache memoizes the mpfr variant if not null
+	///@return true if the double-double variant was used
+	bool cartesian(const mpfr::mpreal & lat, const mpfr::mpreal & lon, mpfr::mpreal & x, mpfr::mpreal & y, mpfr::mpreal & z, int accuracy, TrigCache * cache = nullptr) const;
 	void cartesianFromSpherical(const mpfr::mpreal & theta, const mpfr::mpreal & phi, mpfr::mpreal & x, mpfr::mpreal & y, mpfr::mpreal & z) const;
 
 #if defined(LIB_RATSS_WITH_CORE_TWO)
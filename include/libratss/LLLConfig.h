@@ -0,0 +1,70 @@
+#ifndef LIB_RATSS_LLL_CONFIG_H
+#define LIB_RATSS_LLL_CONFIG_H
+#pragma once
+
+#include <libratss/constants.h>
+
+#include <cstddef>
+#include <string>
+
+namespace LIB_RATSS_NAMESPACE {
+
+///Backend of the LLL reduction used by ST_FPLLL, the values mirror fplll::LLLMethod, fplll::FloatType and LLL_EARLY_RED.
+///M_AUTO and FT_AUTO select the cheapest backend whose precision suffices for the proved L^2 algorithm,
+///see Nguyen and Stehle: An LLL Algorithm with Quadratic Complexity (2009).
+///Bases that need more than 64 bits of precision are reduced with MPFR, which is the exact fallback.
+class LLLConfig {
+public:
+	typedef enum : int {
+		M_AUTO=0,
+		M_WRAPPER, //fplll default: heuristic with increasing precision, finishes with the proved version
+		M_FAST, //floating point arithmetic for the basis as well, double only
+		M_HEURISTIC,
+		M_PROVED
+	} Method;
+	typedef enum : int {
+		FT_AUTO=0,
+		FT_DOUBLE,
+		FT_LONG_DOUBLE,
+		FT_DPE, //double with extended exponent
+		FT_MPFR
+	} FloatType;
+public:
+	static constexpr double default_delta = 0.99;
+	static constexpr double default_eta = 0.51;
+public:
+	LLLConfig();
+	LLLConfig(Method method, FloatType floatType, int precision = 0, bool earlyReduction = false);
+	LLLConfig(const LLLConfig & other);
+	LLLConfig & operator=(const LLLConfig & other);
+	bool operator==(const LLLConfig & other) const;
+	bool operator!=(const LLLConfig & other) const;
+public:
+	inline Method method() const { return m_method; }
+	inline FloatType floatType() const { return m_floatType; }
+	///precision in bits for FT_MPFR, 0 lets fplll choose
+	inline int precision() const { return m_precision; }
+	inline bool earlyReduction() const { return m_earlyReduction; }
+public:
+	///@return config without M_AUTO and FT_AUTO for a basis with dimension rows and entries with at most entryBits bits
+	LLLConfig select(int dimension, std::size_t entryBits) const;
+	///@return true if the float type has at least requiredPrecision(dimension) bits
+	bool proved(int dimension) const;
+public:
+	///Proved L^2 with MPFR and sufficient precision
+	static LLLConfig exact(int dimension);
+	///Precision in bits needed by the proved L^2 algorithm with default_delta and default_eta, same as fplll's l2_min_prec
+	static int requiredPrecision(int dimension);
+	///Mantissa bits of the float type, -1 for FT_AUTO
+	static int mantissaBits(FloatType ft, int precision);
+	static std::string toString(const LLLConfig & cfg);
+private:
+	Method m_method;
+	FloatType m_floatType;
+	int m_precision;
+	bool m_earlyReduction;
+};
+
+}//end namespace LIB_RATSS_NAMESPACE
+
+#endif
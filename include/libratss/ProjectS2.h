@@ -35,8 +35,9 @@ public:
 	///all trigonometric functions are calculated using mpfr
 	///You can give the precision of these calculation, all other precisions are then derived from it
 	///lat and lon are in DEGREE! -90 <= lat <= 90 && (0 <= lon <= 360 || -180 <= lon <= 180)
+	///@param cache memoizes the trigonometric functions if not null, this pays off for points on a grid, see GeoCalc::TrigCache
 	template<typename T_FT>
-	void projectFromGeo(mpfr::mpreal lat, mpfr::mpreal lon, T_FT &xs, T_FT &ys, T_FT &zs, int precision = -1, int snapType = ST_FX | ST_PLANE | ST_NORMALIZE) const;
+	void projectFromGeo(mpfr::mpreal lat, mpfr::mpreal lon, T_FT &xs, T_FT &ys, T_FT &zs, int precision = -1, int snapType = ST_FX | ST_PLANE | ST_NORMALIZE, GeoCalc::TrigCache * cache = nullptr) const;
 
 	///the same as projectFromGeo except that one can set the desired maximum distance
 	template<typename T_FT>
@@ -113,7 +114,7 @@ PositionOnSphere ProjectS2::sphere2Plane(const T_FT & xs, const T_FT & ys, const
 }
 
 template<typename T_FT>
-void ProjectS2::projectFromGeo(mpfr::mpreal lat, mpfr::mpreal lon, T_FT& xs, T_FT& ys, T_FT& zs, int precision, int snapType) const {
+void ProjectS2::projectFromGeo(mpfr::mpreal lat, mpfr::mpreal lon, T_FT& xs, T_FT& ys, T_FT& zs, int precision, int snapType, GeoCalc::TrigCache * cache) const {
 	if (precision < 0) {
 		precision = std::max<int>(lat.getPrecision(), lon.getPrecision());
 	}
@@ -137,7 +138,8 @@ void ProjectS2::projectFromGeo(mpfr::mpreal lat, mpfr::mpreal lon, T_FT& xs, T_F
 	lon.setPrecision(tmpPrec);
 
 	//clip to 3D and snap to sphere
-	m_calc.cartesian(lat, lon, flxs, flys, flzs);
+	//double-double arithmetic suffices if its error is below the square of the snapping resolution
+	m_calc.cartesian(lat, lon, flxs, flys, flzs, 2*precision+1, cache);
 	snap(flxs, flys, flzs, xpq, ypq, zpq, precision, snapType);
 	
 	xs = Conversion<T_FT>::moveFrom( std::move(xpq) );
@@ -4,11 +4,22 @@
 
 #include <libratss/constants.h>
 #include <libratss/Calc.h>
+#include <libratss/SnapWorkspace.h>
+#include <libratss/SnapCache.h>
 
 #include "internal/SkipIterator.h"
+#include "internal/WorkStealingExecutor.h"
+#include "internal/InplaceArithmetic.h"
+#include "internal/FixedWidthPlane2Sphere.h"
+#include "internal/SphereToPlaneBatch.h"
 
 #include <assert.h>
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <type_traits>
 #include <vector>
 
 namespace LIB_RATSS_NAMESPACE {
@@ -27,10 +38,24 @@ public:
 		int snapType() const;
 		int precision(int dimensions) const;
 		int significands(int dimensions) const;
+		///backend of the LLL reduction used by ST_FPLLL
+		const LLLConfig & lll() const;
+		void setLLL(const LLLConfig & v);
+		///number of threads that evaluate the candidate snap types of ST_AUTO for a single point, 0 uses all available cores
+		///This reduces the latency of snapping single points, snapBatch() always evaluates them sequentially
+		std::size_t autoThreads() const;
+		void setAutoThreads(std::size_t v);
+		///results of snap() and snapBatch() are looked up in and added to the cache if it is set
+		///Keys do not include the LLL backend, do not share a cache between configurations with different lll()
+		const std::shared_ptr<SnapCache> & cache() const;
+		void setCache(const std::shared_ptr<SnapCache> & v);
 	private:
 		int m_st;
 		int m_precision;
 		int m_significands;
+		LLLConfig m_lll;
+		std::size_t m_autoThreads;
+		std::shared_ptr<SnapCache> m_cache;
 	};
 public:
 	static std::string toString(SnapType st);
@@ -55,6 +80,47 @@ public:
 	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
 	void snap(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, const SnapConfig & sc) const;
 	
+	///Same as above, but all temporaries are taken from ws
+	///@param out an iterator accepting mpq_class
+	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+	void snap(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands,
+		SnapWorkspace<typename std::iterator_traits<T_INPUT_ITERATOR>::value_type> & ws) const;
+	
+	///@param out an iterator accepting mpq_class
+	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+	void snap(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, const SnapConfig & sc,
+		SnapWorkspace<typename std::iterator_traits<T_INPUT_ITERATOR>::value_type> & ws) const;
+	
+	///Snaps a contiguous array of points with dims coordinates each
+	///Point i is read from [begin+i*dims, begin+(i+1)*dims) and written to [out+i*dims, out+(i+1)*dims)
+	///The result is identical to calling snap() for every point, independent of the number of threads
+	///Points of type double that are snapped in the plane are projected in blocks using SIMD instructions if available
+	///@param threads number of worker threads, 0 uses all available cores
+	template<typename T_RANDOM_ACCESS_INPUT_ITERATOR, typename T_RANDOM_ACCESS_OUTPUT_ITERATOR>
+	void snapBatch(T_RANDOM_ACCESS_INPUT_ITERATOR begin, T_RANDOM_ACCESS_INPUT_ITERATOR end, std::size_t dims, T_RANDOM_ACCESS_OUTPUT_ITERATOR out, const SnapConfig & sc, std::size_t threads = 0) const;
+	
+	///@param out is resized to hold points.size() coordinates
+	template<typename T_FT>
+	void snapBatch(const std::vector<T_FT> & points, std::size_t dims, std::vector<mpq_class> & out, const SnapConfig & sc, std::size_t threads = 0) const;
+	
+	///Same as snap(), but the result is the homogeneous point numerators[i]/denominator which is not necessarily reduced.
+	///Points snapped on the sphere or in the plane are projected back with the common denominator of their plane coordinates,
+	///hence no coordinate is canonicalized. ST_AUTO, ST_PAPER, ST_PAPER2 and a cache produce the canonical point first.
+	///@param numerators an iterator dereferencing to mpz_class&
+	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+	void snapHomogeneous(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR numerators, mpz_class & denominator, int snapType, int significands = -1) const;
+	
+	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+	void snapHomogeneous(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR numerators, mpz_class & denominator, int snapType, int significands,
+		SnapWorkspace<typename std::iterator_traits<T_INPUT_ITERATOR>::value_type> & ws) const;
+	
+	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+	void snapHomogeneous(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR numerators, mpz_class & denominator, const SnapConfig & sc) const;
+	
+	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+	void snapHomogeneous(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR numerators, mpz_class & denominator, const SnapConfig & sc,
+		SnapWorkspace<typename std::iterator_traits<T_INPUT_ITERATOR>::value_type> & ws) const;
+	
 public:
 	inline const Calc & calc() const { return m_calc; }
 private:
@@ -65,14 +131,68 @@ private:
 		int significands;
 		std::size_t dims;
 		StOptimizer(const ProjectSN * parent, int snapType, int significands, std::size_t dims);
-		template<typename T_ITERATOR>
-		int best(const T_ITERATOR & begin, const T_ITERATOR & end) const;
-		template<typename T_ITERATOR_INPUT, typename T_ITERATOR_OUTPUT>
-		GRADE_TYPE grade(const T_ITERATOR_INPUT & input_begin, const T_ITERATOR_INPUT & input_end, const T_ITERATOR_OUTPUT & output_begin, const T_ITERATOR_OUTPUT & output_end) const;
+		///Snaps the point with the enabled candidates in the order of their mean snap time in ws.autoStats.
+		///Candidates are skipped once the best reached minGrade() and grading stops as soon as a candidate can not win anymore.
+		///The result is the same as the one of an exhaustive search, ties are resolved by the order of AutoSnapStats::candidates.
+		///@return the best snap type, the point snapped with it is in ws.autoBest
+		template<typename T_ITERATOR, typename T_FT>
+		int best(const T_ITERATOR & begin, const T_ITERATOR & end, SnapWorkspace<T_FT> & ws) const;
+		///@param i index into AutoSnapStats::candidates
+		inline bool enabled(std::size_t i) const { return (AutoSnapStats::candidates[i] << ST__INTERNAL_NUMBER_OF_SNAPPING_TYPES) & snapType; }
+		inline int candidateSnapType(std::size_t i) const { return (snapType & ~ST__INTERNAL_AUTO_ALL_WITH_POLICY) | AutoSnapStats::candidates[i]; }
+		///lower bound of the grade of any point
+		GRADE_TYPE minGrade() const;
+		///grades the snapped point coordinate by coordinate, input is only used by the distance policies
+		///@param bound grade of the current best, nullptr if there is none
+		///@return false if the grade is larger than *bound or equal to it and !winsTies, result is incomplete in this case
+		bool grade(const std::vector<mpq_class> & input, const std::vector<mpq_class> & point, const GRADE_TYPE * bound, bool winsTies, GRADE_TYPE & result) const;
+	private:
+		///snaps the point with candidate i into myWs.candidate and records the time needed in stats
+		template<typename T_ITERATOR, typename T_FT>
+		void snapCandidate(const T_ITERATOR & begin, const T_ITERATOR & end, std::size_t i, SnapWorkspace<T_FT> & myWs, AutoSnapStats & stats) const;
+		///evaluates the candidates on ws.autoThreads threads with one workspace per thread
+		///@param tasks indices into AutoSnapStats::candidates ordered by their expected cost
+		///@return index of the best candidate
+		template<typename T_ITERATOR, typename T_FT>
+		std::size_t bestParallel(const T_ITERATOR & begin, const T_ITERATOR & end, const std::vector<std::size_t> & tasks, SnapWorkspace<T_FT> & ws) const;
 	};
 private:
-	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
-	void snapNormalized(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands, std::size_t dims) const;
+	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR, typename T_FT>
+	void snapNormalized(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands, std::size_t dims, SnapWorkspace<T_FT> & ws) const;
+	///snaps the normalized point and projects it onto the plane, the snapped plane coordinates are in ws.planePq
+	template<typename T_INPUT_ITERATOR, typename T_FT>
+	PositionOnSphere snapToPlane(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, int snapType, int significands, std::size_t dims, SnapWorkspace<T_FT> & ws) const;
+	///snaps the plane coordinates in ws.plane and projects them back onto the sphere
+	template<typename T_OUTPUT_ITERATOR, typename T_FT>
+	void snapPlane(PositionOnSphere pos, T_OUTPUT_ITERATOR out, int snapType, int significands, SnapWorkspace<T_FT> & ws) const;
+	///snaps the plane coordinates in ws.plane to ws.planePq
+	template<typename T_FT>
+	void snapPlaneToRational(PositionOnSphere pos, int snapType, int significands, SnapWorkspace<T_FT> & ws) const;
+	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR, typename T_FT>
+	void toRational(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands, SnapWorkspace<T_FT> & ws) const;
+	///snap() that looks up the result in cache first and adds it on a miss
+	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR, typename T_FT>
+	void snapCached(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands, SnapCache & cache, SnapWorkspace<T_FT> & ws) const;
+	///snapBatch for double points snapped in the plane, see internal::SphereToPlaneBatch
+	template<typename T_RANDOM_ACCESS_INPUT_ITERATOR, typename T_RANDOM_ACCESS_OUTPUT_ITERATOR>
+	void snapBatchPlane(T_RANDOM_ACCESS_INPUT_ITERATOR begin, std::size_t numPoints, std::size_t dims, T_RANDOM_ACCESS_OUTPUT_ITERATOR out, int snapType, int significands, const LLLConfig & lll, const internal::WorkStealingExecutor & executor) const;
+private:
+	//Variants of the functions above that store all intermediate values in tmp and write their result into existing objects.
+	//They compute exactly the same values.
+	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR, typename T_FT>
+	void normalizeInplace(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, T_FT (&tmp)[3]) const;
+	template<typename T_FT_ITERATOR, typename T_FT>
+	PositionOnSphere positionOnSphereInplace(T_FT_ITERATOR begin, const T_FT_ITERATOR & end, T_FT (&tmp)[3]) const;
+	///out has to dereference to T_FT&
+	template<typename T_FT_INPUT_ITERATOR, typename T_FT_OUTPUT_ITERATOR, typename T_FT>
+	PositionOnSphere sphere2PlaneInplace(T_FT_INPUT_ITERATOR begin, const T_FT_INPUT_ITERATOR & end, T_FT_OUTPUT_ITERATOR out, PositionOnSphere pos, T_FT (&tmp)[3]) const;
+	///only for exact number types like mpq_class
+	template<typename T_FT_INPUT_ITERATOR, typename T_FT_OUTPUT_ITERATOR, typename T_FT>
+	void plane2SphereInplace(T_FT_INPUT_ITERATOR begin, const T_FT_INPUT_ITERATOR & end, PositionOnSphere pos, T_FT_OUTPUT_ITERATOR out, T_FT (&tmp)[3]) const;
+	///plane2Sphere for the plane point num[i]/den given by integers, the result is numerators[i]/denominator
+	///With s = sum num[i]^2 this is numerators[i] = 2*num[i]*den, +-(s - den^2) for the projection coordinate and denominator = s + den^2
+	template<typename T_OUTPUT_ITERATOR>
+	void plane2SphereHomogeneous(const std::vector<mpz_class> & num, const mpz_class & den, PositionOnSphere pos, T_OUTPUT_ITERATOR numerators, mpz_class & denominator, mpz_class (&tmp)[3]) const;
 private:
 	template<typename T_FT>
 	inline T_FT add(const T_FT & a, const T_FT & b) const { return calc().add(a,b); }
@@ -167,6 +287,12 @@ void ProjectSN::plane2Sphere(T_FT_INPUT_ITERATOR begin, const T_FT_INPUT_ITERATO
 	if (pos == SP_INVALID) {
 		return;
 	}
+	if constexpr (std::is_same<FT, mpq_class>::value) {
+		mpq_class tmp;
+		if (internal::FixedWidthPlane2Sphere<>::run(begin, end, pos, out, tmp)) {
+			return;
+		}
+	}
 	FT denom(1);
 	int projCoord = abs((int) pos); //starts from 1
 	assert(projCoord <= distance(begin, end));
@@ -202,6 +328,14 @@ void ProjectSN::plane2Sphere(T_FT_INPUT_ITERATOR begin, const T_FT_INPUT_ITERATO
 template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
 void ProjectSN::snap(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands) const {
 	using input_ft = typename std::iterator_traits<T_INPUT_ITERATOR>::value_type;
+	SnapWorkspace<input_ft> ws;
+	snap(begin, end, out, snapType, significands, ws);
+}
+
+template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+void ProjectSN::snap(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands,
+	SnapWorkspace<typename std::iterator_traits<T_INPUT_ITERATOR>::value_type> & ws) const
+{
 	using std::distance;
 	std::size_t dims = distance(begin, end);
 	
@@ -243,7 +377,7 @@ void ProjectSN::snap(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITER
 					snapType, significands);
 			}
 			else {
-				calc().toRational(apx_plane.cbegin(), apx_plane.cend(), pt_snap_plane.begin(), snapType, significands);
+				calc().toRational(apx_plane.cbegin(), apx_plane.cend(), pt_snap_plane.begin(), snapType, significands, ws.lll);
 			}
 		}
 		else if (snapType & ST_FX) {
@@ -300,7 +434,7 @@ void ProjectSN::snap(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITER
 					snapType, significands);
 			}
 			else {
-				calc().toRational(apx_plane.cbegin(), apx_plane.cend(), pt_snap_plane.begin(), snapType, significands);
+				calc().toRational(apx_plane.cbegin(), apx_plane.cend(), pt_snap_plane.begin(), snapType, significands, ws.lll);
 			}
 		}
 		else if (snapType & ST_FX) {
@@ -321,90 +455,462 @@ void ProjectSN::snap(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITER
 	}
 	else {
 		if (snapType & ST_NORMALIZE) {
-			std::vector<input_ft> normalized(dims);
-			calc().normalize(begin, end, normalized.begin());
-			snap(normalized.begin(), normalized.end(), out, snapType & ~ST_NORMALIZE, significands);
+			ws.normalized.resize(dims);
+			normalizeInplace(begin, end, ws.normalized.begin(), ws.ft);
+			snap(ws.normalized.begin(), ws.normalized.end(), out, snapType & ~ST_NORMALIZE, significands, ws);
 			return;
 		}
 		if (snapType & ST_AUTO) {
-			int bestType = ST_FX;
 			if (snapType & ST_AUTO_POLICY_MIN_MAX_DENOM) {
 				StOptimizer<std::size_t, ST_AUTO_POLICY_MIN_MAX_DENOM> optimizer(this, snapType, significands, dims);
-				bestType = optimizer.best(begin, end);
+				optimizer.best(begin, end, ws);
 			}
 			else if (snapType & ST_AUTO_POLICY_MIN_SUM_DENOM) {
 				StOptimizer<std::size_t, ST_AUTO_POLICY_MIN_SUM_DENOM> optimizer(this, snapType, significands, dims);
-				bestType = optimizer.best(begin, end);
+				optimizer.best(begin, end, ws);
 			}
 			else if (snapType & ST_AUTO_POLICY_MIN_TOTAL_LIMBS) {
 				StOptimizer<std::size_t, ST_AUTO_POLICY_MIN_TOTAL_LIMBS> optimizer(this, snapType, significands, dims);
-				bestType = optimizer.best(begin, end);
+				optimizer.best(begin, end, ws);
 			}
 			else if (snapType & ST_AUTO_POLICY_MIN_MAX_NORM) {
 				StOptimizer<mpq_class, ST_AUTO_POLICY_MIN_MAX_NORM> optimizer(this, snapType, significands, dims);
-				bestType = optimizer.best(begin, end);
+				optimizer.best(begin, end, ws);
 			}
 			else if (snapType & ST_AUTO_POLICY_MIN_SQUARED_DISTANCE) {
 				StOptimizer<mpq_class, ST_AUTO_POLICY_MIN_SQUARED_DISTANCE> optimizer(this, snapType, significands, dims);
-				bestType = optimizer.best(begin, end);
+				optimizer.best(begin, end, ws);
 			}
 			else {
 				throw std::runtime_error("ratss::ProjectSN::snap: auto snapping requested, but no policy was set");
 			}
-			snapNormalized(begin, end, out, (snapType & ~ST__INTERNAL_AUTO_ALL_WITH_POLICY) | bestType, significands, dims);
+			std::move(ws.autoBest.begin(), ws.autoBest.end(), out);
 		}
 		else {
-			snapNormalized(begin, end, out, snapType, significands, dims);
+			snapNormalized(begin, end, out, snapType, significands, dims, ws);
 		}
 	}
 }
 
 template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
 void ProjectSN::snap(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, const SnapConfig & sc) const {
+	SnapWorkspace<typename std::iterator_traits<T_INPUT_ITERATOR>::value_type> ws;
+	snap(begin, end, out, sc, ws);
+}
+
+template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+void ProjectSN::snap(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, const SnapConfig & sc,
+	SnapWorkspace<typename std::iterator_traits<T_INPUT_ITERATOR>::value_type> & ws) const
+{
+	using std::distance;
+	ws.lll = sc.lll();
+	ws.autoThreads = sc.autoThreads();
+	if (sc.cache()) {
+		snapCached(begin, end, out, sc.snapType(), sc.significands(distance(begin, end)), *sc.cache(), ws);
+	}
+	else {
+		snap(begin, end, out, sc.snapType(), sc.significands(distance(begin, end)), ws);
+	}
+}
+
+template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR, typename T_FT>
+void ProjectSN::snapCached(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands, SnapCache & cache, SnapWorkspace<T_FT> & ws) const {
 	using std::distance;
-	snap(begin, end, out, sc.snapType(), sc.significands(distance(begin, end)));
+	SnapCache::makeKey(begin, end, snapType, significands, ws.cacheKey);
+	if (cache.find(ws.cacheKey, out)) {
+		return;
+	}
+	ws.cached.resize(distance(begin, end));
+	snap(begin, end, ws.cached.begin(), snapType, significands, ws);
+	cache.insert(ws.cacheKey, ws.cached);
+	std::copy(ws.cached.begin(), ws.cached.end(), out);
 }
 
-//private implementations
 template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
-void ProjectSN::snapNormalized(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands, std::size_t dims) const {
+void ProjectSN::snapHomogeneous(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR numerators, mpz_class & denominator, int snapType, int significands) const {
 	using input_ft = typename std::iterator_traits<T_INPUT_ITERATOR>::value_type;
+	SnapWorkspace<input_ft> ws;
+	snapHomogeneous(begin, end, numerators, denominator, snapType, significands, ws);
+}
+
+template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+void ProjectSN::snapHomogeneous(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR numerators, mpz_class & denominator, int snapType, int significands,
+	SnapWorkspace<typename std::iterator_traits<T_INPUT_ITERATOR>::value_type> & ws) const
+{
+	using std::distance;
+	std::size_t dims = distance(begin, end);
+	if (snapType & (ST_AUTO|ST_PAPER|ST_PAPER2)) {
+		ws.canonical.resize(dims);
+		snap(begin, end, ws.canonical.begin(), snapType, significands, ws);
+		calc().commonDenominator(ws.canonical.cbegin(), ws.canonical.cend(), numerators, denominator);
+		return;
+	}
+	if (snapType & ST_NORMALIZE) {
+		ws.normalized.resize(dims);
+		normalizeInplace(begin, end, ws.normalized.begin(), ws.ft);
+		snapHomogeneous(ws.normalized.begin(), ws.normalized.end(), numerators, denominator, snapType & ~ST_NORMALIZE, significands, ws);
+		return;
+	}
+	PositionOnSphere pos = snapToPlane(begin, end, snapType, significands, dims, ws);
+	if (pos == SP_INVALID) {
+		return;
+	}
+	ws.planeNum.resize(dims);
+	//fix point coordinates in the plane have power of two denominators, any other snap type needs their lcm
+	if ((snapType & ST_SNAP_TYPES_MASK) == ST_FX && !(snapType & ST_SPHERE)) {
+		calc().commonDenominatorPow2(ws.planePq.cbegin(), ws.planePq.cend(), ws.planeNum.begin(), ws.pz[0]);
+	}
+	else {
+		calc().commonDenominator(ws.planePq.cbegin(), ws.planePq.cend(), ws.planeNum.begin(), ws.pz[0]);
+	}
+	plane2SphereHomogeneous(ws.planeNum, ws.pz[0], pos, numerators, denominator, ws.pz);
+}
+
+template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+void ProjectSN::snapHomogeneous(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR numerators, mpz_class & denominator, const SnapConfig & sc) const {
+	SnapWorkspace<typename std::iterator_traits<T_INPUT_ITERATOR>::value_type> ws;
+	snapHomogeneous(begin, end, numerators, denominator, sc, ws);
+}
+
+template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+void ProjectSN::snapHomogeneous(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR numerators, mpz_class & denominator, const SnapConfig & sc,
+	SnapWorkspace<typename std::iterator_traits<T_INPUT_ITERATOR>::value_type> & ws) const
+{
+	using std::distance;
+	std::size_t dims = distance(begin, end);
+	ws.lll = sc.lll();
+	ws.autoThreads = sc.autoThreads();
+	if (sc.cache()) {
+		ws.canonical.resize(dims);
+		snapCached(begin, end, ws.canonical.begin(), sc.snapType(), sc.significands(dims), *sc.cache(), ws);
+		calc().commonDenominator(ws.canonical.cbegin(), ws.canonical.cend(), numerators, denominator);
+	}
+	else {
+		snapHomogeneous(begin, end, numerators, denominator, sc.snapType(), sc.significands(dims), ws);
+	}
+}
+
+template<typename T_RANDOM_ACCESS_INPUT_ITERATOR, typename T_RANDOM_ACCESS_OUTPUT_ITERATOR>
+void ProjectSN::snapBatch(T_RANDOM_ACCESS_INPUT_ITERATOR begin, T_RANDOM_ACCESS_INPUT_ITERATOR end, std::size_t dims, T_RANDOM_ACCESS_OUTPUT_ITERATOR out, const SnapConfig & sc, std::size_t threads) const {
+	using std::distance;
+	std::size_t numCoords = distance(begin, end);
+	if (!dims || numCoords % dims) {
+		throw std::invalid_argument("ratss::ProjectSN::snapBatch: number of coordinates is not a multiple of dims");
+	}
+	int snapType = sc.snapType();
+	int significands = sc.significands(dims);
+	internal::WorkStealingExecutor executor(threads);
+	std::size_t numPoints = numCoords/dims;
+	using input_ft = typename std::iterator_traits<T_RANDOM_ACCESS_INPUT_ITERATOR>::value_type;
+	if constexpr (std::is_same<input_ft, double>::value) {
+		if ((snapType & ST_PLANE) && !(snapType & (ST_SPHERE|ST_AUTO|ST_PAPER|ST_PAPER2)) && !sc.cache()) {
+			snapBatchPlane(begin, numPoints, dims, out, snapType, significands, sc.lll(), executor);
+			return;
+		}
+	}
+	//every worker gets its own projector and workspace and thereby its own calculation state
+	std::vector<ProjectSN> workers(executor.threadCount(numPoints), *this);
+	std::vector< SnapWorkspace<input_ft> > workspaces(workers.size());
+	for(auto & ws : workspaces) {
+		ws.lll = sc.lll();
+	}
+	executor.run(numPoints, [&](std::size_t workerId, std::size_t pointId) {
+		auto ptBegin = begin + pointId*dims;
+		if (sc.cache()) {
+			workers[workerId].snapCached(ptBegin, ptBegin + dims, out + pointId*dims, snapType, significands, *sc.cache(), workspaces[workerId]);
+		}
+		else {
+			workers[workerId].snap(ptBegin, ptBegin + dims, out + pointId*dims, snapType, significands, workspaces[workerId]);
+		}
+	});
+}
 
-	std::vector<mpq_class> coords_plane_pq(dims);
+template<typename T_FT>
+void ProjectSN::snapBatch(const std::vector<T_FT> & points, std::size_t dims, std::vector<mpq_class> & out, const SnapConfig & sc, std::size_t threads) const {
+	out.resize(points.size());
+	snapBatch(points.cbegin(), points.cend(), dims, out.begin(), sc, threads);
+}
+
+template<typename T_RANDOM_ACCESS_INPUT_ITERATOR, typename T_RANDOM_ACCESS_OUTPUT_ITERATOR>
+void ProjectSN::snapBatchPlane(T_RANDOM_ACCESS_INPUT_ITERATOR begin, std::size_t numPoints, std::size_t dims, T_RANDOM_ACCESS_OUTPUT_ITERATOR out, int snapType, int significands, const LLLConfig & lll, const internal::WorkStealingExecutor & executor) const {
+	constexpr std::size_t blockSize = 64;
+	struct Worker {
+		ProjectSN proj;
+		SnapWorkspace<double> ws;
+		std::vector<double> block; //structure of arrays: coordinate j of point i is at j*blockSize+i
+		std::vector<int> pos;
+	};
+	std::size_t numBlocks = (numPoints + blockSize - 1)/blockSize;
+	std::vector<Worker> workers(executor.threadCount(numBlocks), Worker{*this, SnapWorkspace<double>(dims), {}, {}});
+	for(Worker & w : workers) {
+		w.ws.lll = lll;
+	}
+	executor.run(numBlocks, [&](std::size_t workerId, std::size_t blockId) {
+		Worker & w = workers[workerId];
+		std::size_t first = blockId*blockSize;
+		std::size_t count = std::min(blockSize, numPoints - first);
+		w.block.resize(dims*blockSize);
+		w.pos.resize(blockSize);
+		for(std::size_t i(0); i < count; ++i) {
+			auto ptBegin = begin + (first+i)*dims;
+			if (snapType & ST_NORMALIZE) {
+				w.proj.normalizeInplace(ptBegin, ptBegin+dims, w.ws.normalized.begin(), w.ws.ft);
+				ptBegin = w.ws.normalized.begin();
+			}
+			for(std::size_t j(0); j < dims; ++j, ++ptBegin) {
+				w.block[j*blockSize+i] = *ptBegin;
+			}
+		}
+		internal::SphereToPlaneBatch::run(w.block.data(), dims, count, blockSize, w.block.data(), w.pos.data());
+		for(std::size_t i(0); i < count; ++i) {
+			for(std::size_t j(0); j < dims; ++j) {
+				w.ws.plane[j] = w.block[j*blockSize+i];
+			}
+			w.proj.snapPlane(PositionOnSphere(w.pos[i]), out + (first+i)*dims, snapType & ~ST_NORMALIZE, significands, w.ws);
+		}
+	});
+}
+
+//private implementations
+template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR, typename T_FT>
+void ProjectSN::snapNormalized(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands, std::size_t dims, SnapWorkspace<T_FT> & ws) const {
+	PositionOnSphere pos = snapToPlane(begin, end, snapType, significands, dims, ws);
+	plane2SphereInplace(ws.planePq.cbegin(), ws.planePq.cend(), pos, out, ws.pq);
+}
+
+template<typename T_INPUT_ITERATOR, typename T_FT>
+PositionOnSphere ProjectSN::snapToPlane(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, int snapType, int significands, std::size_t dims, SnapWorkspace<T_FT> & ws) const {
+	std::vector<mpq_class> & coords_plane_pq = ws.planePq;
+	coords_plane_pq.resize(dims);
 	PositionOnSphere pos;
 	if (snapType & ST_SPHERE) {
-		std::vector<mpq_class> coords_sphere_pq(dims);
-		calc().toRational(begin, end, coords_sphere_pq.begin(), snapType, significands);
-		pos = sphere2Plane(coords_sphere_pq.begin(), coords_sphere_pq.end(), coords_plane_pq.begin());
+		std::vector<mpq_class> & coords_sphere_pq = ws.spherePq;
+		coords_sphere_pq.resize(dims);
+		toRational(begin, end, coords_sphere_pq.begin(), snapType, significands, ws);
+		pos = sphere2PlaneInplace(coords_sphere_pq.begin(), coords_sphere_pq.end(), coords_plane_pq.begin(), SP_INVALID, ws.pq);
 	}
 	else if (snapType & ST_PLANE) {
-		std::vector<input_ft> coords_plane(dims);
-		pos = sphere2Plane(begin, end, coords_plane.begin());
-		//this fixes the eps guarantee at the cost of 2 more bits. This is independent of the number of bits
-		//The question remains: why?
-// 		if (significands > 0 && snapType & (ST_CF|ST_FX)) {
-// 			significands += 2;
-// 		}
-		if (snapType & ST_JP) {
-			int skipDim = std::abs(pos);
-			using SkipInputIterator = internal::SkipIterator<typename std::vector<input_ft>::const_iterator>;
-			using SkipOutputIterator = internal::SkipIterator<std::vector<mpq_class>::iterator>;
-			calc().toRational(
-				SkipInputIterator(coords_plane.cbegin(), skipDim),
-				SkipInputIterator(coords_plane.cend(), 0),
-				SkipOutputIterator(coords_plane_pq.begin(), skipDim),
-				snapType, significands);
+		ws.plane.resize(dims);
+		pos = sphere2PlaneInplace(begin, end, ws.plane.begin(), SP_INVALID, ws.ft);
+		snapPlaneToRational(pos, snapType, significands, ws);
+	}
+	else {
+		throw std::runtime_error("ratss::ProjectSN::snapNormalized: Unsupported snap type: " + std::to_string(snapType));
+	}
+	return pos;
+}
+
+template<typename T_OUTPUT_ITERATOR, typename T_FT>
+void ProjectSN::snapPlane(PositionOnSphere pos, T_OUTPUT_ITERATOR out, int snapType, int significands, SnapWorkspace<T_FT> & ws) const {
+	snapPlaneToRational(pos, snapType, significands, ws);
+	plane2SphereInplace(ws.planePq.cbegin(), ws.planePq.cend(), pos, out, ws.pq);
+}
+
+template<typename T_FT>
+void ProjectSN::snapPlaneToRational(PositionOnSphere pos, int snapType, int significands, SnapWorkspace<T_FT> & ws) const {
+	const std::vector<T_FT> & coords_plane = ws.plane;
+	std::vector<mpq_class> & coords_plane_pq = ws.planePq;
+	coords_plane_pq.resize(coords_plane.size());
+	//this fixes the eps guarantee at the cost of 2 more bits. This is independent of the number of bits
+	//The question remains: why?
+// 	if (significands > 0 && snapType & (ST_CF|ST_FX)) {
+// 		significands += 2;
+// 	}
+	if (snapType & ST_JP) {
+		int skipDim = std::abs(pos);
+		using SkipInputIterator = internal::SkipIterator<typename std::vector<T_FT>::const_iterator>;
+		using SkipOutputIterator = internal::SkipIterator<std::vector<mpq_class>::iterator>;
+		calc().toRational(
+			SkipInputIterator(coords_plane.cbegin(), skipDim),
+			SkipInputIterator(coords_plane.cend(), 0),
+			SkipOutputIterator(coords_plane_pq.begin(), skipDim),
+			snapType, significands);
+		//the projection coordinate is skipped, but it may still hold a value of a previous point
+		coords_plane_pq[skipDim-1] = 0;
+	}
+	else {
+		toRational(coords_plane.cbegin(), coords_plane.cend(), coords_plane_pq.begin(), snapType, significands, ws);
+	}
+}
+
+template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR, typename T_FT>
+void ProjectSN::toRational(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands, SnapWorkspace<T_FT> & ws) const {
+	using input_ft = typename std::iterator_traits<T_INPUT_ITERATOR>::value_type;
+	if constexpr (std::is_same<input_ft, mpfr::mpreal>::value || std::is_same<input_ft, double>::value) {
+		if (!(snapType & (ST_JP|ST_FPLLL_MASK|ST_BRUTE_FORCE))) {
+			for(; begin != end; ++begin, ++out) {
+				calc().snap(*out, *begin, snapType, significands, ws.calc);
+			}
+			return;
 		}
-		else {
-			calc().toRational(coords_plane.cbegin(), coords_plane.cend(), coords_plane_pq.begin(), snapType, significands);
+	}
+	calc().toRational(begin, end, out, snapType, significands, ws.lll);
+}
+
+template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR, typename T_FT>
+void ProjectSN::normalizeInplace(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, T_FT (&tmp)[3]) const {
+	T_FT & len = tmp[0];
+	internal::mul(len, *begin, *begin);
+	for(T_INPUT_ITERATOR it(std::next(begin)); it != end; ++it) {
+		internal::mul(tmp[1], *it, *it);
+		internal::add(len, tmp[1], len);
+	}
+	internal::sqrt(len, len);
+	for(; begin != end; ++begin, ++out) {
+		internal::div(*out, *begin, len);
+	}
+}
+
+template<typename T_FT_ITERATOR, typename T_FT>
+PositionOnSphere ProjectSN::positionOnSphereInplace(T_FT_ITERATOR begin, const T_FT_ITERATOR & end, T_FT (&tmp)[3]) const {
+	if (begin == end) {
+		return SP_INVALID;
+	}
+	int posIndex = -1;
+	int posSign = 0;
+	T_FT & v = tmp[0];
+	internal::setInt(v, 0);
+	for(int p(1); begin != end; ++begin, ++p) {
+		if (*begin > v) { //base vector (0...,1,...0)
+			posIndex = p;
+			posSign = 1;
+			internal::assign(v, *begin);
+			continue;
+		}
+		internal::neg(tmp[1], *begin);
+		if (tmp[1] > v) { //base vector (0...,-1,...0)
+			posIndex = p;
+			posSign = -1;
+			internal::assign(v, tmp[1]);
 		}
 	}
+	assert(posIndex > 0 && posSign != 0);
+	return (PositionOnSphere) (posIndex*posSign);
+}
+
+template<typename T_FT_INPUT_ITERATOR, typename T_FT_OUTPUT_ITERATOR, typename T_FT>
+PositionOnSphere ProjectSN::sphere2PlaneInplace(T_FT_INPUT_ITERATOR begin, const T_FT_INPUT_ITERATOR & end, T_FT_OUTPUT_ITERATOR out, PositionOnSphere pos, T_FT (&tmp)[3]) const {
+	if (begin == end) {
+		return SP_INVALID;
+	}
+	if (pos == SP_INVALID) {
+		pos = positionOnSphereInplace(begin, end, tmp);
+	}
+	int projCoord = abs((int) pos); //starts from 1
+	T_FT & one = tmp[0];
+	T_FT & denom = tmp[1];
+	internal::setInt(one, 1);
+	if (pos < 0) {
+		internal::sub(denom, one, *std::next(begin, projCoord-1));
+	}
 	else {
-		throw std::runtime_error("ratss::ProjectSN::snapNormalized: Unsupported snap type: " + std::to_string(snapType));
+		internal::add(denom, one, *std::next(begin, projCoord-1));
+	}
+	
+	T_FT_INPUT_ITERATOR it(begin);
+	for(int i(1); i < projCoord; ++i, ++it, ++out) {
+		internal::div(*out, *it, denom);
 	}
-	plane2Sphere(coords_plane_pq.begin(), coords_plane_pq.end(), pos, out);
+	//the projection coordinate, see above for the precision of *out
+	T_FT & zero = tmp[0];
+	internal::setInt(zero, 0);
+	internal::div(*out, zero, denom);
+	++out;
+	++it;
+	for( ; it != end; ++it, ++out) {
+		internal::div(*out, *it, denom);
+	}
+	
+	return pos;
 }
 
+template<typename T_FT_INPUT_ITERATOR, typename T_FT_OUTPUT_ITERATOR, typename T_FT>
+void ProjectSN::plane2SphereInplace(T_FT_INPUT_ITERATOR begin, const T_FT_INPUT_ITERATOR & end, PositionOnSphere pos, T_FT_OUTPUT_ITERATOR out, T_FT (&tmp)[3]) const {
+	using std::distance;
+	if (pos == SP_INVALID) {
+		return;
+	}
+	if constexpr (std::is_same<T_FT, mpq_class>::value) {
+		if (internal::FixedWidthPlane2Sphere<>::run(begin, end, pos, out, tmp[0])) {
+			return;
+		}
+	}
+	T_FT & denom = tmp[0];
+	T_FT & value = tmp[1];
+	internal::setInt(denom, 1);
+	int projCoord = abs((int) pos); //starts from 1
+	assert(projCoord <= distance(begin, end));
+	{
+		T_FT_INPUT_ITERATOR it(begin);
+		for(int i(1); i < projCoord; ++i, ++it) {
+			internal::mul(value, *it, *it);
+			internal::add(denom, denom, value);
+		}
+		//now comes the projection coordinate, skip it
+		++it;
+		//and the rest
+		for( ; it != end; ++it) {
+			internal::mul(value, *it, *it);
+			internal::add(denom, denom, value);
+		}
+	}
+	{
+		T_FT_INPUT_ITERATOR it(begin);
+		for(int i(1); i < projCoord; ++i, ++it, ++out) {
+			internal::add(value, *it, *it);
+			internal::div(value, value, denom);
+			*out = value;
+		}
+		//and the projection coordinate
+		internal::setInt(tmp[2], 2);
+		internal::sub(value, denom, tmp[2]);
+		internal::div(value, value, denom);
+		if (!std::signbit<int>(pos)) {
+			internal::neg(value, value);
+		}
+		*out = value;
+		++out;
+		assert(*it == 0);
+		++it;
+		//and the rest
+		for( ; it != end; ++it, ++out) {
+			internal::add(value, *it, *it);
+			internal::div(value, value, denom);
+			*out = value;
+		}
+	}
+}
+
+template<typename T_OUTPUT_ITERATOR>
+void ProjectSN::plane2SphereHomogeneous(const std::vector<mpz_class> & num, const mpz_class & den, PositionOnSphere pos, T_OUTPUT_ITERATOR numerators, mpz_class & denominator, mpz_class (&tmp)[3]) const {
+	if (pos == SP_INVALID) {
+		return;
+	}
+	std::size_t projCoord = abs((int) pos)-1;
+	assert(projCoord < num.size() && num[projCoord] == 0);
+	mpz_class & sqLen = tmp[1];
+	mpz_class & twiceDen = tmp[2];
+	sqLen = 0;
+	for(const mpz_class & v : num) {
+		mpz_addmul(sqLen.get_mpz_t(), v.get_mpz_t(), v.get_mpz_t());
+	}
+	//den may alias tmp[0], so compute everything depending on it first
+	mpz_mul_2exp(twiceDen.get_mpz_t(), den.get_mpz_t(), 1);
+	mpz_mul(denominator.get_mpz_t(), den.get_mpz_t(), den.get_mpz_t());
+	for(std::size_t i(0), s(num.size()); i < s; ++i, ++numerators) {
+		mpz_class & v = *numerators;
+		if (i == projCoord) {
+			mpz_sub(v.get_mpz_t(), sqLen.get_mpz_t(), denominator.get_mpz_t());
+			if (!std::signbit<int>(pos)) {
+				mpz_neg(v.get_mpz_t(), v.get_mpz_t());
+			}
+		}
+		else {
+			mpz_mul(v.get_mpz_t(), num[i].get_mpz_t(), twiceDen.get_mpz_t());
+		}
+	}
+	mpz_add(denominator.get_mpz_t(), denominator.get_mpz_t(), sqLen.get_mpz_t());
+}
 
 template<typename GRADE_TYPE, int POLICY>
 ProjectSN::StOptimizer<GRADE_TYPE, POLICY>::StOptimizer(const ProjectSN * _parent, int _snapType, int _significands, std::size_t _dims) :
@@ -415,69 +921,235 @@ dims(_dims)
 {}
 
 template<typename GRADE_TYPE, int POLICY>
-template<typename T_ITERATOR>
+template<typename T_ITERATOR, typename T_FT>
 int
-ProjectSN::StOptimizer<GRADE_TYPE, POLICY>::best(const T_ITERATOR & begin, const T_ITERATOR & end) const {
-	std::array snappingType{
-		ST_FL, ST_FX,
-		ST_CF_GUARANTEE_DISTANCE, ST_CF_GUARANTEE_SIZE,
-		ST_JP_GUARANTEE_DISTANCE, ST_JP_GUARANTEE_SIZE,
-		ST_FPLLL_GUARANTEE_DISTANCE, ST_FPLLL_GUARANTEE_SIZE
-	};
-	std::vector<mpq_class> tmp(dims);
-	GRADE_TYPE bestGrade = GRADE_TYPE(std::numeric_limits<std::size_t>::max());
-	int bestType = ST_FX;
-	for(int st : snappingType) {
-		if ((st << ST__INTERNAL_NUMBER_OF_SNAPPING_TYPES) & snapType) {
-			parent->snapNormalized(begin, end, tmp.begin(), (snapType & ~ST__INTERNAL_AUTO_ALL_WITH_POLICY) | st, significands, dims);
-			GRADE_TYPE myGrade = grade(begin, end, tmp.begin(), tmp.end());
-			if (bestGrade > myGrade) {
-				bestGrade = myGrade;
-				bestType = st;
+ProjectSN::StOptimizer<GRADE_TYPE, POLICY>::best(const T_ITERATOR & begin, const T_ITERATOR & end, SnapWorkspace<T_FT> & ws) const {
+	using value_type = typename std::iterator_traits<T_ITERATOR>::value_type;
+	AutoSnapStats & stats = ws.autoStats;
+	ws.candidate.resize(dims);
+	ws.autoBest.resize(dims);
+	if constexpr (std::is_same<GRADE_TYPE, mpq_class>::value) {
+		//the distance policies compare every candidate with the input, convert it only once
+		ws.inputPq.resize(dims);
+		std::transform(begin, end, ws.inputPq.begin(), [](const value_type & v) { return Conversion<value_type>::toMpq(v); });
+	}
+	//cheap candidates first, they give a bound for the expensive ones. Candidates that were never used have cost 0 and are measured first.
+	std::array<std::size_t, AutoSnapStats::candidates.size()> order;
+	std::size_t numEnabled = 0;
+	for(std::size_t i(0); i < AutoSnapStats::candidates.size(); ++i) {
+		if (enabled(i)) {
+			order[numEnabled] = i;
+			++numEnabled;
+		}
+	}
+	std::stable_sort(order.begin(), order.begin()+numEnabled, [&stats](std::size_t a, std::size_t b) {
+		return stats.expectedCost(a) < stats.expectedCost(b);
+	});
+	std::size_t bestIndex = AutoSnapStats::candidates.size();
+	if (ws.autoThreads != 1 && numEnabled > 1) {
+		bestIndex = bestParallel(begin, end, std::vector<std::size_t>(order.begin(), order.begin()+numEnabled), ws);
+	}
+	else {
+		const GRADE_TYPE lb = minGrade();
+		GRADE_TYPE bestGrade = lb;
+		GRADE_TYPE myGrade = lb;
+		for(std::size_t k(0); k < numEnabled; ++k) {
+			std::size_t i = order[k];
+			bool found = bestIndex < AutoSnapStats::candidates.size();
+			//no candidate has a grade below lb, so the current best wins if it reached lb and ties go to it
+			if (found && bestGrade == lb && bestIndex < i) {
+				++stats.skipped;
+				continue;
 			}
+			snapCandidate(begin, end, i, ws, stats);
+			if (!grade(ws.inputPq, ws.candidate, found ? &bestGrade : nullptr, i < bestIndex, myGrade)) {
+				++stats.aborted;
+				continue;
+			}
+			++stats.graded;
+			std::swap(bestGrade, myGrade);
+			ws.candidate.swap(ws.autoBest);
+			bestIndex = i;
 		}
 	}
-	return bestType;
+	if (bestIndex == AutoSnapStats::candidates.size()) {
+		parent->snapNormalized(begin, end, ws.autoBest.begin(), (snapType & ~ST__INTERNAL_AUTO_ALL_WITH_POLICY) | ST_FX, significands, dims, ws);
+		return ST_FX;
+	}
+	++stats.winCount.at(AutoSnapStats::policyIndex(POLICY)).at(bestIndex);
+	return AutoSnapStats::candidates[bestIndex];
 }
 
-template<>
-template<typename T_ITERATOR_INPUT, typename T_ITERATOR_OUTPUT>
+template<typename GRADE_TYPE, int POLICY>
+template<typename T_ITERATOR, typename T_FT>
+void
+ProjectSN::StOptimizer<GRADE_TYPE, POLICY>::snapCandidate(const T_ITERATOR & begin, const T_ITERATOR & end, std::size_t i, SnapWorkspace<T_FT> & myWs, AutoSnapStats & stats) const {
+	auto start = std::chrono::steady_clock::now();
+	parent->snapNormalized(begin, end, myWs.candidate.begin(), candidateSnapType(i), significands, dims, myWs);
+	stats.snapNs[i] += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	++stats.snapCount[i];
+}
+
+template<typename GRADE_TYPE, int POLICY>
+template<typename T_ITERATOR, typename T_FT>
 std::size_t
+ProjectSN::StOptimizer<GRADE_TYPE, POLICY>::bestParallel(const T_ITERATOR & begin, const T_ITERATOR & end, const std::vector<std::size_t> & tasks, SnapWorkspace<T_FT> & ws) const {
+	internal::WorkStealingExecutor executor(ws.autoThreads);
+	ws.autoWorkers.resize(executor.threadCount(tasks.size()));
+	for(SnapWorkspace<T_FT> & myWs : ws.autoWorkers) {
+		myWs.lll = ws.lll;
+		myWs.candidate.resize(dims);
+		myWs.autoStats.reset();
+	}
+	const GRADE_TYPE lb = minGrade();
+	std::mutex bestLock;
+	GRADE_TYPE bestGrade = lb;
+	std::size_t bestIndex = AutoSnapStats::candidates.size();
+	executor.run(tasks.size(), [&](std::size_t workerId, std::size_t taskId) {
+		SnapWorkspace<T_FT> & myWs = ws.autoWorkers[workerId];
+		AutoSnapStats & myStats = myWs.autoStats;
+		std::size_t i = tasks[taskId];
+		GRADE_TYPE bound{};
+		bool found;
+		{
+			std::lock_guard<std::mutex> lck(bestLock);
+			found = bestIndex < AutoSnapStats::candidates.size();
+			if (found && bestGrade == lb && bestIndex < i) {
+				++myStats.skipped;
+				return;
+			}
+			if (found) {
+				bound = bestGrade;
+			}
+		}
+		snapCandidate(begin, end, i, myWs, myStats);
+		GRADE_TYPE myGrade{};
+		//the bound of another thread may only get smaller, so aborting against the copy is sound
+		if (!grade(ws.inputPq, myWs.candidate, found ? &bound : nullptr, true, myGrade)) {
+			++myStats.aborted;
+			return;
+		}
+		++myStats.graded;
+		std::lock_guard<std::mutex> lck(bestLock);
+		if (bestIndex == AutoSnapStats::candidates.size() || myGrade < bestGrade || (myGrade == bestGrade && i < bestIndex)) {
+			std::swap(bestGrade, myGrade);
+			myWs.candidate.swap(ws.autoBest);
+			bestIndex = i;
+		}
+	});
+	for(const SnapWorkspace<T_FT> & myWs : ws.autoWorkers) {
+		ws.autoStats += myWs.autoStats;
+	}
+	return bestIndex;
+}
+
+template<>
+inline std::size_t
+ProjectSN::StOptimizer<std::size_t, ProjectSN::SnapType::ST_AUTO_POLICY_MIN_SUM_DENOM>::minGrade() const {
+	return dims; //every denominator has at least 1 bit
+}
+
+template<>
+inline bool
 ProjectSN::StOptimizer<std::size_t, ProjectSN::SnapType::ST_AUTO_POLICY_MIN_SUM_DENOM>::
-grade(const T_ITERATOR_INPUT & /*input_begin*/, const T_ITERATOR_INPUT & /*input_end*/, const T_ITERATOR_OUTPUT & output_begin, const T_ITERATOR_OUTPUT & output_end) const {
-	return parent->calc().summedDenomSize(output_begin, output_end);
+grade(const std::vector<mpq_class> & /*input*/, const std::vector<mpq_class> & point, const std::size_t * bound, bool winsTies, std::size_t & result) const {
+	result = 0;
+	for(const mpq_class & v : point) {
+		result += mpz_sizeinbase(v.get_den_mpz_t(), 2);
+		if (bound && (result > *bound || (result == *bound && !winsTies))) {
+			return false;
+		}
+	}
+	return true;
 }
 
 template<>
-template<typename T_ITERATOR_INPUT, typename T_ITERATOR_OUTPUT>
-std::size_t
+inline std::size_t
+ProjectSN::StOptimizer<std::size_t, ProjectSN::SnapType::ST_AUTO_POLICY_MIN_TOTAL_LIMBS>::minGrade() const {
+	return 2*dims; //numerator and denominator have at least one limb each
+}
+
+template<>
+inline bool
 ProjectSN::StOptimizer<std::size_t, ProjectSN::SnapType::ST_AUTO_POLICY_MIN_TOTAL_LIMBS>::
-grade(const T_ITERATOR_INPUT & /*input_begin*/, const T_ITERATOR_INPUT & /*input_end*/, const T_ITERATOR_OUTPUT & output_begin, const T_ITERATOR_OUTPUT & output_end) const {
-	return parent->calc().limbCount(output_begin, output_end);
+grade(const std::vector<mpq_class> & /*input*/, const std::vector<mpq_class> & point, const std::size_t * bound, bool winsTies, std::size_t & result) const {
+	result = 0;
+	for(const mpq_class & v : point) {
+		result += __GMPXX_BITS_TO_LIMBS(mpz_sizeinbase(v.get_num_mpz_t(), 2));
+		result += __GMPXX_BITS_TO_LIMBS(mpz_sizeinbase(v.get_den_mpz_t(), 2));
+		if (bound && (result > *bound || (result == *bound && !winsTies))) {
+			return false;
+		}
+	}
+	return true;
 }
 
 template<>
-template<typename T_ITERATOR_INPUT, typename T_ITERATOR_OUTPUT>
-std::size_t
+inline std::size_t
+ProjectSN::StOptimizer<std::size_t, ProjectSN::SnapType::ST_AUTO_POLICY_MIN_MAX_DENOM>::minGrade() const {
+	return dims ? 1 : 0;
+}
+
+template<>
+inline bool
 ProjectSN::StOptimizer<std::size_t, ProjectSN::SnapType::ST_AUTO_POLICY_MIN_MAX_DENOM>::
-grade(const T_ITERATOR_INPUT & /*input_begin*/, const T_ITERATOR_INPUT & /*input_end*/, const T_ITERATOR_OUTPUT & output_begin, const T_ITERATOR_OUTPUT & output_end) const {
-	return parent->calc().maxDenom(output_begin, output_end);
+grade(const std::vector<mpq_class> & /*input*/, const std::vector<mpq_class> & point, const std::size_t * bound, bool winsTies, std::size_t & result) const {
+	result = 0;
+	for(const mpq_class & v : point) {
+		result = std::max<std::size_t>(result, mpz_sizeinbase(v.get_den_mpz_t(), 2));
+		if (bound && (result > *bound || (result == *bound && !winsTies))) {
+			return false;
+		}
+	}
+	return true;
 }
 
 template<>
-template<typename T_ITERATOR_INPUT, typename T_ITERATOR_OUTPUT>
-mpq_class
+inline mpq_class
+ProjectSN::StOptimizer<mpq_class, ProjectSN::SnapType::ST_AUTO_POLICY_MIN_SQUARED_DISTANCE>::minGrade() const {
+	return mpq_class(0);
+}
+
+template<>
+inline bool
 ProjectSN::StOptimizer<mpq_class, ProjectSN::SnapType::ST_AUTO_POLICY_MIN_SQUARED_DISTANCE>::
-grade(const T_ITERATOR_INPUT & input_begin, const T_ITERATOR_INPUT & input_end, const T_ITERATOR_OUTPUT & output_begin, const T_ITERATOR_OUTPUT & /*output_end*/) const {
-	return parent->calc().squaredDistance(input_begin, input_end, output_begin);
+grade(const std::vector<mpq_class> & input, const std::vector<mpq_class> & point, const mpq_class * bound, bool winsTies, mpq_class & result) const {
+	mpq_class tmp;
+	result = 0;
+	for(std::size_t i(0); i < dims; ++i) {
+		tmp = input[i] - point[i];
+		result += tmp*tmp;
+		int c = bound ? cmp(result, *bound) : -1;
+		if (c > 0 || (c == 0 && !winsTies)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template<>
+inline mpq_class
+ProjectSN::StOptimizer<mpq_class, ProjectSN::SnapType::ST_AUTO_POLICY_MIN_MAX_NORM>::minGrade() const {
+	return mpq_class(0);
 }
 
 template<>
-template<typename T_ITERATOR_INPUT, typename T_ITERATOR_OUTPUT>
-mpq_class
+inline bool
 ProjectSN::StOptimizer<mpq_class, ProjectSN::SnapType::ST_AUTO_POLICY_MIN_MAX_NORM>::
-grade(const T_ITERATOR_INPUT & input_begin, const T_ITERATOR_INPUT & input_end, const T_ITERATOR_OUTPUT & output_begin, const T_ITERATOR_OUTPUT & /*output_end*/) const {
-	return parent->calc().maxNorm(input_begin, input_end, output_begin);
+grade(const std::vector<mpq_class> & input, const std::vector<mpq_class> & point, const mpq_class * bound, bool winsTies, mpq_class & result) const {
+	mpq_class tmp;
+	result = 0;
+	for(std::size_t i(0); i < dims; ++i) {
+		tmp = abs(input[i] - point[i]);
+		if (tmp > result) {
+			result.swap(tmp);
+		}
+		int c = bound ? cmp(result, *bound) : -1;
+		if (c > 0 || (c == 0 && !winsTies)) {
+			return false;
+		}
+	}
+	return true;
 }
 
 } //end namespace LIB_RATSS_NAMESPACE
@@ -4,9 +4,16 @@
 
 #include <libratss/constants.h>
 #include <libratss/Conversion.h>
+#include <libratss/internal/WorkStealingExecutor.h>
 
-#include <array>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
 #include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
 
 namespace LIB_RATSS_NAMESPACE {
 	
@@ -14,34 +21,73 @@ namespace LIB_RATSS_NAMESPACE {
 #define CLS_TMPL_DECL template<typename T_INTEGER_BASE, std::size_t T_DIMENSIONS>
 #define CLS_TMPL_NAME SimApxBruteForce<T_INTEGER_BASE, T_DIMENSIONS>
 	
+///Brute force simultaneous approximation with machine integers.
+///Computes the same result as SimApxBruteForce<mpq_class, D>:
+///the largest denominator den in [2, max_den] that minimizes the maximal distance between the inputs and their closest fraction with denominator den.
+///The inputs are scaled to integers with their common denominator D, for every candidate den only the remainders of input*den modulo D are needed.
+///Remainders of consecutive denominators differ by a constant, hence they are updated with a subtraction instead of a division.
+///lanes candidates are processed at once in plain loops which the compiler vectorizes.
+///The search stops as soon as no smaller denominator can be better.
+///The range of denominators is split into tasks of task_size denominators which are processed by threadCount() threads.
+///T_INTEGER_BASE has to be a signed integer type, D*max_den has to fit into it.
 CLS_TMPL_DECL
 class SimApxBruteForce {
 public:
-	static constexpr std::size_t dimensions = T_DIMENSIONS;
 	static constexpr int default_number_of_significands = 31;
+	static constexpr std::size_t lanes = 8;
+	static constexpr std::size_t task_size = std::size_t(1) << 16;
 	
 	using integer_base = T_INTEGER_BASE;
-	using numerators_const_iterator = typename std::array<integer_base, dimensions>::const_iterator;
+	using uinteger_base = typename std::make_unsigned<integer_base>::type;
+	using numerators_const_iterator = typename std::vector<mpz_class>::const_iterator;
 	
 public:
+	///@throw std::overflow_error if the common denominator of the input does not fit into integer_base
 	template<typename T_ITERATOR>
 	SimApxBruteForce(T_ITERATOR begin, T_ITERATOR end);
 	virtual  ~SimApxBruteForce() {}
+public:
+	///@param threadCount 0 selects std::thread::hardware_concurrency()
+	inline void setThreadCount(std::size_t threadCount) { m_threadCount = threadCount; }
+	inline std::size_t threadCount() const { return m_threadCount; }
+	///@return true if run(max_den) does not overflow
+	bool fits(std::size_t max_den) const;
 public:
 	void run(int significands);
+	///@throw std::overflow_error if !fits(max_den)
+	void run(std::size_t max_den);
 public:
-	inline integer_base const & denominator() const { return m_den; }
+	inline std::size_t dimensions() const { return m_dims; }
+	inline mpz_class const & denominator() const { return m_den; }
 	inline numerators_const_iterator numerators_begin() { return m_num.begin(); }
 	inline numerators_const_iterator numerators_end() { return m_num.end(); }
+private:
+	///best candidate in [lo, hi], den == 0 if there is none
+	///dist is the maximal scaled distance, the distance is dist/(D*den)
+	struct Candidate {
+		uinteger_base dist{0};
+		uinteger_base den{0};
+		///strictly better, ties are broken by the larger denominator
+		inline bool better(const Candidate & other) const {
+			return !other.den || dist*other.den < other.dist*den || (dist*other.den == other.dist*den && den > other.den);
+		}
+	};
+private:
+	///candidates den <= limit can not be better, limit is raised by every improvement
+	Candidate search(uinteger_base hi, uinteger_base lo, std::atomic<uinteger_base> & limit) const;
+	static void raise(std::atomic<uinteger_base> & limit, uinteger_base value);
 protected:
-	std::array<integer_base, dimensions> m_sign;
-	std::array<integer_base, dimensions> m_inum;
-	std::array<integer_base, dimensions> m_iden;
-	std::array<integer_base, dimensions> m_num;
-	integer_base m_den;
+	std::vector<bool> m_sign;
+	std::vector<mpq_class> m_input;
+	///input modulo 1 scaled with m_iden
+	std::vector<uinteger_base> m_inum;
+	uinteger_base m_iden;
+	std::vector<mpz_class> m_num;
+	mpz_class m_den;
+	std::size_t m_dims;
+	std::size_t m_threadCount{1};
 };
 
-
 template<std::size_t T_DIMENSIONS>
 class SimApxBruteForce<mpq_class, T_DIMENSIONS> {
 public:
@@ -105,28 +151,167 @@ namespace LIB_RATSS_NAMESPACE {
 CLS_TMPL_DECL
 template<typename T_ITERATOR>
 CLS_TMPL_NAME::SimApxBruteForce(T_ITERATOR begin, T_ITERATOR end) {
-	for(auto it(begin); it != end; ++it) {
-		mpq_class tmp = convert<mpq_class>(*it);
+	static_assert(std::is_signed<integer_base>::value, "SimApxBruteForce needs a signed machine integer");
+	mpz_class iden(1);
+	for(; begin != end; ++begin) {
+		m_input.push_back( convert<mpq_class>(*begin) );
+		m_sign.push_back(m_input.back() < 0);
+		if (m_sign.back()) {
+			m_input.back() *= -1;
+		}
+		mpz_lcm(iden.get_mpz_t(), iden.get_mpz_t(), m_input.back().get_den_mpz_t());
+	}
+	m_dims = m_sign.size();
+	if (T_DIMENSIONS && m_dims != T_DIMENSIONS) {
+		throw std::invalid_argument("ratss::SimApxBruteForce::SimApxBruteForce: wrong number of dimensions");
+	}
+	if (mpz_sizeinbase(iden.get_mpz_t(), 2) > std::size_t(std::numeric_limits<integer_base>::digits)) {
+		throw std::overflow_error("ratss::SimApxBruteForce::SimApxBruteForce: common denominator is too large");
+	}
+	m_iden = uinteger_base(mpz_get_ui(iden.get_mpz_t()));
+	mpz_class tmp;
+	for(const mpq_class & v : m_input) {
+		//(num/den) * iden mod iden = (num * (iden/den)) mod iden
+		mpz_divexact(tmp.get_mpz_t(), iden.get_mpz_t(), v.get_den_mpz_t());
+		tmp *= v.get_num();
+		mpz_fdiv_r(tmp.get_mpz_t(), tmp.get_mpz_t(), iden.get_mpz_t());
+		m_inum.push_back(uinteger_base(mpz_get_ui(tmp.get_mpz_t())));
 	}
 }
 
 CLS_TMPL_DECL
-void SimApxBruteForce<T_INTEGER_BASE, T_DIMENSIONS>::run(int significands) {
-	integer_base max_den = integer_base(1) << significands;
-	std::array<integer_base, dimensions> num_f;
-	std::array<integer_base, dimensions> num_c;
-	
-	for(integer_base den(2); den < max_den; ++den) {
-		for(std::size_t i(0); i < dimensions; ++i) {
-			integer_base num_f[i] = (m_inum[i]*den)/m_iden[i];
-			integer_base num_c[i] = num_f[i]+1;
+bool CLS_TMPL_NAME::fits(std::size_t max_den) const {
+	return uinteger_base(std::max<std::size_t>(max_den, 2)) <= uinteger_base(std::numeric_limits<integer_base>::max()) / m_iden;
+}
+
+CLS_TMPL_DECL
+void CLS_TMPL_NAME::run(int significands) {
+	std::size_t max_den = std::size_t(1) << significands;
+	run(max_den);
+}
+
+CLS_TMPL_DECL
+void CLS_TMPL_NAME::raise(std::atomic<uinteger_base> & limit, uinteger_base value) {
+	uinteger_base cur = limit.load(std::memory_order_relaxed);
+	while (cur < value && !limit.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {}
+}
+
+CLS_TMPL_DECL
+typename CLS_TMPL_NAME::Candidate
+CLS_TMPL_NAME::search(uinteger_base hi, uinteger_base lo, std::atomic<uinteger_base> & limit) const {
+	const uinteger_base D = m_iden;
+	const std::size_t dims = m_dims;
+	Candidate best;
+	if (hi <= limit.load(std::memory_order_relaxed)) {
+		return best;
+	}
+	//rem[j*lanes+k] = (m_inum[j]*(hi-k)) mod D
+	std::vector<uinteger_base> rem(dims*lanes);
+	std::vector<uinteger_base> step(dims);
+	for(std::size_t j(0); j < dims; ++j) {
+		step[j] = (uinteger_base(lanes)*m_inum[j]) % D;
+		for(std::size_t k(0); k < lanes; ++k) {
+			rem[j*lanes+k] = (hi >= k ? (m_inum[j]*(hi-k)) % D : 0);
 		}
-		for(std::size_t i(0); i < dimensions; ++i) {
-			
+	}
+	alignas(64) uinteger_base dist[lanes];
+	alignas(64) uinteger_base den[lanes];
+	for(std::size_t k(0); k < lanes; ++k) {
+		den[k] = hi-k;
+	}
+	for(uinteger_base top(hi); ; top -= lanes) {
+		for(std::size_t k(0); k < lanes; ++k) {
+			dist[k] = 0;
+		}
+		for(std::size_t j(0); j < dims; ++j) {
+			uinteger_base * r = rem.data() + j*lanes;
+			for(std::size_t k(0); k < lanes; ++k) {
+				uinteger_base d = std::min(r[k], D-r[k]);
+				dist[k] = std::max(dist[k], d);
+			}
+		}
+		//most blocks contain no improvement, check all lanes at once before looking at them one by one
+		bool improves = !best.den;
+		if (!improves) {
+			for(std::size_t k(0); k < lanes; ++k) {
+				improves |= (dist[k]*best.den < best.dist*den[k]);
+			}
+		}
+		if (improves) {
+			for(std::size_t k(0); k < lanes && k + lo <= top; ++k) {
+				Candidate c;
+				c.dist = dist[k];
+				c.den = den[k];
+				if (c.better(best)) {
+					best = c;
+				}
+			}
+			//dist >= 1 for all remaining candidates since there is no exact solution, hence den <= best.den/best.dist can not be better
+			raise(limit, best.den/best.dist);
+		}
+		if (top < lo + lanes || top - lanes <= limit.load(std::memory_order_relaxed)) {
+			break;
+		}
+		for(std::size_t j(0); j < dims; ++j) {
+			uinteger_base * r = rem.data() + j*lanes;
+			uinteger_base s = step[j];
+			for(std::size_t k(0); k < lanes; ++k) {
+				r[k] = (r[k] < s ? r[k] + (D - s) : r[k] - s);
+			}
+		}
+		for(std::size_t k(0); k < lanes; ++k) {
+			den[k] -= lanes;
 		}
 	}
+	return best;
 }
 
+CLS_TMPL_DECL
+void CLS_TMPL_NAME::run(std::size_t max_den) {
+	max_den = std::max<std::size_t>(max_den, 2);
+	if (!fits(max_den)) {
+		throw std::overflow_error("ratss::SimApxBruteForce::run: max_den is too large");
+	}
+	Candidate best;
+	//every multiple of the smallest exact denominator has distance 0
+	uinteger_base g = m_iden;
+	for(uinteger_base v : m_inum) {
+		g = std::gcd(g, v);
+	}
+	uinteger_base exact = m_iden / g;
+	if (exact <= max_den) {
+		best.den = std::max<uinteger_base>((max_den/exact)*exact, 2);
+	}
+	else {
+		std::size_t taskCount = (max_den-2)/task_size + 1;
+		std::vector<Candidate> results(taskCount);
+		std::atomic<uinteger_base> limit{1};
+		internal::WorkStealingExecutor executor(m_threadCount);
+		executor.run(taskCount, [&](std::size_t, std::size_t taskId) {
+			uinteger_base hi = max_den - taskId*task_size;
+			uinteger_base lo = (hi - 2 < task_size ? 2 : hi - task_size + 1);
+			results[taskId] = search(hi, lo, limit);
+		});
+		for(const Candidate & c : results) {
+			if (c.den && c.better(best)) {
+				best = c;
+			}
+		}
+	}
+	m_den = mpz_class(std::size_t(best.den));
+	m_num.resize(dimensions());
+	mpz_class r;
+	for(std::size_t j(0); j < dimensions(); ++j) {
+		mpz_class tmp = m_input[j].get_num()*m_den;
+		mpz_fdiv_qr(m_num[j].get_mpz_t(), r.get_mpz_t(), tmp.get_mpz_t(), m_input[j].get_den_mpz_t());
+		if (r*2 > m_input[j].get_den()) { //ceil is closer
+			m_num[j] += 1;
+		}
+		if (m_sign[j]) {
+			m_num[j] *= -1;
+		}
+	}
+}
 
 template<std::size_t T_DIMENSIONS>
 template<typename T_ITERATOR>
@@ -5,6 +5,8 @@
 #include <libratss/constants.h>
 #include <libratss/Conversion.h>
 #include <libratss/enum.h>
+#include <libratss/LLLConfig.h>
+#include <libratss/internal/WorkStealingExecutor.h>
 
 #include <fplll.h>
 
@@ -30,8 +32,20 @@ public:
 	void setEps(mpq_class eps);
 	void setSignificands(int v);
 	void setN(mpz_class v);
+	///backend of the LLL reduction, M_AUTO and FT_AUTO are resolved for every N
+	void setLLLConfig(const LLLConfig & v);
+	inline const LLLConfig & lllConfig() const { return lll_config; }
+	///Use [begin, end) as input, keeps the settings and reuses the buffers of the previous input
+	void reset(input_iterator begin, input_iterator end);
 public:
 	void run(SnapType st);
+	///Snaps numPoints points with the settings of this instance, the input of this instance is not used.
+	///Point i is [pointsBegin+i*d, pointsBegin+(i+1)*d) where d is the dimension of this instance.
+	///Its common denominator is written to outDenominators[i] and its numerators to [outNumerators.begin()+i*d, outNumerators.begin()+(i+1)*d).
+	///The result for every point is the same as the one of run(st), the points neither share a denominator nor a lattice.
+	///Every worker thread reuses one SimApxLLL and hence its buffers for all its points.
+	///@param threads number of worker threads, 0 uses all available cores
+	void runEach(input_iterator pointsBegin, std::size_t numPoints, SnapType st, std::vector<mpz_class> & outDenominators, std::vector<mpz_class> & outNumerators, std::size_t threads = 0) const;
 public:
 	inline mpz_class const & denominator() const { return best_common_denom; }
 	inline result_iterator numerators_begin() { return numerators.begin(); }
@@ -41,8 +55,17 @@ public:
 	mpq_class apxEps();
 private:
 	using Matrix = fplll::ZZ_mat<mpz_t>;
+	///reduced basis of the lattice for one j and N
+	struct WarmBasis {
+		Matrix mtx;
+		mpz_class N{0}; //0 if mtx is not set
+	};
 private:
 	void initB();
+	///initializes mtx with a basis of the lattice for w=2^j and the current N
+	void initBasis(Matrix & mtx, int j);
+	///reduces mtx with cfg, falls back to LLLConfig::exact if cfg fails
+	void reduce(Matrix & mtx, const LLLConfig & cfg);
 	void initN(mpq_class eps);
 	mpz_class run_single();
 private:
@@ -64,6 +87,14 @@ private:
 	
 	mpz_class current_eta{1};
 	mpz_class current_common_denom;
+	
+	//ST_FPLLL_WARM_START: reduced basis for every j of the last run_single
+	bool warm_start{false};
+	std::vector<WarmBasis> warm_bases;
+	
+	LLLConfig lll_config;
+	//the basis that is currently reduced, reused for all j, N and inputs
+	Matrix lattice;
 };
 	
 } //end namespace LIB_RATSS_NAMESPACE
@@ -83,11 +114,16 @@ SimApxLLL(begin, end, mpq_class(mpz_class(1), mpz_class(1) << significands))
 
 CLS_TMPL_DECL
 CLS_TMPL_NAME::SimApxLLL(input_iterator begin, input_iterator end, mpq_class eps) :
-begin(begin),
-end(end),
 target_eps(eps)
-{	
+{
+	reset(begin, end);
+}
+
+CLS_TMPL_DECL
+void CLS_TMPL_NAME::reset(input_iterator begin, input_iterator end) {
 	using std::distance;
+	this->begin = begin;
+	this->end = end;
 	dim = distance(begin, end);
 	
 	if (dim < 2) {
@@ -128,6 +164,11 @@ void CLS_TMPL_NAME::setN(mpz_class v) {
 	N = v;
 }
 
+CLS_TMPL_DECL
+void CLS_TMPL_NAME::setLLLConfig(const LLLConfig & v) {
+	lll_config = v;
+}
+
 CLS_TMPL_DECL
 void CLS_TMPL_NAME::initB() {
 	//init B, first check if all denominators of the input are equal
@@ -238,6 +279,8 @@ CLS_TMPL_DECL
 void CLS_TMPL_NAME::run(SnapType st) {
 	
 	initB();
+	warm_start = (st & ST_FPLLL_WARM_START);
+	warm_bases.clear();
 	#ifdef LIBRATSS_DEBUG_VERBOSE
 		std::cerr << "B=" << B << std::endl;
 	#endif
@@ -351,11 +394,27 @@ void CLS_TMPL_NAME::run(SnapType st) {
 	}
 }
 
+CLS_TMPL_DECL
+void CLS_TMPL_NAME::runEach(input_iterator pointsBegin, std::size_t numPoints, SnapType st, std::vector<mpz_class> & outDenominators, std::vector<mpz_class> & outNumerators, std::size_t threads) const {
+	outDenominators.resize(numPoints);
+	outNumerators.resize(numPoints*dim);
+	internal::WorkStealingExecutor executor(threads);
+	std::vector<SimApxLLL> workers(executor.threadCount(numPoints), *this);
+	executor.run(numPoints, [&](std::size_t workerId, std::size_t pointId) {
+		SimApxLLL & worker = workers[workerId];
+		input_iterator ptBegin = pointsBegin + pointId*dim;
+		worker.reset(ptBegin, ptBegin + dim);
+		worker.run(st);
+		outDenominators[pointId] = worker.denominator();
+		std::copy(worker.numerators_begin(), worker.numerators_end(), outNumerators.begin() + pointId*dim);
+	});
+}
+
 CLS_TMPL_DECL
 void CLS_TMPL_NAME::set_numerators() {
 	auto out  = numerators.begin();
 	if (best_common_denom == 0) {
-		for(; begin != end; ++begin, ++out) {
+		for(auto it(begin); it != end; ++it, ++out) {
 			*out = mpz_class(0);
 		}
 		best_common_denom = 1;
@@ -380,6 +439,107 @@ void CLS_TMPL_NAME::set_numerators() {
 	}
 }
 		
+CLS_TMPL_DECL
+void CLS_TMPL_NAME::initBasis(Matrix & mtx, int j) {
+	//The lattice for w and N is spanned by (w, N*B*x_1, ..., N*B*x_d) and N*B*e_i.
+	//Scaling column 0 by 2 maps the lattice of (w, N) onto the lattice of (2w, N).
+	//Scaling the columns 1..d by N'/N maps the lattice of (w, N) onto the lattice of (w, N'),
+	//this is exact since all entries in these columns are multiples of N.
+	//Hence a reduced basis of a neighbouring lattice is a nearly reduced basis which LLL handles much faster.
+	if (warm_start) {
+		if (warm_bases.size() <= std::size_t(j)) {
+			warm_bases.resize(j+1);
+		}
+		if (warm_bases[j].N != 0) {
+			mtx = warm_bases[j].mtx;
+			if (warm_bases[j].N != N) {
+				for(int r(0); r <= dim; ++r) {
+					for(int c(1); c <= dim; ++c) {
+						::mpz_divexact(mtx(r, c).get_data(), mtx(r, c).get_data(), warm_bases[j].N.get_mpz_t());
+						::mpz_mul(mtx(r, c).get_data(), mtx(r, c).get_data(), N.get_mpz_t());
+					}
+				}
+			}
+			return;
+		}
+		if (j > 1 && warm_bases[j-1].N == N) {
+			mtx = warm_bases[j-1].mtx;
+			for(int r(0); r <= dim; ++r) {
+				::mpz_mul_2exp(mtx(r, 0).get_data(), mtx(r, 0).get_data(), 1);
+			}
+			return;
+		}
+	}
+	mpz_class w;
+	if (j == 0) {
+		w = 1;
+	}
+	else {
+		w = mpz_class(1) << j;
+	}
+	
+	mtx.resize(dim+1, dim+1);
+	mtx.gen_zero(dim+1, dim+1);
+	
+	::mpz_set(mtx(0, 0).get_data(), w.get_mpz_t());
+	
+	auto it(begin);
+	for(int i(0); i < dim; ++i, ++it) {
+		mpz_class x(NB * (*it));
+		::mpz_set(mtx(0, i+1).get_data(), x.get_mpz_t());
+		::mpz_set(mtx(i+1, i+1).get_data(), NB.get_mpz_t());
+	}
+}
+
+CLS_TMPL_DECL
+void CLS_TMPL_NAME::reduce(Matrix & mtx, const LLLConfig & cfg) {
+	fplll::LLLMethod method = fplll::LM_WRAPPER;
+	switch (cfg.method()) {
+	case LLLConfig::M_FAST:
+		method = fplll::LM_FAST;
+		break;
+	case LLLConfig::M_HEURISTIC:
+		method = fplll::LM_HEURISTIC;
+		break;
+	case LLLConfig::M_PROVED:
+		method = fplll::LM_PROVED;
+		break;
+	default:
+		break;
+	}
+	fplll::FloatType floatType = fplll::FT_DEFAULT;
+	switch (cfg.floatType()) {
+	case LLLConfig::FT_DOUBLE:
+		floatType = fplll::FT_DOUBLE;
+		break;
+	case LLLConfig::FT_LONG_DOUBLE:
+		floatType = fplll::FT_LONG_DOUBLE;
+		break;
+	case LLLConfig::FT_DPE:
+		floatType = fplll::FT_DPE;
+		break;
+	case LLLConfig::FT_MPFR:
+		floatType = fplll::FT_MPFR;
+		break;
+	default:
+		break;
+	}
+	int flags = (cfg.earlyReduction() ? fplll::LLL_EARLY_RED : fplll::LLL_DEFAULT);
+	
+	//a failed reduction may leave the basis partially reduced, which is still a basis of the same lattice
+	int status = fplll::lll_reduction(mtx, LLLConfig::default_delta, LLLConfig::default_eta, method, floatType, cfg.precision(), flags);
+	if (status != fplll::RedStatus::RED_SUCCESS && cfg != LLLConfig::exact(dim+1)) {
+		#ifdef LIBRATSS_DEBUG_VERBOSE
+			std::cerr << "LLL reduction with " << LLLConfig::toString(cfg) << " failed with status=" << status << ", falling back to exact arithmetic" << std::endl;
+		#endif
+		reduce(mtx, LLLConfig::exact(dim+1));
+		return;
+	}
+	if (status != fplll::RedStatus::RED_SUCCESS) {
+		throw std::runtime_error("ratss::Calc::lll: LLL reduction failed with status=" + std::to_string(status));
+	}
+}
+
 CLS_TMPL_DECL
 mpz_class CLS_TMPL_NAME::run_single() {
 	
@@ -402,37 +562,32 @@ mpz_class CLS_TMPL_NAME::run_single() {
 		std::cerr << "NB=" << NB << std::endl;
 	#endif
 	
+	//entries of the basis are bounded by max(w, N*B*max(abs(x_i)))
+	std::size_t entryBits = 0;
+	for(auto it(begin); it != end; ++it) {
+		mpz_class x(NB * abs(*it));
+		entryBits = std::max<std::size_t>(entryBits, ::mpz_sizeinbase(x.get_mpz_t(), 2));
+	}
+	entryBits = std::max<std::size_t>(entryBits, dim+::mpz_sizeinbase(NB.get_mpz_t(), 2));
+	LLLConfig cfg = lll_config.select(dim+1, entryBits);
+	
+	#ifdef LIBRATSS_DEBUG_VERBOSE
+		std::cerr << "LLL backend: " << LLLConfig::toString(cfg) << std::endl;
+	#endif
+	
 	for(int j(1), s(dim+::mpz_sizeinbase(NB.get_mpz_t(), 2)); j < s; ++j) {
 		#ifdef LIBRATSS_DEBUG_VERBOSE
 			std::cerr << "Checking matrix for j=" << j << std::endl;
 		#endif
-		mpz_class w;
-		if (j == 0) {
-			w = 1;
-		}
-		else {
-			w = mpz_class(1) << j;
-		}
-		
-		Matrix mtx(dim+1, dim+1);
-		mtx.gen_zero(dim+1, dim+1);
-		
-		::mpz_set(mtx(0, 0).get_data(), w.get_mpz_t());
-		
-		{
-			auto it(begin);
-			for(int i(0); i < dim; ++i, ++it) {
-				mpz_class x(NB * (*it));
-				::mpz_set(mtx(0, i+1).get_data(), x.get_mpz_t());
-				::mpz_set(mtx(i+1, i+1).get_data(), NB.get_mpz_t());
-			}
-		}
+		Matrix & mtx = lattice;
+		initBasis(mtx, j);
 		#ifdef LIBRATSS_DEBUG_VERBOSE
 			std::cerr << mtx << std::endl;
 		#endif
-		int status = fplll::lll_reduction(mtx);
-		if (status != fplll::RedStatus::RED_SUCCESS) {
-			throw std::runtime_error("ratss::Calc::lll: LLL reduction failed with status=" + std::to_string(status));
+		reduce(mtx, cfg);
+		if (warm_start) {
+			warm_bases[j].mtx = mtx;
+			warm_bases[j].N = N;
 		}
 		
 		#ifdef LIBRATSS_DEBUG_VERBOSE
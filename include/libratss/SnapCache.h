@@ -0,0 +1,152 @@
+#ifndef LIB_RATSS_SNAP_CACHE_H
+#define LIB_RATSS_SNAP_CACHE_H
+#pragma once
+
+#include <libratss/constants.h>
+
+#include <mpreal/mpreal.h>
+#include <gmpxx.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace LIB_RATSS_NAMESPACE {
+
+///Bounded cache of snapped points for inputs that occur many times, e.g. vertices shared by several polygons.
+///Keys are the exact bits of the input coordinates (including the precision of mpfr::mpreal) together with snap type and significands,
+///hence a hit returns exactly what ProjectSN::snap would compute.
+///The table is set associative with ways entries per set, a full set evicts with the CLOCK algorithm.
+///All functions are thread-safe, sets are protected by a fixed number of locks.
+class SnapCache {
+public:
+	static constexpr std::size_t ways = 4;
+	static constexpr std::size_t default_capacity = std::size_t(1) << 16;
+public:
+	///@param capacity maximum number of cached points, rounded up to a multiple of ways
+	explicit SnapCache(std::size_t capacity = default_capacity);
+	SnapCache(const SnapCache & other) = delete;
+	SnapCache & operator=(const SnapCache & other) = delete;
+	~SnapCache();
+public:
+	///Serializes the input point into key, key is reused to avoid allocations
+	///Supported coordinate types are float, double, mpfr::mpreal and mpq_class
+	template<typename T_INPUT_ITERATOR>
+	static void makeKey(T_INPUT_ITERATOR begin, const T_INPUT_ITERATOR & end, int snapType, int significands, std::string & key);
+	///@param out receives the cached coordinates if there is an entry for key
+	///@return true on a hit
+	template<typename T_OUTPUT_ITERATOR>
+	bool find(const std::string & key, T_OUTPUT_ITERATOR out);
+	void insert(const std::string & key, const std::vector<mpq_class> & point);
+	void clear();
+public:
+	inline std::size_t capacity() const { return m_entries.size(); }
+	inline std::size_t hits() const { return m_hits.load(std::memory_order_relaxed); }
+	inline std::size_t misses() const { return m_misses.load(std::memory_order_relaxed); }
+	inline std::size_t evictions() const { return m_evictions.load(std::memory_order_relaxed); }
+	///hits/(hits+misses), 0 if there was no lookup
+	double hitRate() const;
+	void resetCounters();
+private:
+	struct Entry {
+		std::size_t hash{0};
+		std::string key;
+		std::vector<mpq_class> point;
+		bool valid{false};
+		bool referenced{false};
+	};
+	static constexpr std::size_t num_locks = 64;
+private:
+	///@return index of the entry of key in its set or ways if there is none, the lock of the set has to be held
+	std::size_t findEntry(std::size_t set, std::size_t hash, const std::string & key) const;
+	inline std::size_t setOf(std::size_t hash) const { return hash % m_hands.size(); }
+	inline std::mutex & lockOf(std::size_t set) const { return m_locks[set % num_locks]; }
+	template<typename T>
+	static void append(std::string & key, const T & v);
+private:
+	std::vector<Entry> m_entries; //set s consists of [s*ways, (s+1)*ways)
+	std::vector<unsigned char> m_hands; //clock hand of each set
+	std::unique_ptr<std::mutex[]> m_locks;
+	std::atomic<std::size_t> m_hits{0};
+	std::atomic<std::size_t> m_misses{0};
+	std::atomic<std::size_t> m_evictions{0};
+};
+
+}//end namespace LIB_RATSS_NAMESPACE
+
+//definitions
+
+namespace LIB_RATSS_NAMESPACE {
+
+template<typename T>
+void SnapCache::append(std::string & key, const T & v) {
+	static_assert(std::is_trivially_copyable<T>::value, "ratss::SnapCache::append: only trivially copyable values can be appended");
+	char buffer[sizeof(T)];
+	std::memcpy(buffer, &v, sizeof(T));
+	key.append(buffer, sizeof(T));
+}
+
+template<typename T_INPUT_ITERATOR>
+void SnapCache::makeKey(T_INPUT_ITERATOR begin, const T_INPUT_ITERATOR & end, int snapType, int significands, std::string & key) {
+	using value_type = typename std::iterator_traits<T_INPUT_ITERATOR>::value_type;
+	key.clear();
+	append(key, snapType);
+	append(key, significands);
+	for(; begin != end; ++begin) {
+		if constexpr (std::is_same<value_type, float>::value || std::is_same<value_type, double>::value) {
+			append(key, *begin);
+		}
+		else if constexpr (std::is_same<value_type, mpfr::mpreal>::value) {
+			mpfr_srcptr v = begin->mpfr_srcptr();
+			mpfr_prec_t prec = mpfr_get_prec(v);
+			int kind = mpfr_custom_get_kind(v);
+			append(key, prec);
+			append(key, kind);
+			if (mpfr_regular_p(v)) {
+				append(key, mpfr_custom_get_exp(v));
+				key.append(static_cast<const char*>(mpfr_custom_get_significand(v)), mpfr_custom_get_size(prec));
+			}
+		}
+		else if constexpr (std::is_same<value_type, mpq_class>::value) {
+			//the signed limb count precedes the limbs, this keeps numerator and denominator apart
+			for(mpz_srcptr z : {begin->get_num_mpz_t(), begin->get_den_mpz_t()}) {
+				int size = z->_mp_size;
+				append(key, size);
+				key.append(reinterpret_cast<const char*>(z->_mp_d), std::abs(size)*sizeof(mp_limb_t));
+			}
+		}
+		else {
+			static_assert(std::is_same<value_type, double>::value, "ratss::SnapCache::makeKey: unsupported coordinate type");
+		}
+	}
+}
+
+template<typename T_OUTPUT_ITERATOR>
+bool SnapCache::find(const std::string & key, T_OUTPUT_ITERATOR out) {
+	std::size_t hash = std::hash<std::string>()(key);
+	std::size_t set = setOf(hash);
+	{
+		std::lock_guard<std::mutex> lck(lockOf(set));
+		std::size_t way = findEntry(set, hash, key);
+		if (way < ways) {
+			Entry & e = m_entries[set*ways + way];
+			e.referenced = true;
+			std::copy(e.point.begin(), e.point.end(), out);
+			m_hits.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+	m_misses.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
+
+}//end namespace LIB_RATSS_NAMESPACE
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef LIB_RATSS_SNAP_WORKSPACE_H
+#define LIB_RATSS_SNAP_WORKSPACE_H
+#pragma once
+
+#include <libratss/constants.h>
+#include <libratss/Calc.h>
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace LIB_RATSS_NAMESPACE {
+
+///Statistics of the automatic selection of the snap type by ProjectSN::snap with ST_AUTO
+class AutoSnapStats {
+public:
+	///Snap types considered by ST_AUTO, ties of a policy are resolved in this order
+	static constexpr std::array<int, 8> candidates{
+		ST_FL, ST_FX,
+		ST_CF_GUARANTEE_DISTANCE, ST_CF_GUARANTEE_SIZE,
+		ST_JP_GUARANTEE_DISTANCE, ST_JP_GUARANTEE_SIZE,
+		ST_FPLLL_GUARANTEE_DISTANCE, ST_FPLLL_GUARANTEE_SIZE
+	};
+	static constexpr std::array<int, 5> policies{
+		ST_AUTO_POLICY_MIN_SUM_DENOM, ST_AUTO_POLICY_MIN_MAX_DENOM, ST_AUTO_POLICY_MIN_TOTAL_LIMBS,
+		ST_AUTO_POLICY_MIN_SQUARED_DISTANCE, ST_AUTO_POLICY_MIN_MAX_NORM
+	};
+public:
+	///@return index of snapType in candidates, candidates.size() if it is not a candidate
+	static std::size_t candidateIndex(int snapType) {
+		std::size_t i = 0;
+		for(; i < candidates.size() && candidates[i] != snapType; ++i) {}
+		return i;
+	}
+	///@return index of policy in policies, policies.size() if it is not a policy
+	static std::size_t policyIndex(int policy) {
+		std::size_t i = 0;
+		for(; i < policies.size() && policies[i] != policy; ++i) {}
+		return i;
+	}
+public:
+	///number of points for which snapType was selected by policy
+	std::size_t wins(int policy, int snapType) const {
+		return winCount.at(policyIndex(policy)).at(candidateIndex(snapType));
+	}
+	///mean time in nanoseconds needed to snap a point with candidates[i], 0 if it was never used
+	double expectedCost(std::size_t i) const {
+		return snapCount[i] ? snapNs[i]/snapCount[i] : 0;
+	}
+	void reset() { *this = AutoSnapStats(); }
+	AutoSnapStats & operator+=(const AutoSnapStats & other) {
+		for(std::size_t i(0); i < policies.size(); ++i) {
+			for(std::size_t j(0); j < candidates.size(); ++j) {
+				winCount[i][j] += other.winCount[i][j];
+			}
+		}
+		for(std::size_t j(0); j < candidates.size(); ++j) {
+			snapNs[j] += other.snapNs[j];
+			snapCount[j] += other.snapCount[j];
+		}
+		graded += other.graded;
+		aborted += other.aborted;
+		skipped += other.skipped;
+		return *this;
+	}
+public:
+	std::array<std::array<std::size_t, candidates.size()>, policies.size()> winCount{}; //[policy][candidate]
+	std::array<double, candidates.size()> snapNs{}; //time spent snapping with each candidate
+	std::array<std::size_t, candidates.size()> snapCount{}; //number of points snapped with each candidate
+	std::size_t graded{0}; //candidates that were snapped and graded completely
+	std::size_t aborted{0}; //candidates whose grading stopped as soon as they could not win anymore
+	std::size_t skipped{0}; //candidates that were not snapped since the best already reached the lower bound of the policy
+};
+
+///Reusable temporaries for ProjectSN::snap.
+///Passing the same workspace to consecutive calls avoids allocating and initializing the intermediate buffers on every call.
+///Snapping mpfr::mpreal input with ST_FX or ST_FL (optionally with ST_NORMALIZE) does not allocate at all once the workspace has seen a point.
+///The same holds for double input with ST_FX and at most 52 significands.
+///A workspace must not be used by multiple threads at the same time.
+template<typename T_FT = mpfr::mpreal>
+class SnapWorkspace {
+public:
+	using value_type = T_FT;
+public:
+	SnapWorkspace() {}
+	explicit SnapWorkspace(std::size_t dims) { reserve(dims); }
+public:
+	///initialize all buffers for points with dims coordinates
+	void reserve(std::size_t dims) {
+		normalized.resize(dims);
+		plane.resize(dims);
+		planePq.resize(dims);
+		spherePq.resize(dims);
+		candidate.resize(dims);
+		autoBest.resize(dims);
+		inputPq.resize(dims);
+		planeNum.resize(dims);
+	}
+public:
+	std::vector<value_type> normalized; //input coordinates scaled to length 1
+	std::vector<value_type> plane; //input coordinates projected onto the plane
+	std::vector<mpq_class> planePq; //snapped coordinates in the plane
+	std::vector<mpq_class> spherePq; //snapped coordinates on the sphere
+	std::vector<mpq_class> candidate; //snapped point of the snap type currently evaluated by ST_AUTO
+	std::vector<mpq_class> autoBest; //snapped point of the best snap type found by ST_AUTO so far
+	std::vector<mpq_class> inputPq; //input coordinates as rationals for the distance policies of ST_AUTO
+	std::vector<mpq_class> cached; //snapped point that is added to the SnapCache
+	std::vector<mpz_class> planeNum; //numerators of planePq with respect to their common denominator for ProjectSN::snapHomogeneous
+	std::vector<mpq_class> canonical; //snapped point of ProjectSN::snapHomogeneous for snap types that canonicalize anyway
+	std::string cacheKey; //key of the point in the SnapCache
+	value_type ft[3];
+	mpq_class pq[3];
+	mpz_class pz[3];
+	Calc::Scratch calc;
+	LLLConfig lll; //backend of the LLL reduction for ST_FPLLL, set from ProjectSN::SnapConfig
+	AutoSnapStats autoStats; //accumulated over all points snapped with ST_AUTO using this workspace
+	std::size_t autoThreads{1}; //threads evaluating the candidates of ST_AUTO, set from ProjectSN::SnapConfig
+	std::vector<SnapWorkspace> autoWorkers; //one workspace per thread evaluating candidates of ST_AUTO
+};
+
+}//end namespace LIB_RATSS_NAMESPACE
+
+#endif
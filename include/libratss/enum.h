@@ -50,6 +50,10 @@ public:
 	VA(policyMinMaxNorm, ST_AUTO_POLICY_MIN_MAX_NORM)
 	
 	VA(normalize, ST_NORMALIZE)
+	
+	VA(cfLehmer, ST_CF_LEHMER)
+	VA(cfHalfGcd, ST_CF_HALF_GCD)
+	VA(fplllWarmStart, ST_FPLLL_WARM_START)
 #undef VA
 public:
 	inline constexpr SafeSnapType operator|(SafeSnapType const & other) const { return SafeSnapType(m_v | other.m_v); }
@@ -119,6 +123,12 @@ private:
 		
 		ST_NORMALIZE=ST_AUTO_POLICY_MIN_MAX_NORM*2,
 		
+		ST_CF_LEHMER=ST_NORMALIZE*2, //compute continued fractions with Lehmer's algorithm
+		ST_CF_HALF_GCD=ST_CF_LEHMER*2, //compute continued fractions with a recursive half-gcd, use for very large inputs
+		ST_CF_ENGINE_MASK=ST_CF_LEHMER|ST_CF_HALF_GCD,
+		
+		ST_FPLLL_WARM_START=ST_CF_HALF_GCD*2, //reuse the reduced bases of the previous N in the N search of ST_FPLLL
+		
 		//Do not use the values below!
 		ST__INTERNAL_NUMBER_OF_SNAPPING_TYPES=7, //this effecivly defines the shift to get from ST_* to ST_AUTO_*
 		ST__INTERNAL_AUTO_POLICIES=ST_AUTO_POLICY_MIN_SUM_DENOM|ST_AUTO_POLICY_MIN_MAX_DENOM|ST_AUTO_POLICY_MIN_TOTAL_LIMBS|ST_AUTO_POLICY_MIN_SQUARED_DISTANCE|ST_AUTO_POLICY_MIN_MAX_NORM,
@@ -193,6 +203,12 @@ typedef enum : int {
 	
 	ST_NORMALIZE=ST_AUTO_POLICY_MIN_MAX_NORM*2,
 	
+	ST_CF_LEHMER=ST_NORMALIZE*2, //compute continued fractions with Lehmer's algorithm
+	ST_CF_HALF_GCD=ST_CF_LEHMER*2, //compute continued fractions with a recursive half-gcd, use for very large inputs
+	ST_CF_ENGINE_MASK=ST_CF_LEHMER|ST_CF_HALF_GCD,
+	
+	ST_FPLLL_WARM_START=ST_CF_HALF_GCD*2, //reuse the reduced bases of the previous N in the N search of ST_FPLLL
+	
 	//Do not use the values below!
 	ST__INTERNAL_NUMBER_OF_SNAPPING_TYPES=7, //this effecivly defines the shift to get from ST_* to ST_AUTO_*
 	ST__INTERNAL_AUTO_POLICIES=ST_AUTO_POLICY_MIN_SUM_DENOM|ST_AUTO_POLICY_MIN_MAX_DENOM|ST_AUTO_POLICY_MIN_TOTAL_LIMBS|ST_AUTO_POLICY_MIN_SQUARED_DISTANCE|ST_AUTO_POLICY_MIN_MAX_NORM,
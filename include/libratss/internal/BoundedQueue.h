@@ -0,0 +1,94 @@
+#ifndef LIB_RATSS_INTERNAL_BOUNDED_QUEUE_H
+#define LIB_RATSS_INTERNAL_BOUNDED_QUEUE_H
+#pragma once
+
+#include <libratss/constants.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace LIB_RATSS_NAMESPACE {
+namespace internal {
+
+///Thread-safe fifo queue with a fixed capacity for producer/consumer pipelines
+template<typename T>
+class BoundedQueue {
+public:
+	using value_type = T;
+public:
+	explicit BoundedQueue(std::size_t capacity);
+	BoundedQueue(const BoundedQueue & other) = delete;
+	BoundedQueue & operator=(const BoundedQueue & other) = delete;
+public:
+	///blocks while the queue is full
+	///@return false if the queue was closed, v is left untouched in this case
+	bool push(value_type && v);
+	///blocks while the queue is empty
+	///@return false if the queue is closed and empty
+	bool pop(value_type & v);
+	///No further elements are accepted, remaining elements can still be popped
+	void close();
+private:
+	std::mutex m_lock;
+	std::condition_variable m_notFull;
+	std::condition_variable m_notEmpty;
+	std::deque<value_type> m_d;
+	std::size_t m_capacity;
+	bool m_closed;
+};
+
+}}//end namespace LIB_RATSS_NAMESPACE::internal
+
+//definitions
+
+namespace LIB_RATSS_NAMESPACE {
+namespace internal {
+
+template<typename T>
+BoundedQueue<T>::BoundedQueue(std::size_t capacity) :
+m_capacity(std::max<std::size_t>(1, capacity)),
+m_closed(false)
+{}
+
+template<typename T>
+bool BoundedQueue<T>::push(value_type && v) {
+	std::unique_lock<std::mutex> lck(m_lock);
+	m_notFull.wait(lck, [this]() { return m_closed || m_d.size() < m_capacity; });
+	if (m_closed) {
+		return false;
+	}
+	m_d.push_back(std::move(v));
+	lck.unlock();
+	m_notEmpty.notify_one();
+	return true;
+}
+
+template<typename T>
+bool BoundedQueue<T>::pop(value_type & v) {
+	std::unique_lock<std::mutex> lck(m_lock);
+	m_notEmpty.wait(lck, [this]() { return m_closed || m_d.size(); });
+	if (m_d.empty()) {
+		return false;
+	}
+	v = std::move(m_d.front());
+	m_d.pop_front();
+	lck.unlock();
+	m_notFull.notify_one();
+	return true;
+}
+
+template<typename T>
+void BoundedQueue<T>::close() {
+	{
+		std::lock_guard<std::mutex> lck(m_lock);
+		m_closed = true;
+	}
+	m_notFull.notify_all();
+	m_notEmpty.notify_all();
+}
+
+}}//end namespace LIB_RATSS_NAMESPACE::internal
+
+#endif
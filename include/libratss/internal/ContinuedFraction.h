@@ -0,0 +1,403 @@
+#ifndef LIB_RATSS_INTERNAL_CONTINUED_FRACTION_H
+#define LIB_RATSS_INTERNAL_CONTINUED_FRACTION_H
+#pragma once
+
+#include <libratss/constants.h>
+#include <libratss/enum.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <gmpxx.h>
+
+namespace LIB_RATSS_NAMESPACE {
+namespace internal {
+
+///Regular continued fraction expansion of d/n computed by the euclidean algorithm.
+///After the partial quotient a_i the state consists of the remainder pair (d, n)
+///and the convergents h1/k1 = h_i/k_i and h0/k0 = h_(i-1)/k_(i-1).
+///For the expansion of num/den the remainder n is always abs(h1*den - num*k1).
+///
+///Besides single division steps the expansion can advance by batches of partial quotients:
+///CE_LEHMER computes them with single-word arithmetic on the leading bits of (d, n) (Lehmer's algorithm),
+///CE_HALF_GCD recursively on the leading half of (d, n) which is subquadratic for very large numbers.
+///A batch is applied to the full numbers only if its remainders satisfy d > n > 0,
+///which is the case iff all partial quotients of the batch are those of d/n.
+///Hence all engines compute the same partial quotients and convergents.
+class ContinuedFraction final {
+public:
+	typedef enum : int { CE_CLASSIC, CE_LEHMER, CE_HALF_GCD } Engine;
+	///Partial quotients q_1..q_count and P = Q(q_1)*...*Q(q_count) with Q(q) = [[q, 1], [1, 0]]
+	struct Batch {
+		mpz_class p11, p12, p21, p22;
+		std::vector<mpz_class> quotients;
+		std::size_t count{0};
+		Batch() { reset(); }
+		inline void reset();
+		inline bool odd() const { return count & 1; }
+		inline mpz_srcptr back() const { return quotients[count-1].get_mpz_t(); }
+		///P = P*Q(q)
+		inline void push(mpz_srcptr q);
+		///P = P*Q(back())^-1
+		inline void pop();
+		///P = P*other.P, the quotients of other are moved
+		inline void append(Batch & other, mpz_class & tmp1, mpz_class & tmp2);
+	};
+	static constexpr int word_bits = std::numeric_limits<unsigned long>::digits - 1;
+	///numbers with more bits use the recursive half-gcd
+	static constexpr mp_bitcnt_t half_gcd_threshold = 4096;
+public:
+	///@return engine selected by the ST_CF_* engine flags of snapType
+	static inline Engine engine(int snapType);
+public:
+	///start the expansion of num/den with num >= 0 and den > 0
+	inline void init(mpz_srcptr num, mpz_srcptr den);
+	inline bool done() const { return mpz_sgn(m_n.get_mpz_t()) == 0; }
+	///compute the next partial quotient by a single division
+	inline void step();
+	///advance by the partial quotient q which has to be the next one
+	inline void step(mpz_srcptr q);
+	///Advance until stop(n, k1) returns true or the expansion ends.
+	///stop has to be monotone, i.e. once true it is true for all later convergents.
+	///@return true if stop returned true
+	template<typename T_STOP>
+	bool run(Engine engine, T_STOP stop);
+	///Advance this and other by batches of partial quotients both expansions have in common
+	///such that all remainders stay non-zero. Remaining common partial quotients may be left to step().
+	inline void runCommon(ContinuedFraction & other, Engine engine);
+public:
+	inline mpz_srcptr d() const { return m_d.get_mpz_t(); }
+	inline mpz_srcptr n() const { return m_n.get_mpz_t(); }
+	inline mpz_srcptr h0() const { return m_h0.get_mpz_t(); }
+	inline mpz_srcptr h1() const { return m_h1.get_mpz_t(); }
+	inline mpz_srcptr k0() const { return m_k0.get_mpz_t(); }
+	inline mpz_srcptr k1() const { return m_k1.get_mpz_t(); }
+private:
+	static inline mp_bitcnt_t bits(mpz_srcptr v) { return mpz_sgn(v) ? mpz_sizeinbase(v, 2) : 0; }
+	static inline int bits(unsigned long v) { return v ? std::numeric_limits<unsigned long>::digits - __builtin_clzl(v) : 0; }
+	///(d, n) = P*(td, tn)
+	static inline void apply(const Batch & batch, mpz_srcptr d, mpz_srcptr n, mpz_ptr td, mpz_ptr tn);
+	static inline bool valid(mpz_srcptr d, mpz_srcptr n) { return mpz_sgn(n) > 0 && mpz_cmp(d, n) > 0; }
+	///(d, n) = (q*d + n, d)
+	static inline void undo(mpz_srcptr q, mpz_ptr d, mpz_ptr n);
+	///Euclidean algorithm on the leading word_bits bits of x >= y until y has at most targetBits bits.
+	///The quotients are exact if x fits into a word.
+	static inline void wordBatch(mpz_srcptr x, mpz_srcptr y, mp_bitcnt_t targetBits, Batch & batch, mpz_class & tmp);
+	///Euclidean algorithm on x >= y until y has at most targetBits bits, appends the quotients to batch
+	static inline void halfGcd(mpz_class & x, mpz_class & y, mp_bitcnt_t targetBits, Batch & batch);
+	///Batch of partial quotients of the current state in m_batch, topBits limits the size of the leading part
+	///@return number of leading bits used by the half-gcd or 0 if the batch was computed by wordBatch
+	inline mp_bitcnt_t batch(Engine engine, mp_bitcnt_t topBits);
+	///tentative convergents for m_batch
+	inline void convergents();
+	inline void swapTentative();
+private:
+	mpz_class m_d, m_n;
+	mpz_class m_h0, m_h1, m_k0, m_k1;
+	mpz_class m_q;
+	//tentative state
+	mpz_class m_td, m_tn;
+	mpz_class m_th0, m_th1, m_tk0, m_tk1;
+	mpz_class m_x, m_y;
+	Batch m_batch;
+};
+
+}} //end namespace LIB_RATSS_NAMESPACE::internal
+
+//definitions
+
+namespace LIB_RATSS_NAMESPACE {
+namespace internal {
+
+void ContinuedFraction::Batch::reset() {
+	mpz_set_ui(p11.get_mpz_t(), 1);
+	mpz_set_ui(p12.get_mpz_t(), 0);
+	mpz_set_ui(p21.get_mpz_t(), 0);
+	mpz_set_ui(p22.get_mpz_t(), 1);
+	count = 0;
+}
+
+void ContinuedFraction::Batch::push(mpz_srcptr q) {
+	if (quotients.size() <= count) {
+		quotients.emplace_back();
+	}
+	mpz_set(quotients[count].get_mpz_t(), q);
+	++count;
+	//[[p11, p12], [p21, p22]]*[[q, 1], [1, 0]] = [[p11*q + p12, p11], [p21*q + p22, p21]]
+	mpz_addmul(p12.get_mpz_t(), p11.get_mpz_t(), q);
+	mpz_swap(p11.get_mpz_t(), p12.get_mpz_t());
+	mpz_addmul(p22.get_mpz_t(), p21.get_mpz_t(), q);
+	mpz_swap(p21.get_mpz_t(), p22.get_mpz_t());
+}
+
+void ContinuedFraction::Batch::pop() {
+	assert(count);
+	mpz_srcptr q = back();
+	//[[p11, p12], [p21, p22]]*[[0, 1], [1, -q]] = [[p12, p11 - q*p12], [p22, p21 - q*p22]]
+	mpz_submul(p11.get_mpz_t(), q, p12.get_mpz_t());
+	mpz_swap(p11.get_mpz_t(), p12.get_mpz_t());
+	mpz_submul(p21.get_mpz_t(), q, p22.get_mpz_t());
+	mpz_swap(p21.get_mpz_t(), p22.get_mpz_t());
+	--count;
+}
+
+void ContinuedFraction::Batch::append(Batch & other, mpz_class & tmp1, mpz_class & tmp2) {
+	if (quotients.size() < count + other.count) {
+		quotients.resize(count + other.count);
+	}
+	for(std::size_t i(0); i < other.count; ++i, ++count) {
+		mpz_swap(quotients[count].get_mpz_t(), other.quotients[i].get_mpz_t());
+	}
+	mpz_class * rows[2][2] = {{&p11, &p12}, {&p21, &p22}};
+	for(auto & row : rows) {
+		mpz_mul(tmp1.get_mpz_t(), row[0]->get_mpz_t(), other.p11.get_mpz_t());
+		mpz_addmul(tmp1.get_mpz_t(), row[1]->get_mpz_t(), other.p21.get_mpz_t());
+		mpz_mul(tmp2.get_mpz_t(), row[0]->get_mpz_t(), other.p12.get_mpz_t());
+		mpz_addmul(tmp2.get_mpz_t(), row[1]->get_mpz_t(), other.p22.get_mpz_t());
+		mpz_swap(row[0]->get_mpz_t(), tmp1.get_mpz_t());
+		mpz_swap(row[1]->get_mpz_t(), tmp2.get_mpz_t());
+	}
+}
+
+ContinuedFraction::Engine ContinuedFraction::engine(int snapType) {
+	if (snapType & ST_CF_HALF_GCD) {
+		return CE_HALF_GCD;
+	}
+	if (snapType & ST_CF_LEHMER) {
+		return CE_LEHMER;
+	}
+	return CE_CLASSIC;
+}
+
+void ContinuedFraction::init(mpz_srcptr num, mpz_srcptr den) {
+	assert(mpz_sgn(num) >= 0 && mpz_sgn(den) > 0);
+	mpz_set(m_d.get_mpz_t(), num);
+	mpz_set(m_n.get_mpz_t(), den);
+	//h_(-2)/k_(-2) = 0/1, h_(-1)/k_(-1) = 1/0
+	mpz_set_ui(m_h0.get_mpz_t(), 0);
+	mpz_set_ui(m_h1.get_mpz_t(), 1);
+	mpz_set_ui(m_k0.get_mpz_t(), 1);
+	mpz_set_ui(m_k1.get_mpz_t(), 0);
+}
+
+void ContinuedFraction::step() {
+	assert(!done());
+	mpz_tdiv_q(m_q.get_mpz_t(), m_d.get_mpz_t(), m_n.get_mpz_t());
+	step(m_q.get_mpz_t());
+}
+
+void ContinuedFraction::step(mpz_srcptr q) {
+	//d = q*n + r
+	mpz_submul(m_d.get_mpz_t(), q, m_n.get_mpz_t());
+	mpz_swap(m_d.get_mpz_t(), m_n.get_mpz_t());
+	//h_i = q*h_(i-1) + h_(i-2)
+	mpz_addmul(m_h0.get_mpz_t(), q, m_h1.get_mpz_t());
+	mpz_swap(m_h0.get_mpz_t(), m_h1.get_mpz_t());
+	mpz_addmul(m_k0.get_mpz_t(), q, m_k1.get_mpz_t());
+	mpz_swap(m_k0.get_mpz_t(), m_k1.get_mpz_t());
+}
+
+template<typename T_STOP>
+bool ContinuedFraction::run(Engine engine, T_STOP stop) {
+	mp_bitcnt_t maxTopBits = std::numeric_limits<mp_bitcnt_t>::max();
+	while (!done()) {
+		if (engine != CE_CLASSIC && mpz_cmp(m_d.get_mpz_t(), m_n.get_mpz_t()) > 0) {
+			mp_bitcnt_t topBits = batch(engine, maxTopBits);
+			if (m_batch.count) {
+				convergents();
+				if (!stop(m_tn.get_mpz_t(), m_tk1.get_mpz_t())) {
+					swapTentative();
+					continue;
+				}
+				//stop is reached within the batch, retry with smaller batches
+				if (topBits) {
+					maxTopBits = topBits/2;
+					continue;
+				}
+				for(std::size_t i(0); i < m_batch.count; ++i) {
+					step(m_batch.quotients[i].get_mpz_t());
+					if (stop(m_n.get_mpz_t(), m_k1.get_mpz_t())) {
+						return true;
+					}
+				}
+				assert(false);
+				continue;
+			}
+		}
+		step();
+		if (stop(m_n.get_mpz_t(), m_k1.get_mpz_t())) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void ContinuedFraction::runCommon(ContinuedFraction & other, Engine engine) {
+	if (engine == CE_CLASSIC) {
+		return;
+	}
+	while (!done() && !other.done() && mpz_cmp(m_d.get_mpz_t(), m_n.get_mpz_t()) > 0 && mpz_cmp(other.m_d.get_mpz_t(), other.m_n.get_mpz_t()) > 0) {
+		batch(engine, std::numeric_limits<mp_bitcnt_t>::max());
+		apply(m_batch, other.d(), other.n(), other.m_td.get_mpz_t(), other.m_tn.get_mpz_t());
+		while (m_batch.count && !valid(other.m_td.get_mpz_t(), other.m_tn.get_mpz_t())) {
+			undo(m_batch.back(), m_td.get_mpz_t(), m_tn.get_mpz_t());
+			undo(m_batch.back(), other.m_td.get_mpz_t(), other.m_tn.get_mpz_t());
+			m_batch.pop();
+		}
+		if (!m_batch.count) {
+			return;
+		}
+		convergents();
+		swapTentative();
+		mpz_swap(other.m_d.get_mpz_t(), other.m_td.get_mpz_t());
+		mpz_swap(other.m_n.get_mpz_t(), other.m_tn.get_mpz_t());
+		//both expansions have the same convergents so far
+		mpz_set(other.m_h0.get_mpz_t(), m_h0.get_mpz_t());
+		mpz_set(other.m_h1.get_mpz_t(), m_h1.get_mpz_t());
+		mpz_set(other.m_k0.get_mpz_t(), m_k0.get_mpz_t());
+		mpz_set(other.m_k1.get_mpz_t(), m_k1.get_mpz_t());
+	}
+}
+
+void ContinuedFraction::apply(const Batch & batch, mpz_srcptr d, mpz_srcptr n, mpz_ptr td, mpz_ptr tn) {
+	//P^-1 = (-1)^count * [[p22, -p12], [-p21, p11]]
+	mpz_mul(td, batch.p22.get_mpz_t(), d);
+	mpz_submul(td, batch.p12.get_mpz_t(), n);
+	mpz_mul(tn, batch.p11.get_mpz_t(), n);
+	mpz_submul(tn, batch.p21.get_mpz_t(), d);
+	if (batch.odd()) {
+		mpz_neg(td, td);
+		mpz_neg(tn, tn);
+	}
+}
+
+void ContinuedFraction::undo(mpz_srcptr q, mpz_ptr d, mpz_ptr n) {
+	mpz_addmul(n, q, d);
+	mpz_swap(d, n);
+}
+
+void ContinuedFraction::wordBatch(mpz_srcptr x, mpz_srcptr y, mp_bitcnt_t targetBits, Batch & batch, mpz_class & tmp) {
+	mp_bitcnt_t xBits = bits(x);
+	mp_bitcnt_t shift = xBits > mp_bitcnt_t(word_bits) ? xBits - word_bits : 0;
+	mpz_tdiv_q_2exp(tmp.get_mpz_t(), x, shift);
+	unsigned long xh = mpz_get_ui(tmp.get_mpz_t());
+	mpz_tdiv_q_2exp(tmp.get_mpz_t(), y, shift);
+	unsigned long yh = mpz_get_ui(tmp.get_mpz_t());
+	//remainders of the leading bits are only meaningful as long as they are larger than the cofactors
+	int minBits = targetBits > shift ? int(std::min<mp_bitcnt_t>(targetBits - shift, word_bits)) : 0;
+	if (shift) {
+		minBits = std::max(minBits, word_bits/2);
+	}
+	//all entries are bounded by xh < 2^word_bits
+	unsigned long a11 = 1, a12 = 0, a21 = 0, a22 = 1;
+	while (bits(yh) > minBits) {
+		unsigned long q = xh / yh;
+		unsigned long r = xh - q*yh;
+		xh = yh;
+		yh = r;
+		unsigned long t = a11*q + a12;
+		a12 = a11;
+		a11 = t;
+		t = a21*q + a22;
+		a22 = a21;
+		a21 = t;
+		mpz_set_ui(tmp.get_mpz_t(), q);
+		if (batch.quotients.size() <= batch.count) {
+			batch.quotients.emplace_back();
+		}
+		mpz_swap(batch.quotients[batch.count].get_mpz_t(), tmp.get_mpz_t());
+		++batch.count;
+	}
+	//batch is empty, hence P = [[a11, a12], [a21, a22]]
+	assert(batch.count == 0 || (batch.p11 == 1 && batch.p12 == 0));
+	mpz_set_ui(batch.p11.get_mpz_t(), a11);
+	mpz_set_ui(batch.p12.get_mpz_t(), a12);
+	mpz_set_ui(batch.p21.get_mpz_t(), a21);
+	mpz_set_ui(batch.p22.get_mpz_t(), a22);
+}
+
+void ContinuedFraction::halfGcd(mpz_class & x, mpz_class & y, mp_bitcnt_t targetBits, Batch & batch) {
+	Batch sub;
+	mpz_class xs, ys, tx, ty, tmp1, tmp2;
+	while (bits(y.get_mpz_t()) > targetBits) {
+		mp_bitcnt_t xBits = bits(x.get_mpz_t());
+		sub.reset();
+		if (xBits > half_gcd_threshold) {
+			//reducing the leading t bits to t/2 bits reduces x by about t/2 bits
+			mp_bitcnt_t excess = bits(y.get_mpz_t()) - targetBits;
+			mp_bitcnt_t topBits = std::min<mp_bitcnt_t>(2*(excess + word_bits), 2*xBits/3);
+			mpz_tdiv_q_2exp(xs.get_mpz_t(), x.get_mpz_t(), xBits - topBits);
+			mpz_tdiv_q_2exp(ys.get_mpz_t(), y.get_mpz_t(), xBits - topBits);
+			halfGcd(xs, ys, topBits/2 + word_bits, sub);
+		}
+		else {
+			wordBatch(x.get_mpz_t(), y.get_mpz_t(), targetBits, sub, tmp1);
+		}
+		apply(sub, x.get_mpz_t(), y.get_mpz_t(), tx.get_mpz_t(), ty.get_mpz_t());
+		while (sub.count && !valid(tx.get_mpz_t(), ty.get_mpz_t())) {
+			undo(sub.back(), tx.get_mpz_t(), ty.get_mpz_t());
+			sub.pop();
+		}
+		if (sub.count) {
+			mpz_swap(x.get_mpz_t(), tx.get_mpz_t());
+			mpz_swap(y.get_mpz_t(), ty.get_mpz_t());
+			batch.append(sub, tmp1, tmp2);
+		}
+		else {
+			mpz_tdiv_qr(tmp1.get_mpz_t(), tmp2.get_mpz_t(), x.get_mpz_t(), y.get_mpz_t());
+			batch.push(tmp1.get_mpz_t());
+			mpz_swap(x.get_mpz_t(), y.get_mpz_t());
+			mpz_swap(y.get_mpz_t(), tmp2.get_mpz_t());
+		}
+	}
+}
+
+mp_bitcnt_t ContinuedFraction::batch(Engine engine, mp_bitcnt_t topBits) {
+	m_batch.reset();
+	mp_bitcnt_t dBits = bits(m_d.get_mpz_t());
+	topBits = std::min(topBits, dBits/2);
+	if (engine != CE_HALF_GCD || dBits <= half_gcd_threshold || topBits <= mp_bitcnt_t(word_bits)) {
+		topBits = 0;
+	}
+	if (topBits) {
+		mpz_tdiv_q_2exp(m_x.get_mpz_t(), m_d.get_mpz_t(), dBits - topBits);
+		mpz_tdiv_q_2exp(m_y.get_mpz_t(), m_n.get_mpz_t(), dBits - topBits);
+		halfGcd(m_x, m_y, topBits/2 + word_bits, m_batch);
+	}
+	else {
+		wordBatch(m_d.get_mpz_t(), m_n.get_mpz_t(), 0, m_batch, m_q);
+	}
+	apply(m_batch, m_d.get_mpz_t(), m_n.get_mpz_t(), m_td.get_mpz_t(), m_tn.get_mpz_t());
+	while (m_batch.count && !valid(m_td.get_mpz_t(), m_tn.get_mpz_t())) {
+		undo(m_batch.back(), m_td.get_mpz_t(), m_tn.get_mpz_t());
+		m_batch.pop();
+	}
+	return topBits;
+}
+
+void ContinuedFraction::convergents() {
+	//[[h1, h0], [k1, k0]]*P
+	mpz_mul(m_th1.get_mpz_t(), m_h1.get_mpz_t(), m_batch.p11.get_mpz_t());
+	mpz_addmul(m_th1.get_mpz_t(), m_h0.get_mpz_t(), m_batch.p21.get_mpz_t());
+	mpz_mul(m_th0.get_mpz_t(), m_h1.get_mpz_t(), m_batch.p12.get_mpz_t());
+	mpz_addmul(m_th0.get_mpz_t(), m_h0.get_mpz_t(), m_batch.p22.get_mpz_t());
+	mpz_mul(m_tk1.get_mpz_t(), m_k1.get_mpz_t(), m_batch.p11.get_mpz_t());
+	mpz_addmul(m_tk1.get_mpz_t(), m_k0.get_mpz_t(), m_batch.p21.get_mpz_t());
+	mpz_mul(m_tk0.get_mpz_t(), m_k1.get_mpz_t(), m_batch.p12.get_mpz_t());
+	mpz_addmul(m_tk0.get_mpz_t(), m_k0.get_mpz_t(), m_batch.p22.get_mpz_t());
+}
+
+void ContinuedFraction::swapTentative() {
+	mpz_swap(m_d.get_mpz_t(), m_td.get_mpz_t());
+	mpz_swap(m_n.get_mpz_t(), m_tn.get_mpz_t());
+	mpz_swap(m_h0.get_mpz_t(), m_th0.get_mpz_t());
+	mpz_swap(m_h1.get_mpz_t(), m_th1.get_mpz_t());
+	mpz_swap(m_k0.get_mpz_t(), m_tk0.get_mpz_t());
+	mpz_swap(m_k1.get_mpz_t(), m_tk1.get_mpz_t());
+}
+
+}} //end namespace LIB_RATSS_NAMESPACE::internal
+
+#endif
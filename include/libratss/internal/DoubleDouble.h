@@ -0,0 +1,225 @@
+#ifndef LIB_RATSS_INTERNAL_DOUBLE_DOUBLE_H
+#define LIB_RATSS_INTERNAL_DOUBLE_DOUBLE_H
+#pragma once
+
+#include <libratss/constants.h>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <mpreal/mpreal.h>
+
+namespace LIB_RATSS_NAMESPACE {
+namespace internal {
+
+///Unevaluated sum hi+lo of two doubles with abs(lo) <= ulp(hi)/2 which gives about 106 bits of precision.
+///The error free transformations are from Dekker: A floating-point technique for extending the available precision (1971),
+///addition and multiplication follow the QD library of Hida, Li and Bailey.
+///Every operation has a relative error of at most 2^-104.
+class DoubleDouble {
+public:
+	double hi;
+	double lo;
+public:
+	DoubleDouble() : hi(0), lo(0) {}
+	DoubleDouble(double hi) : hi(hi), lo(0) {}
+	DoubleDouble(double hi, double lo) : hi(hi), lo(lo) {}
+	///Rounds v to the nearest double-double
+	explicit inline DoubleDouble(const mpfr::mpreal & v);
+public:
+	///a+b exactly
+	static inline DoubleDouble twoSum(double a, double b);
+	///a+b exactly, abs(a) >= abs(b)
+	static inline DoubleDouble quickTwoSum(double a, double b);
+	///a*b exactly
+	static inline DoubleDouble twoProd(double a, double b);
+public:
+	inline DoubleDouble operator-() const { return DoubleDouble(-hi, -lo); }
+	inline DoubleDouble operator+(const DoubleDouble & other) const;
+	inline DoubleDouble operator-(const DoubleDouble & other) const { return *this + (-other); }
+	inline DoubleDouble operator*(const DoubleDouble & other) const;
+	inline DoubleDouble operator*(double other) const;
+	///Sets v to hi+lo rounded to the precision of v
+	inline void toMpreal(mpfr::mpreal & v) const;
+};
+
+///Sine and cosine of angles in degree in double-double arithmetic.
+///The argument reduction in degree is exact: the angle is split into a multiple of 90, an integral degree in [-45, 45]
+///and a remainder of at most half a degree. Sine and cosine of the integral degrees are tabulated,
+///the remainder is handled by a short Taylor series.
+class DegreeSinCos {
+public:
+	///Absolute error of sine and cosine is at most 2^-error_bits
+	static constexpr int error_bits = 101;
+public:
+	///@param deg finite
+	static inline void sinCos(double deg, DoubleDouble & s, DoubleDouble & c);
+private:
+	struct Table {
+		std::array<DoubleDouble, 46> sin;
+		std::array<DoubleDouble, 46> cos;
+		DoubleDouble degToRad;
+		//1/n! for n = 0, ..., 13
+		std::array<DoubleDouble, 14> invFactorial;
+		inline Table();
+	};
+	static inline const Table & table();
+};
+
+}} //end namespace LIB_RATSS_NAMESPACE::internal
+
+//definitions
+
+namespace LIB_RATSS_NAMESPACE {
+namespace internal {
+
+DoubleDouble DoubleDouble::twoSum(double a, double b) {
+	double s = a + b;
+	double bb = s - a;
+	double e = (a - (s - bb)) + (b - bb);
+	return DoubleDouble(s, e);
+}
+
+DoubleDouble DoubleDouble::quickTwoSum(double a, double b) {
+	double s = a + b;
+	double e = b - (s - a);
+	return DoubleDouble(s, e);
+}
+
+DoubleDouble DoubleDouble::twoProd(double a, double b) {
+	double p = a * b;
+#if defined(FP_FAST_FMA)
+	return DoubleDouble(p, std::fma(a, b, -p));
+#else
+	//Dekker's split into two halves of 26 bits
+	constexpr double splitter = 134217729.0; //2^27+1
+	double ta = splitter * a;
+	double ahi = ta - (ta - a);
+	double alo = a - ahi;
+	double tb = splitter * b;
+	double bhi = tb - (tb - b);
+	double blo = b - bhi;
+	return DoubleDouble(p, ((ahi*bhi - p) + ahi*blo + alo*bhi) + alo*blo);
+#endif
+}
+
+DoubleDouble DoubleDouble::operator+(const DoubleDouble & other) const {
+	DoubleDouble s = twoSum(hi, other.hi);
+	DoubleDouble t = twoSum(lo, other.lo);
+	s.lo += t.hi;
+	s = quickTwoSum(s.hi, s.lo);
+	s.lo += t.lo;
+	return quickTwoSum(s.hi, s.lo);
+}
+
+DoubleDouble DoubleDouble::operator*(const DoubleDouble & other) const {
+	DoubleDouble p = twoProd(hi, other.hi);
+	p.lo += hi * other.lo + lo * other.hi;
+	return quickTwoSum(p.hi, p.lo);
+}
+
+DoubleDouble DoubleDouble::operator*(double other) const {
+	DoubleDouble p = twoProd(hi, other);
+	p.lo += lo * other;
+	return quickTwoSum(p.hi, p.lo);
+}
+
+DoubleDouble::DoubleDouble(const mpfr::mpreal & v) :
+hi(mpfr_get_d(v.mpfr_srcptr(), MPFR_RNDN)),
+lo(0)
+{
+	if (std::isfinite(hi)) {
+		mpfr::mpreal rem(hi, v.getPrecision());
+		mpfr_sub(rem.mpfr_ptr(), v.mpfr_srcptr(), rem.mpfr_srcptr(), MPFR_RNDN);
+		lo = mpfr_get_d(rem.mpfr_srcptr(), MPFR_RNDN);
+	}
+}
+
+void DoubleDouble::toMpreal(mpfr::mpreal & v) const {
+	constexpr int digits = std::numeric_limits<double>::digits;
+	mp_limb_t limbs[(digits + GMP_NUMB_BITS - 1)/GMP_NUMB_BITS];
+	mpfr_t mplo;
+	mpfr_custom_init(limbs, digits);
+	mpfr_custom_init_set(mplo, MPFR_ZERO_KIND, 0, digits, limbs);
+	mpfr_set_d(mplo, lo, MPFR_RNDN);
+	//exact if v has at least 53 bits, hence there is only one rounding
+	mpfr_set_d(v.mpfr_ptr(), hi, MPFR_RNDN);
+	mpfr_add(v.mpfr_ptr(), v.mpfr_srcptr(), mplo, MPFR_RNDN);
+}
+
+DegreeSinCos::Table::Table() {
+	//correctly rounded values with plenty of guard bits, this is done once
+	constexpr int prec = 256;
+	mpfr::mpreal pi = mpfr::const_pi(prec);
+	mpfr::mpreal rad(0, prec);
+	for(int deg(0); deg < 46; ++deg) {
+		rad = pi * deg / 180;
+		sin[deg] = DoubleDouble(mpfr::sin(rad));
+		cos[deg] = DoubleDouble(mpfr::cos(rad));
+	}
+	degToRad = DoubleDouble(pi / 180);
+	mpfr::mpreal factorial(1, prec);
+	for(int n(0); n < 14; ++n) {
+		if (n) {
+			factorial *= n;
+		}
+		invFactorial[n] = DoubleDouble(1 / factorial);
+	}
+}
+
+const DegreeSinCos::Table & DegreeSinCos::table() {
+	static const Table t;
+	return t;
+}
+
+void DegreeSinCos::sinCos(double deg, DoubleDouble & s, DoubleDouble & c) {
+	const Table & t = table();
+	//deg = 90*quadrant + r with abs(r) <= 45, remquo is exact
+	int quadrant = 0;
+	double r = std::remquo(deg, 90.0, &quadrant);
+	//r = k + f with abs(f) <= 1/2, exact since f is a multiple of ulp(r)
+	double k = std::nearbyint(r);
+	double f = r - k;
+	int index = static_cast<int>(std::abs(k));
+	
+	//Horner scheme of the Taylor series of the remainder, abs(x) < 0.0088 and the first omitted terms are below 2^-130
+	DoubleDouble x = t.degToRad * f;
+	DoubleDouble x2 = x * x;
+	DoubleDouble sf = t.invFactorial[13];
+	DoubleDouble cf = t.invFactorial[12];
+	for(int n(11); n > 0; n -= 2) {
+		sf = t.invFactorial[n] - x2 * sf;
+		cf = t.invFactorial[n-1] - x2 * cf;
+	}
+	sf = sf * x;
+	
+	//sin(k+f) and cos(k+f) by the angle addition theorem, sin is odd
+	DoubleDouble sk = k < 0 ? -t.sin[index] : t.sin[index];
+	const DoubleDouble & ck = t.cos[index];
+	DoubleDouble sr = sk * cf + ck * sf;
+	DoubleDouble cr = ck * cf - sk * sf;
+	
+	//quadrant carries the sign of the quotient and its lowest bits, two's complement gives the residue modulo 4
+	switch (quadrant & 3) {
+	case 0:
+		s = sr;
+		c = cr;
+		break;
+	case 1:
+		s = cr;
+		c = -sr;
+		break;
+	case 2:
+		s = -sr;
+		c = -cr;
+		break;
+	default:
+		s = -cr;
+		c = sr;
+		break;
+	}
+}
+
+}} //end namespace LIB_RATSS_NAMESPACE::internal
+
+#endif
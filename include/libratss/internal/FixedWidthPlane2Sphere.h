@@ -0,0 +1,200 @@
+#ifndef LIB_RATSS_INTERNAL_FIXED_WIDTH_PLANE2SPHERE_H
+#define LIB_RATSS_INTERNAL_FIXED_WIDTH_PLANE2SPHERE_H
+#pragma once
+
+#include <libratss/constants.h>
+#include <libratss/enum.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <gmpxx.h>
+#include <utility>
+
+namespace LIB_RATSS_NAMESPACE {
+namespace internal {
+
+///ProjectSN::plane2Sphere for rational input using a signed integer type of fixed width (__int128_t by default).
+///With the common denominator D of the input x_i = a_i/D and N = D^2 + sum a_i^2 the result is
+///2*a_i*D/N for all coordinates except the projection coordinate which is +-(N - 2*D^2)/N.
+///Every operation is checked for overflow, in which case the caller has to use the general version.
+///Snapped points usually have small power of two denominators, hence this avoids almost all gmp arithmetic.
+template<typename T_INT = __int128_t>
+class FixedWidthPlane2Sphere {
+public:
+	using int_type = T_INT;
+	static_assert(sizeof(int_type) >= sizeof(long), "The fixed width integer type has to hold a long");
+public:
+	///@param tmp is used to assign the results to out
+	///@return false if an overflow occured, nothing was written to out in this case
+	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+	static bool run(T_INPUT_ITERATOR begin, const T_INPUT_ITERATOR & end, PositionOnSphere pos, T_OUTPUT_ITERATOR out, mpq_class & tmp);
+private:
+	static bool get(mpz_srcptr v, int_type & r);
+	static void set(int_type v, mpz_ptr r);
+	static int ctz(int_type v);
+	///a, b >= 0
+	static int_type gcd(int_type a, int_type b);
+	static inline int_type abs(int_type v) { return v < 0 ? -v : v; }
+	///sets tmp to num/den in canonical form, den > 0
+	static void setCanonical(int_type num, int_type den, mpq_class & tmp);
+};
+
+}}//end namespace LIB_RATSS_NAMESPACE::internal
+
+//definitions
+
+namespace LIB_RATSS_NAMESPACE {
+namespace internal {
+
+template<typename T_INT>
+template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+bool FixedWidthPlane2Sphere<T_INT>::run(T_INPUT_ITERATOR begin, const T_INPUT_ITERATOR & end, PositionOnSphere pos, T_OUTPUT_ITERATOR out, mpq_class & tmp) {
+	if (pos == SP_INVALID) {
+		return true;
+	}
+	int projCoord = std::abs((int) pos); //starts from 1
+	int_type num, den, g;
+	//common denominator
+	int_type D(1);
+	int i(1);
+	for(T_INPUT_ITERATOR it(begin); it != end; ++it, ++i) {
+		if (i == projCoord) {
+			continue;
+		}
+		if (!get((*it).get_den_mpz_t(), den)) {
+			return false;
+		}
+		g = gcd(D, den);
+		if (__builtin_mul_overflow(D/g, den, &D)) {
+			return false;
+		}
+	}
+	//N = D^2 + sum a_i^2 and the largest numerator of the output
+	int_type N, a, sq, maxA(0), twoD;
+	if (__builtin_mul_overflow(D, D, &N) || __builtin_add_overflow(D, D, &twoD)) {
+		return false;
+	}
+	i = 1;
+	for(T_INPUT_ITERATOR it(begin); it != end; ++it, ++i) {
+		if (i == projCoord) {
+			continue;
+		}
+		if (!get((*it).get_num_mpz_t(), num) || !get((*it).get_den_mpz_t(), den)) {
+			return false;
+		}
+		if (__builtin_mul_overflow(num, D/den, &a) ||
+			__builtin_mul_overflow(a, a, &sq) ||
+			__builtin_add_overflow(N, sq, &N))
+		{
+			return false;
+		}
+		maxA = std::max(maxA, abs(a));
+	}
+	if (__builtin_mul_overflow(maxA, twoD, &sq)) {
+		return false;
+	}
+	//everything fits, write the result
+	i = 1;
+	for(T_INPUT_ITERATOR it(begin); it != end; ++it, ++i, ++out) {
+		if (i == projCoord) {
+			//N >= D^2, hence this does not overflow
+			num = (N - D*D) - D*D;
+			if (!std::signbit<int>(pos)) {
+				num = -num;
+			}
+		}
+		else {
+			get((*it).get_num_mpz_t(), num);
+			get((*it).get_den_mpz_t(), den);
+			num = num * (D/den) * twoD;
+		}
+		setCanonical(num, N, tmp);
+		*out = tmp;
+	}
+	return true;
+}
+
+template<typename T_INT>
+bool FixedWidthPlane2Sphere<T_INT>::get(mpz_srcptr v, int_type & r) {
+	if (!mpz_fits_slong_p(v)) {
+		return false;
+	}
+	r = mpz_get_si(v);
+	return true;
+}
+
+template<typename T_INT>
+void FixedWidthPlane2Sphere<T_INT>::set(int_type v, mpz_ptr r) {
+	bool neg = v < 0;
+	int_type a = abs(v);
+	int_type high = (a >> 32) >> 32;
+	if (high) {
+		mpz_set_ui(r, static_cast<unsigned long>(static_cast<std::uint64_t>(high)));
+		mpz_mul_2exp(r, r, 64);
+		mpz_add_ui(r, r, static_cast<unsigned long>(static_cast<std::uint64_t>(a)));
+	}
+	else {
+		mpz_set_ui(r, static_cast<unsigned long>(static_cast<std::uint64_t>(a)));
+	}
+	if (neg) {
+		mpz_neg(r, r);
+	}
+}
+
+template<typename T_INT>
+int FixedWidthPlane2Sphere<T_INT>::ctz(int_type v) {
+	int result = 0;
+	while (!static_cast<std::uint64_t>(v)) {
+		v = (v >> 32) >> 32;
+		result += 64;
+	}
+	return result + __builtin_ctzll(static_cast<std::uint64_t>(v));
+}
+
+template<typename T_INT>
+typename FixedWidthPlane2Sphere<T_INT>::int_type
+FixedWidthPlane2Sphere<T_INT>::gcd(int_type a, int_type b) {
+	if (!a) {
+		return b;
+	}
+	if (!b) {
+		return a;
+	}
+	//most of the time both fit into 64 bits which is a lot faster
+	if (!((a | b) >> 32 >> 31)) {
+		std::uint64_t ua = static_cast<std::uint64_t>(a);
+		std::uint64_t ub = static_cast<std::uint64_t>(b);
+		int shift = __builtin_ctzll(ua | ub);
+		ua >>= __builtin_ctzll(ua);
+		while (ub) {
+			ub >>= __builtin_ctzll(ub);
+			if (ua > ub) {
+				std::swap(ua, ub);
+			}
+			ub -= ua;
+		}
+		return int_type(ua << shift);
+	}
+	int shift = ctz(a | b);
+	a >>= ctz(a);
+	while (b) {
+		b >>= ctz(b);
+		if (a > b) {
+			std::swap(a, b);
+		}
+		b -= a;
+	}
+	return a << shift;
+}
+
+template<typename T_INT>
+void FixedWidthPlane2Sphere<T_INT>::setCanonical(int_type num, int_type den, mpq_class & tmp) {
+	int_type g = gcd(abs(num), den);
+	set(num/g, tmp.get_num_mpz_t());
+	set(den/g, tmp.get_den_mpz_t());
+}
+
+}}//end namespace LIB_RATSS_NAMESPACE::internal
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef LIB_RATSS_INTERNAL_FIXPOINT_FAST_H
+#define LIB_RATSS_INTERNAL_FIXPOINT_FAST_H
+#pragma once
+
+#include <libratss/constants.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <gmpxx.h>
+#include <mpreal/mpreal.h>
+
+namespace LIB_RATSS_NAMESPACE {
+namespace internal {
+
+///Fixpoint snapping of abs(v) < 1 with machine integers.
+///The snapped value is trunc(v*2^significands)/2^significands which is exactly
+///what Calc::toFixpoint followed by Conversion<mpfr::mpreal>::toMpq computes.
+///Since significands <= 52 the numerator always fits into an int64.
+class FixpointFast {
+public:
+	static constexpr int max_significands = 52;
+public:
+	///@return true if the fast path handles significands
+	static inline bool applicable(int significands) {
+		return 0 < significands && significands <= max_significands && sizeof(long) >= sizeof(std::int64_t);
+	}
+	///@param v abs(v) < 1 holds if exp <= 0, v is finite
+	///@param exp exponent of v such that v = m*2^exp with 1/2 <= abs(m) < 1
+	///@return false if the general path has to be used
+	static inline bool numerator(double v, long exp, int significands, std::int64_t & num) {
+		if (!applicable(significands) || exp > 0) {
+			return false;
+		}
+		if (v == 0 || -exp > significands) {
+			num = 0;
+			return true;
+		}
+		//Calc::toFixpoint keeps a rounded mantissa bit if no bit remains, leave this case to it
+		if (-exp == significands) {
+			return false;
+		}
+		//abs(v*2^significands) < 2^52, the conversion truncates towards zero
+		num = static_cast<std::int64_t>(std::ldexp(v, significands));
+		return true;
+	}
+	///@return false if the general path has to be used
+	static inline bool numerator(double v, int significands, std::int64_t & num) {
+		if (!std::isfinite(v)) {
+			return false;
+		}
+		int exp = 0;
+		std::frexp(v, &exp);
+		return numerator(v, exp, significands, num);
+	}
+	///@return false if the general path has to be used
+	static inline bool numerator(const mpfr::mpreal & v, int significands, std::int64_t & num) {
+		if (!applicable(significands) || !mpfr_number_p(v.mpfr_srcptr())) {
+			return false;
+		}
+		if (mpfr_zero_p(v.mpfr_srcptr())) {
+			num = 0;
+			return true;
+		}
+		long exp = mpfr_get_exp(v.mpfr_srcptr());
+		if (exp > 0) {
+			return false;
+		}
+		if (-exp > significands) {
+			num = 0;
+			return true;
+		}
+		//truncating to 53 bits first does not change trunc(v*2^significands) since significands+exp < 53
+		return numerator(mpfr_get_d(v.mpfr_srcptr(), MPFR_RNDZ), exp, significands, num);
+	}
+	///Sets result to the canonical form of num/2^significands
+	static inline void toMpq(std::int64_t num, int significands, mpq_class & result) {
+		if (num == 0) {
+			mpq_set_ui(result.get_mpq_t(), 0, 1);
+			return;
+		}
+		std::uint64_t absNum = num < 0 ? -static_cast<std::uint64_t>(num) : static_cast<std::uint64_t>(num);
+		int shift = std::min<int>(__builtin_ctzll(absNum), significands);
+		mpz_set_si(result.get_num_mpz_t(), num / (std::int64_t(1) << shift));
+		mpz_set_ui(result.get_den_mpz_t(), 1);
+		mpz_mul_2exp(result.get_den_mpz_t(), result.get_den_mpz_t(), significands - shift);
+	}
+	///@return false if the general path has to be used, result is untouched in this case
+	template<typename T_FT>
+	static inline bool snap(const T_FT & v, int significands, mpq_class & result) {
+		std::int64_t num;
+		if (!numerator(v, significands, num)) {
+			return false;
+		}
+		toMpq(num, significands, result);
+		return true;
+	}
+};
+
+}}//end namespace LIB_RATSS_NAMESPACE::internal
+
+#endif
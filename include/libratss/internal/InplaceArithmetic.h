@@ -0,0 +1,129 @@
+#ifndef LIB_RATSS_INTERNAL_INPLACE_ARITHMETIC_H
+#define LIB_RATSS_INTERNAL_INPLACE_ARITHMETIC_H
+#pragma once
+
+#include <libratss/constants.h>
+
+#include <algorithm>
+#include <cmath>
+#include <gmpxx.h>
+#include <mpreal/mpreal.h>
+
+namespace LIB_RATSS_NAMESPACE {
+namespace internal {
+
+//Arithmetic that writes into an existing result object instead of returning temporaries.
+//The results are identical to the ones of the corresponding operators:
+//for mpfr::mpreal the result has the precision the operator would choose,
+//storage is only reallocated if that precision needs more limbs than r currently has.
+//r may alias any of the arguments.
+
+template<typename T>
+inline void assign(T & r, const T & a) { r = a; }
+
+template<typename T>
+inline void setInt(T & r, long v) { r = T(v); }
+
+template<typename T>
+inline void add(T & r, const T & a, const T & b) { r = a + b; }
+
+template<typename T>
+inline void sub(T & r, const T & a, const T & b) { r = a - b; }
+
+template<typename T>
+inline void mul(T & r, const T & a, const T & b) { r = a * b; }
+
+template<typename T>
+inline void div(T & r, const T & a, const T & b) { r = a / b; }
+
+template<typename T>
+inline void neg(T & r, const T & a) { r = -a; }
+
+template<typename T>
+inline void sqrt(T & r, const T & a) {
+	using std::sqrt;
+	r = sqrt(a);
+}
+
+//BEGIN mpq_class
+
+inline void assign(mpq_class & r, const mpq_class & a) { ::mpq_set(r.get_mpq_t(), a.get_mpq_t()); }
+
+inline void setInt(mpq_class & r, long v) { ::mpq_set_si(r.get_mpq_t(), v, 1); }
+
+inline void add(mpq_class & r, const mpq_class & a, const mpq_class & b) { ::mpq_add(r.get_mpq_t(), a.get_mpq_t(), b.get_mpq_t()); }
+
+inline void sub(mpq_class & r, const mpq_class & a, const mpq_class & b) { ::mpq_sub(r.get_mpq_t(), a.get_mpq_t(), b.get_mpq_t()); }
+
+inline void mul(mpq_class & r, const mpq_class & a, const mpq_class & b) { ::mpq_mul(r.get_mpq_t(), a.get_mpq_t(), b.get_mpq_t()); }
+
+inline void div(mpq_class & r, const mpq_class & a, const mpq_class & b) { ::mpq_div(r.get_mpq_t(), a.get_mpq_t(), b.get_mpq_t()); }
+
+inline void neg(mpq_class & r, const mpq_class & a) { ::mpq_neg(r.get_mpq_t(), a.get_mpq_t()); }
+
+//END mpq_class
+//BEGIN mpfr::mpreal
+
+///Sets the precision of r to prec, keeps the value of r if it aliases one of the operands
+inline void setPrecision(mpfr::mpreal & r, mpfr_prec_t prec, bool keepValue) {
+	if (mpfr_get_prec(r.mpfr_srcptr()) != prec) {
+		if (keepValue) {
+			mpfr_prec_round(r.mpfr_ptr(), prec, mpfr::mpreal::get_default_rnd());
+		}
+		else {
+			mpfr_set_prec(r.mpfr_ptr(), prec);
+		}
+	}
+}
+
+inline void setPrecision(mpfr::mpreal & r, const mpfr::mpreal & a, const mpfr::mpreal & b) {
+	setPrecision(r, std::max(mpfr_get_prec(a.mpfr_srcptr()), mpfr_get_prec(b.mpfr_srcptr())), &r == &a || &r == &b);
+}
+
+inline void assign(mpfr::mpreal & r, const mpfr::mpreal & a) {
+	if (&r != &a) {
+		setPrecision(r, mpfr_get_prec(a.mpfr_srcptr()), false);
+		mpfr_set(r.mpfr_ptr(), a.mpfr_srcptr(), mpfr::mpreal::get_default_rnd());
+	}
+}
+
+inline void setInt(mpfr::mpreal & r, long v) {
+	setPrecision(r, mpfr::mpreal::get_default_prec(), false);
+	mpfr_set_si(r.mpfr_ptr(), v, mpfr::mpreal::get_default_rnd());
+}
+
+inline void add(mpfr::mpreal & r, const mpfr::mpreal & a, const mpfr::mpreal & b) {
+	setPrecision(r, a, b);
+	mpfr_add(r.mpfr_ptr(), a.mpfr_srcptr(), b.mpfr_srcptr(), mpfr::mpreal::get_default_rnd());
+}
+
+inline void sub(mpfr::mpreal & r, const mpfr::mpreal & a, const mpfr::mpreal & b) {
+	setPrecision(r, a, b);
+	mpfr_sub(r.mpfr_ptr(), a.mpfr_srcptr(), b.mpfr_srcptr(), mpfr::mpreal::get_default_rnd());
+}
+
+inline void mul(mpfr::mpreal & r, const mpfr::mpreal & a, const mpfr::mpreal & b) {
+	setPrecision(r, a, b);
+	mpfr_mul(r.mpfr_ptr(), a.mpfr_srcptr(), b.mpfr_srcptr(), mpfr::mpreal::get_default_rnd());
+}
+
+inline void div(mpfr::mpreal & r, const mpfr::mpreal & a, const mpfr::mpreal & b) {
+	setPrecision(r, a, b);
+	mpfr_div(r.mpfr_ptr(), a.mpfr_srcptr(), b.mpfr_srcptr(), mpfr::mpreal::get_default_rnd());
+}
+
+inline void neg(mpfr::mpreal & r, const mpfr::mpreal & a) {
+	setPrecision(r, mpfr_get_prec(a.mpfr_srcptr()), &r == &a);
+	mpfr_neg(r.mpfr_ptr(), a.mpfr_srcptr(), mpfr::mpreal::get_default_rnd());
+}
+
+inline void sqrt(mpfr::mpreal & r, const mpfr::mpreal & a) {
+	setPrecision(r, mpfr_get_prec(a.mpfr_srcptr()), &r == &a);
+	mpfr_sqrt(r.mpfr_ptr(), a.mpfr_srcptr(), mpfr::mpreal::get_default_rnd());
+}
+
+//END mpfr::mpreal
+
+}}//end namespace LIB_RATSS_NAMESPACE::internal
+
+#endif
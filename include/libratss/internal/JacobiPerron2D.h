@@ -0,0 +1,302 @@
+#ifndef LIB_RATSS_INTERNAL_JACOBI_PERRON_2D_H
+#define LIB_RATSS_INTERNAL_JACOBI_PERRON_2D_H
+#pragma once
+
+#include <libratss/constants.h>
+#include <libratss/enum.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <gmpxx.h>
+
+namespace LIB_RATSS_NAMESPACE {
+namespace internal {
+
+///The Jacobi-Perron iteration of Calc::jacobiPerron2D for input1, input2 in [0, 1].
+///Both inputs are kept as integer vector (x0, x1, x2) with alpha = x1/x0 and beta = x2/x0,
+///hence a step is two integer divisions instead of rational arithmetic:
+///(x0, x1, x2) -> (x1, x2 mod x1, x0 mod x1) with a = x0 div x1 and b = x2 div x1.
+///The iteration matrix M is multiplied in place by the step matrix, which only changes its first column.
+///Since input = M*x holds after every step and all entries are non-negative, no entry of M or x exceeds the input.
+///Hence the iteration runs on std::int64_t if the common denominator fits and only the errors need 128 bits,
+///otherwise it runs on mpz_class without temporaries.
+///The result is exactly the one of the rational iteration.
+class JacobiPerron2D {
+public:
+	///input1, input2 in [0, 1], the machine word or mpz_class stage is chosen here
+	JacobiPerron2D(const mpq_class & input1, const mpq_class & input2);
+public:
+	///Iterates until the approximation satisfies mode, which is either ST_GUARANTEE_DISTANCE or ST_GUARANTEE_SIZE, or alpha becomes 0.
+	///For ST_GUARANTEE_DISTANCE output1, output2 are set to the last approximation,
+	///for ST_GUARANTEE_SIZE to the closest approximation whose denominators are at most 2^significands.
+	///Outputs are not touched if there was no step.
+	///@return true if alpha became 0, like Calc::jacobiPerron2D the caller should fall back to continued fractions
+	bool run(int significands, int mode, mpq_class & output1, mpq_class & output2);
+public:
+	inline std::size_t steps() const { return m_steps; }
+	///@return true if the iteration runs on machine words
+	inline bool machineWords() const { return m_fits; }
+private:
+	using int_type = std::int64_t;
+	using wide_type = __int128_t;
+	using uwide_type = __uint128_t;
+	///Row r of the iteration matrix is (m[r][0], m[r][1], m[r][2]), the approximation is m[1][0]/m[0][0], m[2][0]/m[0][0]
+	struct MachineState {
+		int_type x[3];
+		int_type input[3];
+		int_type m[3][3];
+	};
+	struct GmpState {
+		mpz_class x[3];
+		mpz_class input[3];
+		mpz_class m[3][3];
+		mpz_class a, b, r0, r2;
+	};
+	typedef enum {CR_CONTINUE, CR_DONE, CR_BETTER} CheckResult;
+private:
+	void runMachine(int significands, int mode, mpq_class & output1, mpq_class & output2);
+	void runGmp(int significands, int mode, mpq_class & output1, mpq_class & output2);
+	CheckResult checkMachine(int significands, int mode);
+	CheckResult checkGmp(int significands, int mode);
+	///best = max(abs(e1), abs(e2))/d with minimal best so far
+	bool better(const mpz_class & e1, const mpz_class & e2, const mpz_class & d);
+	static void set(uwide_type v, mpz_class & r);
+	static void set(wide_type v, mpz_class & r);
+	static inline uwide_type abs(wide_type v) { return v < 0 ? uwide_type(-v) : uwide_type(v); }
+private:
+	MachineState m_ms;
+	GmpState m_gs;
+	//best distance for ST_GUARANTEE_SIZE as fraction
+	mpz_class m_bestNum;
+	mpz_class m_bestDen;
+	mpz_class m_t0, m_t1, m_t2;
+	bool m_fits;
+	std::size_t m_steps;
+};
+
+}}//end namespace LIB_RATSS_NAMESPACE::internal
+
+//definitions
+
+namespace LIB_RATSS_NAMESPACE {
+namespace internal {
+
+inline JacobiPerron2D::JacobiPerron2D(const mpq_class & input1, const mpq_class & input2) :
+m_bestNum(1),
+m_bestDen(1),
+m_fits(true),
+m_steps(0)
+{
+	//common denominator
+	mpz_lcm(m_gs.input[0].get_mpz_t(), input1.get_den_mpz_t(), input2.get_den_mpz_t());
+	mpz_divexact(m_gs.input[1].get_mpz_t(), m_gs.input[0].get_mpz_t(), input1.get_den_mpz_t());
+	m_gs.input[1] *= input1.get_num();
+	mpz_divexact(m_gs.input[2].get_mpz_t(), m_gs.input[0].get_mpz_t(), input2.get_den_mpz_t());
+	m_gs.input[2] *= input2.get_num();
+	//input1, input2 <= 1, hence all entries of x stay below input[0]
+	m_fits = mpz_fits_slong_p(m_gs.input[0].get_mpz_t()) && sizeof(long) >= sizeof(int_type);
+	for(int i(0); i < 3; ++i) {
+		for(int j(0); j < 3; ++j) {
+			m_ms.m[i][j] = (i == j);
+			m_gs.m[i][j] = (i == j);
+		}
+		m_gs.x[i] = m_gs.input[i];
+		if (m_fits) {
+			m_ms.input[i] = mpz_get_si(m_gs.input[i].get_mpz_t());
+			m_ms.x[i] = m_ms.input[i];
+		}
+	}
+}
+
+inline bool JacobiPerron2D::run(int significands, int mode, mpq_class & output1, mpq_class & output2) {
+	if (m_fits) {
+		runMachine(significands, mode, output1, output2);
+		return m_ms.x[1] == 0;
+	}
+	runGmp(significands, mode, output1, output2);
+	return m_gs.x[1] == 0;
+}
+
+inline void JacobiPerron2D::runMachine(int significands, int mode, mpq_class & output1, mpq_class & output2) {
+	MachineState & s = m_ms;
+	while (s.x[1] != 0) {
+		int_type a = s.x[0] / s.x[1];
+		int_type b = s.x[2] / s.x[1];
+		//(m0, m1, m2) -> (a*m0 + m1 + b*m2, m2, m0), the new m0 is at most input[r] since input = M*x
+		for(int r(0); r < 3; ++r) {
+			int_type m0 = s.m[r][0];
+			assert(wide_type(a)*m0 + s.m[r][1] + wide_type(b)*s.m[r][2] <= s.input[r]);
+			s.m[r][0] = a*m0 + s.m[r][1] + b*s.m[r][2];
+			s.m[r][1] = s.m[r][2];
+			s.m[r][2] = m0;
+		}
+		int_type x0 = s.x[0];
+		s.x[0] = s.x[1];
+		s.x[1] = s.x[2] - b*s.x[0];
+		s.x[2] = x0 - a*s.x[0];
+		++m_steps;
+
+		CheckResult cr = checkMachine(significands, mode);
+		if (cr == CR_BETTER || ((mode & ST_GUARANTEE_DISTANCE) && cr == CR_DONE)) {
+			mpq_set_si(output1.get_mpq_t(), s.m[1][0], s.m[0][0]);
+			mpq_set_si(output2.get_mpq_t(), s.m[2][0], s.m[0][0]);
+			output1.canonicalize();
+			output2.canonicalize();
+		}
+		if (cr == CR_DONE) {
+			return;
+		}
+	}
+	if ((mode & ST_GUARANTEE_DISTANCE) && m_steps) {
+		mpq_set_si(output1.get_mpq_t(), s.m[1][0], s.m[0][0]);
+		mpq_set_si(output2.get_mpq_t(), s.m[2][0], s.m[0][0]);
+		output1.canonicalize();
+		output2.canonicalize();
+	}
+}
+
+inline JacobiPerron2D::CheckResult JacobiPerron2D::checkMachine(int significands, int mode) {
+	const MachineState & s = m_ms;
+	int_type q = s.m[0][0];
+	int_type p1 = s.m[1][0];
+	int_type p2 = s.m[2][0];
+	//p_i/q - input_i = e_i/(q*input_0)
+	wide_type e1 = wide_type(p1)*s.input[0] - wide_type(s.input[1])*q;
+	wide_type e2 = wide_type(p2)*s.input[0] - wide_type(s.input[2])*q;
+	uwide_type d = uwide_type(q)*uwide_type(s.input[0]);
+	if (mode & ST_GUARANTEE_DISTANCE) {
+		//abs(e_i)/d <= 2^-significands, abs(e_i) is an integer hence we may round d*2^-significands down
+		uwide_type bound = significands < 128 ? d >> significands : 0;
+		return abs(e1) <= bound && abs(e2) <= bound ? CR_DONE : CR_CONTINUE;
+	}
+	else if (mode & ST_GUARANTEE_SIZE) {
+		//denominators in canonical form
+		int_type d1 = q / std::gcd(p1, q);
+		int_type d2 = q / std::gcd(p2, q);
+		if (significands < 63 && std::max(d1, d2) > (int_type(1) << significands)) {
+			return CR_DONE;
+		}
+		set(e1, m_t0);
+		set(e2, m_t1);
+		set(d, m_t2);
+		return better(m_t0, m_t1, m_t2) ? CR_BETTER : CR_CONTINUE;
+	}
+	return CR_CONTINUE;
+}
+
+inline void JacobiPerron2D::runGmp(int significands, int mode, mpq_class & output1, mpq_class & output2) {
+	GmpState & s = m_gs;
+	while (s.x[1] != 0) {
+		mpz_fdiv_qr(s.a.get_mpz_t(), s.r0.get_mpz_t(), s.x[0].get_mpz_t(), s.x[1].get_mpz_t());
+		mpz_fdiv_qr(s.b.get_mpz_t(), s.r2.get_mpz_t(), s.x[2].get_mpz_t(), s.x[1].get_mpz_t());
+		//(m0, m1, m2) -> (a*m0 + m1 + b*m2, m2, m0)
+		for(int r(0); r < 3; ++r) {
+			mpz_addmul(s.m[r][1].get_mpz_t(), s.a.get_mpz_t(), s.m[r][0].get_mpz_t());
+			mpz_addmul(s.m[r][1].get_mpz_t(), s.b.get_mpz_t(), s.m[r][2].get_mpz_t());
+			mpz_swap(s.m[r][0].get_mpz_t(), s.m[r][1].get_mpz_t());
+			mpz_swap(s.m[r][1].get_mpz_t(), s.m[r][2].get_mpz_t());
+		}
+		//(x0, x1, x2) -> (x1, x2 mod x1, x0 mod x1)
+		mpz_swap(s.x[0].get_mpz_t(), s.x[1].get_mpz_t());
+		mpz_swap(s.x[1].get_mpz_t(), s.r2.get_mpz_t());
+		mpz_swap(s.x[2].get_mpz_t(), s.r0.get_mpz_t());
+		++m_steps;
+
+		CheckResult cr = checkGmp(significands, mode);
+		if (cr == CR_BETTER || ((mode & ST_GUARANTEE_DISTANCE) && cr == CR_DONE)) {
+			mpq_set_num(output1.get_mpq_t(), s.m[1][0].get_mpz_t());
+			mpq_set_den(output1.get_mpq_t(), s.m[0][0].get_mpz_t());
+			mpq_set_num(output2.get_mpq_t(), s.m[2][0].get_mpz_t());
+			mpq_set_den(output2.get_mpq_t(), s.m[0][0].get_mpz_t());
+			output1.canonicalize();
+			output2.canonicalize();
+		}
+		if (cr == CR_DONE) {
+			return;
+		}
+	}
+	if ((mode & ST_GUARANTEE_DISTANCE) && m_steps) {
+		mpq_set_num(output1.get_mpq_t(), s.m[1][0].get_mpz_t());
+		mpq_set_den(output1.get_mpq_t(), s.m[0][0].get_mpz_t());
+		mpq_set_num(output2.get_mpq_t(), s.m[2][0].get_mpz_t());
+		mpq_set_den(output2.get_mpq_t(), s.m[0][0].get_mpz_t());
+		output1.canonicalize();
+		output2.canonicalize();
+	}
+}
+
+inline JacobiPerron2D::CheckResult JacobiPerron2D::checkGmp(int significands, int mode) {
+	const GmpState & s = m_gs;
+	const mpz_class & q = s.m[0][0];
+	//p_i/q - input_i = e_i/(q*input_0)
+	m_t0 = s.m[1][0]*s.input[0] - s.input[1]*q;
+	m_t1 = s.m[2][0]*s.input[0] - s.input[2]*q;
+	m_t2 = q*s.input[0];
+	if (mode & ST_GUARANTEE_DISTANCE) {
+		mpz_abs(m_t0.get_mpz_t(), m_t0.get_mpz_t());
+		mpz_abs(m_t1.get_mpz_t(), m_t1.get_mpz_t());
+		mpz_mul_2exp(m_t0.get_mpz_t(), m_t0.get_mpz_t(), significands);
+		mpz_mul_2exp(m_t1.get_mpz_t(), m_t1.get_mpz_t(), significands);
+		return m_t0 <= m_t2 && m_t1 <= m_t2 ? CR_DONE : CR_CONTINUE;
+	}
+	else if (mode & ST_GUARANTEE_SIZE) {
+		//denominators in canonical form, a, b, r0 and r2 are scratch space until the next step
+		GmpState & gs = m_gs;
+		mpz_gcd(gs.a.get_mpz_t(), s.m[1][0].get_mpz_t(), q.get_mpz_t());
+		mpz_divexact(gs.a.get_mpz_t(), q.get_mpz_t(), gs.a.get_mpz_t());
+		mpz_gcd(gs.b.get_mpz_t(), s.m[2][0].get_mpz_t(), q.get_mpz_t());
+		mpz_divexact(gs.b.get_mpz_t(), q.get_mpz_t(), gs.b.get_mpz_t());
+		if (gs.a < gs.b) {
+			mpz_swap(gs.a.get_mpz_t(), gs.b.get_mpz_t());
+		}
+		mpz_set_ui(gs.r0.get_mpz_t(), 1);
+		mpz_mul_2exp(gs.r0.get_mpz_t(), gs.r0.get_mpz_t(), significands);
+		if (gs.a > gs.r0) {
+			return CR_DONE;
+		}
+		return better(m_t0, m_t1, m_t2) ? CR_BETTER : CR_CONTINUE;
+	}
+	return CR_CONTINUE;
+}
+
+inline bool JacobiPerron2D::better(const mpz_class & e1, const mpz_class & e2, const mpz_class & d) {
+	const mpz_class & e = mpz_cmpabs(e1.get_mpz_t(), e2.get_mpz_t()) >= 0 ? e1 : e2;
+	//abs(e)/d < bestNum/bestDen
+	mpz_class & lhs = m_gs.r2;
+	mpz_class & rhs = m_gs.r0;
+	mpz_mul(lhs.get_mpz_t(), e.get_mpz_t(), m_bestDen.get_mpz_t());
+	mpz_abs(lhs.get_mpz_t(), lhs.get_mpz_t());
+	mpz_mul(rhs.get_mpz_t(), m_bestNum.get_mpz_t(), d.get_mpz_t());
+	if (lhs < rhs) {
+		mpz_abs(m_bestNum.get_mpz_t(), e.get_mpz_t());
+		m_bestDen = d;
+		return true;
+	}
+	return false;
+}
+
+inline void JacobiPerron2D::set(uwide_type v, mpz_class & r) {
+	std::uint64_t high = std::uint64_t(v >> 64);
+	if (high) {
+		mpz_set_ui(r.get_mpz_t(), static_cast<unsigned long>(high));
+		mpz_mul_2exp(r.get_mpz_t(), r.get_mpz_t(), 64);
+		mpz_add_ui(r.get_mpz_t(), r.get_mpz_t(), static_cast<unsigned long>(std::uint64_t(v)));
+	}
+	else {
+		mpz_set_ui(r.get_mpz_t(), static_cast<unsigned long>(std::uint64_t(v)));
+	}
+}
+
+inline void JacobiPerron2D::set(wide_type v, mpz_class & r) {
+	set(abs(v), r);
+	if (v < 0) {
+		mpz_neg(r.get_mpz_t(), r.get_mpz_t());
+	}
+}
+
+}}//end namespace LIB_RATSS_NAMESPACE::internal
+
+#endif
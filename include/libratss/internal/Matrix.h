@@ -4,6 +4,10 @@
 
 #include <libratss/constants.h>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <gmpxx.h>
 
 namespace LIB_RATSS_NAMESPACE {
 namespace internal {
@@ -23,10 +27,19 @@ public:
 	
 	value_type & operator()(std::size_t row, std::size_t column);
 	const value_type & operator()(std::size_t row, std::size_t column) const;
+	void swap(Matrix & other);
 public:
 	static Matrix identity(std::size_t dimension);
+	///out = a*b without temporaries, out keeps its storage if it already has the dimension of a
+	///For mpz_class every entry is computed with mpz_mul and mpz_addmul, dimensions 2, 3 and 4 have unrolled kernels
+	///@param out must be different from a and b
+	static void multiplyInto(Matrix & out, const Matrix & a, const Matrix & b);
 public:
 	inline std::size_t dimension() const { return m_dimension; }
+private:
+	template<std::size_t T_DIMENSION>
+	static void multiplyMpz(mpz_class * out, const mpz_class * a, const mpz_class * b);
+	static void multiplyMpz(mpz_class * out, const mpz_class * a, const mpz_class * b, std::size_t dimension);
 private:
 	std::size_t m_dimension;
 	std::vector<TVALUE> m_d;
@@ -59,6 +72,7 @@ Matrix<TVALUE> &
 Matrix<TVALUE>::operator=(const Matrix & other) {
 	m_dimension = other.m_dimension;
 	m_d = other.m_d;
+	return *this;
 }
 
 template<typename TVALUE>
@@ -77,21 +91,85 @@ template<typename TVALUE>
 Matrix<TVALUE>
 Matrix<TVALUE>::operator*(const Matrix<TVALUE> & right) const
 {
-	if (dimension() != right.dimension()) {
+	Matrix result(dimension());
+	multiplyInto(result, *this, right);
+	return result;
+}
+
+template<typename TVALUE>
+void
+Matrix<TVALUE>::multiplyInto(Matrix & out, const Matrix & a, const Matrix & b)
+{
+	if (a.dimension() != b.dimension()) {
 		throw std::domain_error("ratss::internal::Matrix: multipyling matrices of different dimensions is not supported");
 	}
+	if (&out == &a || &out == &b) {
+		throw std::domain_error("ratss::internal::Matrix::multiplyInto: out must not be an operand");
+	}
+	const std::size_t n = a.dimension();
+	if (out.dimension() != n) {
+		out.m_dimension = n;
+		out.m_d.resize(n*n);
+	}
+	if constexpr (std::is_same<TVALUE, mpz_class>::value) {
+		switch (n) {
+		case 2:
+			multiplyMpz<2>(out.m_d.data(), a.m_d.data(), b.m_d.data());
+			break;
+		case 3:
+			multiplyMpz<3>(out.m_d.data(), a.m_d.data(), b.m_d.data());
+			break;
+		case 4:
+			multiplyMpz<4>(out.m_d.data(), a.m_d.data(), b.m_d.data());
+			break;
+		default:
+			multiplyMpz(out.m_d.data(), a.m_d.data(), b.m_d.data(), n);
+			break;
+		}
+	}
+	else {
+		for(std::size_t row(0); row < n; ++row) {
+			for(std::size_t col(0); col < n; ++col) {
+				value_type & v = out.m_d[n*row+col];
+				v = value_type(0);
+				for(std::size_t k(0); k < n; ++k) {
+					v += a.m_d[n*row+k] * b.m_d[n*k+col];
+				}
+			}
+		}
+	}
+}
 
-	Matrix result(dimension());
-	const Matrix & left = *this;
+template<typename TVALUE>
+template<std::size_t T_DIMENSION>
+void
+Matrix<TVALUE>::multiplyMpz(mpz_class * out, const mpz_class * a, const mpz_class * b)
+{
+	//the compiler unrolls all loops for a fixed dimension
+	for(std::size_t row(0); row < T_DIMENSION; ++row) {
+		for(std::size_t col(0); col < T_DIMENSION; ++col) {
+			mpz_ptr v = out[T_DIMENSION*row+col].get_mpz_t();
+			mpz_mul(v, a[T_DIMENSION*row].get_mpz_t(), b[col].get_mpz_t());
+			for(std::size_t k(1); k < T_DIMENSION; ++k) {
+				mpz_addmul(v, a[T_DIMENSION*row+k].get_mpz_t(), b[T_DIMENSION*k+col].get_mpz_t());
+			}
+		}
+	}
+}
 
-	for(std::size_t row(0); row < dimension(); ++row) {
-		for(std::size_t col(0); col < dimension(); ++col) {
-			for(std::size_t k(0); k < dimension(); ++k) {
-				result(row, col) += left(row, k) * right(k, col);
+template<typename TVALUE>
+void
+Matrix<TVALUE>::multiplyMpz(mpz_class * out, const mpz_class * a, const mpz_class * b, std::size_t dimension)
+{
+	for(std::size_t row(0); row < dimension; ++row) {
+		for(std::size_t col(0); col < dimension; ++col) {
+			mpz_ptr v = out[dimension*row+col].get_mpz_t();
+			mpz_mul(v, a[dimension*row].get_mpz_t(), b[col].get_mpz_t());
+			for(std::size_t k(1); k < dimension; ++k) {
+				mpz_addmul(v, a[dimension*row+k].get_mpz_t(), b[dimension*k+col].get_mpz_t());
 			}
 		}
 	}
-	return result;
 }
 
 template<typename TVALUE>
@@ -108,6 +186,14 @@ Matrix<TVALUE>::operator()(std::size_t row, std::size_t column) const
 	return m_d.at(dimension()*row+column);
 }
 
+template<typename TVALUE>
+void
+Matrix<TVALUE>::swap(Matrix & other)
+{
+	std::swap(m_dimension, other.m_dimension);
+	m_d.swap(other.m_d);
+}
+
 template<typename TVALUE>
 Matrix<TVALUE>
 Matrix<TVALUE>::identity(std::size_t dimension)
@@ -0,0 +1,129 @@
+#ifndef LIB_RATSS_INTERNAL_SPHERE_TO_PLANE_BATCH_H
+#define LIB_RATSS_INTERNAL_SPHERE_TO_PLANE_BATCH_H
+#pragma once
+
+#include <libratss/constants.h>
+
+#include <cmath>
+#include <cstddef>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+	#include <immintrin.h>
+#endif
+
+namespace LIB_RATSS_NAMESPACE {
+namespace internal {
+
+///Computes ProjectSN::positionOnSphere and ProjectSN::sphere2Plane for many double points at once.
+///Points are stored as structure of arrays: coordinate j of point i is at coords[j*stride + i].
+///Depending on the compile flags 8 (AVX-512) or 4 (AVX2) points are processed per instruction.
+///The results are bit-identical to the scalar functions:
+///the pole is the first coordinate with maximal absolute value and denom = 1 + abs(pole coordinate).
+class SphereToPlaneBatch {
+public:
+	///@param plane same layout as coords, may be equal to coords
+	///@param pos receives the PositionOnSphere of every point, 0 (SP_INVALID) for the zero vector
+	static void run(const double * coords, std::size_t dims, std::size_t count, std::size_t stride, double * plane, int * pos);
+	///name of the instruction set used by run
+	static const char * instructionSet();
+private:
+	static void scalar(const double * coords, std::size_t dims, std::size_t begin, std::size_t end, std::size_t stride, double * plane, int * pos);
+};
+
+}}//end namespace LIB_RATSS_NAMESPACE::internal
+
+//definitions
+
+namespace LIB_RATSS_NAMESPACE {
+namespace internal {
+
+inline
+const char * SphereToPlaneBatch::instructionSet() {
+#if defined(__AVX512F__)
+	return "avx512";
+#elif defined(__AVX2__)
+	return "avx2";
+#else
+	return "scalar";
+#endif
+}
+
+inline
+void SphereToPlaneBatch::scalar(const double * coords, std::size_t dims, std::size_t begin, std::size_t end, std::size_t stride, double * plane, int * pos) {
+	for(std::size_t i(begin); i < end; ++i) {
+		double v = 0;
+		int p = 0;
+		for(std::size_t j(0); j < dims; ++j) {
+			double x = coords[j*stride+i];
+			if (std::abs(x) > v) {
+				v = std::abs(x);
+				p = (x > 0 ? 1 : -1) * int(j+1);
+			}
+		}
+		double denom = 1 + v;
+		for(std::size_t j(0); j < dims; ++j) {
+			plane[j*stride+i] = (int(j+1) == std::abs(p) ? 0 : coords[j*stride+i] / denom);
+		}
+		pos[i] = p;
+	}
+}
+
+inline
+void SphereToPlaneBatch::run(const double * coords, std::size_t dims, std::size_t count, std::size_t stride, double * plane, int * pos) {
+	std::size_t i(0);
+#if defined(__AVX512F__)
+	for(; i+8 <= count; i += 8) {
+		__m512d zero = _mm512_setzero_pd();
+		__m512d v = zero;
+		__m512d p = zero;
+		for(std::size_t j(0); j < dims; ++j) {
+			__m512d x = _mm512_loadu_pd(coords + j*stride + i);
+			__m512d ax = _mm512_abs_pd(x);
+			__m512d idx = _mm512_set1_pd(double(j+1));
+			__mmask8 larger = _mm512_cmp_pd_mask(ax, v, _CMP_GT_OQ);
+			__mmask8 positive = _mm512_cmp_pd_mask(x, zero, _CMP_GT_OQ);
+			__m512d signedIdx = _mm512_mask_blend_pd(positive, _mm512_sub_pd(zero, idx), idx);
+			v = _mm512_mask_blend_pd(larger, v, ax);
+			p = _mm512_mask_blend_pd(larger, p, signedIdx);
+		}
+		__m512d denom = _mm512_add_pd(_mm512_set1_pd(1), v);
+		__m512d absP = _mm512_abs_pd(p);
+		for(std::size_t j(0); j < dims; ++j) {
+			__m512d x = _mm512_loadu_pd(coords + j*stride + i);
+			__mmask8 isPole = _mm512_cmp_pd_mask(absP, _mm512_set1_pd(double(j+1)), _CMP_EQ_OQ);
+			_mm512_storeu_pd(plane + j*stride + i, _mm512_mask_blend_pd(isPole, _mm512_div_pd(x, denom), zero));
+		}
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(pos + i), _mm512_cvtpd_epi32(p));
+	}
+#elif defined(__AVX2__)
+	for(; i+4 <= count; i += 4) {
+		__m256d zero = _mm256_setzero_pd();
+		__m256d signMask = _mm256_set1_pd(-0.0);
+		__m256d v = zero;
+		__m256d p = zero;
+		for(std::size_t j(0); j < dims; ++j) {
+			__m256d x = _mm256_loadu_pd(coords + j*stride + i);
+			__m256d ax = _mm256_andnot_pd(signMask, x);
+			__m256d idx = _mm256_set1_pd(double(j+1));
+			__m256d larger = _mm256_cmp_pd(ax, v, _CMP_GT_OQ);
+			__m256d positive = _mm256_cmp_pd(x, zero, _CMP_GT_OQ);
+			__m256d signedIdx = _mm256_blendv_pd(_mm256_sub_pd(zero, idx), idx, positive);
+			v = _mm256_blendv_pd(v, ax, larger);
+			p = _mm256_blendv_pd(p, signedIdx, larger);
+		}
+		__m256d denom = _mm256_add_pd(_mm256_set1_pd(1), v);
+		__m256d absP = _mm256_andnot_pd(signMask, p);
+		for(std::size_t j(0); j < dims; ++j) {
+			__m256d x = _mm256_loadu_pd(coords + j*stride + i);
+			__m256d isPole = _mm256_cmp_pd(absP, _mm256_set1_pd(double(j+1)), _CMP_EQ_OQ);
+			_mm256_storeu_pd(plane + j*stride + i, _mm256_blendv_pd(_mm256_div_pd(x, denom), zero, isPole));
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(pos + i), _mm256_cvtpd_epi32(p));
+	}
+#endif
+	scalar(coords, dims, i, count, stride, plane, pos);
+}
+
+}}//end namespace LIB_RATSS_NAMESPACE::internal
+
+#endif
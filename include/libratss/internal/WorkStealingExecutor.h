@@ -0,0 +1,161 @@
+#ifndef LIB_RATSS_INTERNAL_WORK_STEALING_EXECUTOR_H
+#define LIB_RATSS_INTERNAL_WORK_STEALING_EXECUTOR_H
+#pragma once
+
+#include <libratss/constants.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace LIB_RATSS_NAMESPACE {
+namespace internal {
+
+///Runs tasks [0, taskCount) on a fixed number of workers.
+///Every worker starts with a contiguous range of tasks and processes it front to back.
+///A worker without work steals the back half of the remaining range of another worker.
+///The calling thread acts as worker 0.
+class WorkStealingExecutor {
+public:
+	///@param threadCount number of workers, 0 selects std::thread::hardware_concurrency()
+	explicit WorkStealingExecutor(std::size_t threadCount = 0);
+public:
+	inline std::size_t threadCount() const { return m_threadCount; }
+	///Number of workers that are actually used for taskCount tasks
+	inline std::size_t threadCount(std::size_t taskCount) const { return std::max<std::size_t>(1, std::min(m_threadCount, taskCount)); }
+public:
+	///Calls func(std::size_t workerId, std::size_t taskId) exactly once for every task
+	///The first exception thrown by func stops all workers and is rethrown in the calling thread
+	template<typename T_FUNC>
+	void run(std::size_t taskCount, T_FUNC func) const;
+private:
+	struct TaskRange {
+		std::mutex lock;
+		std::size_t begin{0};
+		std::size_t end{0};
+	};
+private:
+	static bool pop(TaskRange & range, std::size_t & taskId);
+	static bool steal(TaskRange & victim, TaskRange & thief);
+private:
+	std::size_t m_threadCount;
+};
+
+}}//end namespace LIB_RATSS_NAMESPACE::internal
+
+//definitions
+
+namespace LIB_RATSS_NAMESPACE {
+namespace internal {
+
+inline
+WorkStealingExecutor::WorkStealingExecutor(std::size_t threadCount) :
+m_threadCount(threadCount)
+{
+	if (!m_threadCount) {
+		m_threadCount = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+	}
+}
+
+inline
+bool WorkStealingExecutor::pop(TaskRange & range, std::size_t & taskId) {
+	std::lock_guard<std::mutex> lck(range.lock);
+	if (range.begin < range.end) {
+		taskId = range.begin;
+		++range.begin;
+		return true;
+	}
+	return false;
+}
+
+inline
+bool WorkStealingExecutor::steal(TaskRange & victim, TaskRange & thief) {
+	std::size_t begin, end;
+	{
+		std::lock_guard<std::mutex> lck(victim.lock);
+		if (victim.begin >= victim.end) {
+			return false;
+		}
+		std::size_t mid = victim.begin + (victim.end - victim.begin)/2;
+		begin = mid;
+		end = victim.end;
+		victim.end = mid;
+	}
+	std::lock_guard<std::mutex> lck(thief.lock);
+	thief.begin = begin;
+	thief.end = end;
+	return true;
+}
+
+template<typename T_FUNC>
+void WorkStealingExecutor::run(std::size_t taskCount, T_FUNC func) const {
+	if (!taskCount) {
+		return;
+	}
+	std::size_t workerCount = threadCount(taskCount);
+	if (workerCount == 1) {
+		for(std::size_t taskId(0); taskId < taskCount; ++taskId) {
+			func(std::size_t(0), taskId);
+		}
+		return;
+	}
+
+	std::unique_ptr<TaskRange[]> ranges(new TaskRange[workerCount]);
+	for(std::size_t i(0); i < workerCount; ++i) {
+		ranges[i].begin = (taskCount*i)/workerCount;
+		ranges[i].end = (taskCount*(i+1))/workerCount;
+	}
+
+	std::atomic<bool> abort{false};
+	std::exception_ptr error;
+	std::mutex errorLock;
+
+	auto worker = [&](std::size_t workerId) {
+		TaskRange & myRange = ranges[workerId];
+		try {
+			while (!abort.load(std::memory_order_relaxed)) {
+				std::size_t taskId;
+				if (pop(myRange, taskId)) {
+					func(workerId, taskId);
+					continue;
+				}
+				bool stolen = false;
+				for(std::size_t i(1); i < workerCount && !stolen; ++i) {
+					stolen = steal(ranges[(workerId+i) % workerCount], myRange);
+				}
+				//tasks are only ever moved between workers, so if nobody has any left we are done
+				if (!stolen) {
+					break;
+				}
+			}
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> lck(errorLock);
+			if (!error) {
+				error = std::current_exception();
+			}
+			abort = true;
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(workerCount-1);
+	for(std::size_t i(1); i < workerCount; ++i) {
+		threads.emplace_back(worker, i);
+	}
+	worker(0);
+	for(std::thread & t : threads) {
+		t.join();
+	}
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+}}//end namespace LIB_RATSS_NAMESPACE::internal
+
+#endif
@@ -46,6 +46,8 @@ public:
 
 	typedef enum { BM_SIGNIFICANDS, BM_EPSILON, BM_MAX_DEN} BoundMode;
 	typedef enum { SM_NONE=0x0, SM_SUM=0x1, SM_EACH=0x2, SM_SIZE_IN_BITS=0x4, SM_DISTANCE_RATIONAL=0x8, SM_DISTANCE_DOUBLE=0x10} StatsMode;
+	///format of the summary statistics, SF_JSON and SF_CSV also contain histograms and timings
+	typedef enum { SF_TEXT, SF_JSON, SF_CSV } StatsFormat;
 public:
 	std::string inFileName;
 	std::string outFileName;
@@ -61,11 +63,15 @@ public:
 	FloatPoint::Format inFormat{FloatPoint::FM_CARTESIAN_FLOAT};
 	RationalPoint::Format outFormat{RationalPoint::FM_RATIONAL};
 	int stats{SM_NONE};
+	StatsFormat statsFormat{SF_TEXT};
+	std::size_t cacheSize{0}; //number of snapped points kept in a SnapCache, 0 disables the cache
 public:
 	BasicCmdLineOptions();
 	virtual ~BasicCmdLineOptions();
 public:
 	int parse(int argc, char ** argv);
+	inline bool binaryInput() const { return inFormat & FloatPoint::FM_BINARY; }
+	inline bool binaryOutput() const { return outFormat & RationalPoint::FM_BINARY; }
 public:
 	//override this to parse extra options, return true if token was consumed
 	virtual bool parse(const std::string & currentToken,int & i, int argc, char ** argv);
@@ -0,0 +1,94 @@
+#ifndef LIB_RATSS_UTIL_BINARY_POINT_STREAM_H
+#define LIB_RATSS_UTIL_BINARY_POINT_STREAM_H
+#pragma once
+
+#include <libratss/constants.h>
+#include <libratss/util/InputOutputPoints.h>
+
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+namespace LIB_RATSS_NAMESPACE {
+
+/** Binary point stream, all values are stored in host byte order
+  *
+  * Header (24 bytes):
+  * 8 bytes magic "RATSSBPS", uint8 version, uint8 encoding, uint8 bytes per limb, uint8 byte order (1 = little endian),
+  * uint32 dimension, int32 precision in bits (53 for doubles, 0 for rationals), uint32 reserved
+  *
+  * The points follow without any separators, each coordinate is stored as
+  * BE_DOUBLE: IEEE double
+  * BE_MPFR: int32 kind (MPFR kind with the sign of the value), int64 exponent, ceil(precision/limb bits) limbs of the significand if the kind is regular
+  * BE_RATIONAL: int32 size of the numerator (number of limbs with the sign of the value), limbs, uint32 number of limbs of the denominator, limbs
+  *
+  * Rationals are written in canonical form and canonicalized when they are read.
+  * Numbers with more limbs than the rest of a seekable stream or more than 2^24 limbs are rejected before they are allocated.
+  */
+struct BinaryPointHeader {
+	typedef enum { BE_INVALID=0, BE_DOUBLE=1, BE_MPFR=2, BE_RATIONAL=3 } Encoding;
+	Encoding encoding{BE_INVALID};
+	std::uint32_t dimension{0};
+	std::int32_t precision{0};
+	BinaryPointHeader() {}
+	BinaryPointHeader(Encoding encoding, std::uint32_t dimension, std::int32_t precision);
+	///@param fmt one of FM_BINARY_RATIONAL, FM_BINARY_FLOAT, FM_BINARY_FLOAT128
+	static BinaryPointHeader fromFormat(PointBase::Format fmt, std::uint32_t dimension);
+	void read(std::istream & is);
+	void write(std::ostream & os) const;
+};
+
+class BinaryPointReader {
+public:
+	///reads the header, throws std::runtime_error if the stream is not a valid binary point stream for this machine
+	explicit BinaryPointReader(std::istream & is);
+	~BinaryPointReader();
+public:
+	inline const BinaryPointHeader & header() const { return m_header; }
+	///@return false if the stream ended before the point
+	bool read(FloatPoint & p, int precision);
+	///@return false if the stream ended before the point
+	bool read(RationalPoint & p);
+private:
+	bool begin();
+	void read(void * data, std::size_t size);
+	void read(mpfr::mpreal & v);
+	void read(mpq_class & v);
+	void read(mpz_ptr v, std::int32_t size);
+private:
+	std::istream & m_is;
+	BinaryPointHeader m_header;
+	std::vector<mp_limb_t> m_limbs;
+	mpfr::mpreal m_ft;
+	std::size_t m_remaining{std::numeric_limits<std::size_t>::max()}; //bytes left in the stream, unbounded if it is not seekable
+};
+
+class BinaryPointWriter {
+public:
+	///The header is written together with the first point
+	///@param fmt one of FM_BINARY_RATIONAL, FM_BINARY_FLOAT, FM_BINARY_FLOAT128
+	BinaryPointWriter(std::ostream & os, PointBase::Format fmt);
+	~BinaryPointWriter();
+public:
+	///all points need to have the same dimension
+	void write(const RationalPoint & p);
+	///all points need to have the same dimension
+	void write(const FloatPoint & p);
+private:
+	void begin(std::size_t dimension);
+	void write(const void * data, std::size_t size);
+	void write(const mpfr::mpreal & v);
+	void write(const mpq_class & v);
+	void write(mpz_srcptr v, bool withSign);
+private:
+	std::ostream & m_os;
+	PointBase::Format m_fmt;
+	BinaryPointHeader m_header;
+	mpfr::mpreal m_ft;
+};
+
+}//end namespace LIB_RATSS_NAMESPACE
+
+#endif
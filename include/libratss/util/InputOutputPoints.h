@@ -13,9 +13,16 @@ struct PointBase {
 		FM_GEO=0x1, FM_SPHERICAL=0x2,
 		FM_CARTESIAN_FLOAT=0x4, FM_CARTESIAN_FLOAT128=0x8,
 		FM_CARTESIAN_RATIONAL=0x10, FM_CARTESIAN_SPLIT_RATIONAL=0x20,
+		//binary point streams, see BinaryPointStream.h
+		FM_BINARY_RATIONAL=0x40, FM_BINARY_FLOAT=0x80, FM_BINARY_FLOAT128=0x100,
+		//numerators followed by their common denominator: n_1 ... n_d den
+		FM_CARTESIAN_HOMOGENEOUS=0x200,
+		//input only: the encoding is taken from the header of the stream
+		FM_BINARY=FM_BINARY_RATIONAL|FM_BINARY_FLOAT|FM_BINARY_FLOAT128,
 		
 		FM_FLOAT=FM_CARTESIAN_FLOAT, FM_FLOAT128=FM_CARTESIAN_FLOAT128,
-		FM_RATIONAL=FM_CARTESIAN_RATIONAL, FM_SPLIT_RATIONAL=FM_CARTESIAN_SPLIT_RATIONAL
+		FM_RATIONAL=FM_CARTESIAN_RATIONAL, FM_SPLIT_RATIONAL=FM_CARTESIAN_SPLIT_RATIONAL,
+		FM_HOMOGENEOUS=FM_CARTESIAN_HOMOGENEOUS
 	} Format;
 };
 
@@ -25,6 +32,11 @@ struct FloatPoint: PointBase {
 	void normalize();
 	void setPrecision(int precision);
 	void assign(std::istream& is, ratss::PointBase::Format fmt, int precision, int dimension = -1);
+	///lat, lon are changed to the precision used for the computation
+	///@param cache memoizes the trigonometric functions if not null
+	void assignGeo(mpfr::mpreal & lat, mpfr::mpreal & lon, int precision, GeoCalc::TrigCache * cache = nullptr);
+	///theta, phi are changed to the precision used for the computation
+	void assignSpherical(mpfr::mpreal & theta, mpfr::mpreal & phi, int precision);
 	template<typename T_ITERATOR>
 	void assign(const T_ITERATOR & begin, const T_ITERATOR & end, int precision) {
 		coords.clear();
@@ -67,6 +79,24 @@ struct RationalPoint: PointBase {
 	bool valid() const;
 };
 
+///The point coords[i]/denominator as produced by ProjectSN::snapHomogeneous, the fractions are not necessarily reduced
+struct HomogeneousPoint: PointBase {
+	std::vector<mpz_class> coords;
+	mpz_class denominator;
+	HomogeneousPoint();
+	void clear();
+	void resize(std::size_t _n);
+	///coordinates are the numerators with respect to the least common denominator of p
+	void assign(const RationalPoint & p);
+	///reads FM_HOMOGENEOUS: dimension numerators followed by the denominator, if dimension is -1 the last number of the line is the denominator
+	void assign(std::istream & is, int dimension = -1);
+	///canonical coordinates of the point
+	void get(RationalPoint & p) const;
+	///prints FM_HOMOGENEOUS
+	void print(std::ostream & out) const;
+	bool valid() const;
+};
+
 }//end namespace LIB_RATSS_NAMESPACE
 
 
@@ -0,0 +1,50 @@
+#ifndef LIB_RATSS_UTIL_MAPPED_FILE_H
+#define LIB_RATSS_UTIL_MAPPED_FILE_H
+#pragma once
+
+#include <libratss/constants.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace LIB_RATSS_NAMESPACE {
+
+///Read-only memory mapping of a whole file
+class MappedFile final {
+public:
+	struct Span {
+		const char * begin{nullptr};
+		const char * end{nullptr};
+		Span() {}
+		Span(const char * begin, const char * end) : begin(begin), end(end) {}
+		inline std::size_t size() const { return end - begin; }
+		inline bool empty() const { return begin == end; }
+	};
+public:
+	MappedFile();
+	///throws std::runtime_error if the file can not be mapped
+	explicit MappedFile(const std::string & fileName);
+	MappedFile(const MappedFile & other) = delete;
+	MappedFile & operator=(const MappedFile & other) = delete;
+	~MappedFile();
+public:
+	///throws std::runtime_error if the file can not be mapped
+	void open(const std::string & fileName);
+	void close();
+	inline bool isOpen() const { return m_fd >= 0; }
+	inline const char * data() const { return m_data; }
+	inline std::size_t size() const { return m_size; }
+	inline Span span() const { return Span(m_data, m_data+m_size); }
+	///Splits the file into at most count chunks of about equal size.
+	///Every chunk starts at the beginning of a line, hence chunks can be parsed independently.
+	std::vector<Span> chunks(std::size_t count) const;
+private:
+	int m_fd{-1};
+	const char * m_data{nullptr};
+	std::size_t m_size{0};
+};
+
+}//end namespace LIB_RATSS_NAMESPACE
+
+#endif
@@ -0,0 +1,175 @@
+#ifndef LIB_RATSS_UTIL_RATIONAL_POINT_STORE_H
+#define LIB_RATSS_UTIL_RATIONAL_POINT_STORE_H
+#pragma once
+
+#include <libratss/constants.h>
+#include <libratss/ProjectSN.h>
+#include <libratss/util/InputOutputPoints.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+namespace LIB_RATSS_NAMESPACE {
+
+/** Stores rational points of the same dimension in a single arena of limbs
+  *
+  * Every coordinate is stored as a header followed by the limbs of its numerator and denominator.
+  * The header holds the number of limbs of the numerator with the sign of the coordinate and the number of limbs of the denominator.
+  * Denominators equal to 1 or to the denominator of the previous coordinate of the same point are not stored.
+  * Points are located by their offset into the arena.
+  *
+  * Views reference the arena directly and are invalidated by any modification of the store.
+  */
+class RationalPointStore {
+public:
+	///Read-only coordinate that can be passed to gmp functions taking a mpq_srcptr
+	class CoordinateView {
+	public:
+		CoordinateView();
+		CoordinateView(const CoordinateView & other);
+		CoordinateView & operator=(const CoordinateView & other);
+	public:
+		inline operator mpq_srcptr() const { return &m_q; }
+		inline mpq_srcptr get_mpq_t() const { return &m_q; }
+		inline mpz_srcptr get_num_mpz_t() const { return mpq_numref(&m_q); }
+		inline mpz_srcptr get_den_mpz_t() const { return mpq_denref(&m_q); }
+		void get(mpq_class & v) const;
+		mpq_class get() const;
+	private:
+		friend class RationalPointStore;
+		void setNum(const mp_limb_t * limbs, std::int32_t size);
+		void setDen(const mp_limb_t * limbs, std::int32_t size);
+	private:
+		__mpq_struct m_q;
+	};
+	class const_iterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = CoordinateView;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const CoordinateView *;
+		using reference = const CoordinateView &;
+	public:
+		const_iterator() {}
+		const_iterator(const mp_limb_t * data, std::size_t remaining);
+	public:
+		inline reference operator*() const { return m_v; }
+		inline pointer operator->() const { return &m_v; }
+		const_iterator & operator++();
+		const_iterator operator++(int);
+		inline bool operator==(const const_iterator & other) const { return m_remaining == other.m_remaining; }
+		inline bool operator!=(const const_iterator & other) const { return m_remaining != other.m_remaining; }
+	private:
+		void load();
+	private:
+		const mp_limb_t * m_data{nullptr};
+		std::size_t m_remaining{0};
+		CoordinateView m_v;
+	};
+	class PointView {
+	public:
+		PointView(const mp_limb_t * data, std::size_t dimension);
+	public:
+		inline std::size_t size() const { return m_dimension; }
+		inline const_iterator begin() const { return const_iterator(m_data, m_dimension); }
+		inline const_iterator end() const { return const_iterator(); }
+		///O(dimension) since coordinates have variable length
+		CoordinateView operator[](std::size_t i) const;
+		///@param out has to accept mpq_class
+		template<typename T_OUTPUT_ITERATOR>
+		void get(T_OUTPUT_ITERATOR out) const;
+		void get(RationalPoint & p) const;
+	private:
+		const mp_limb_t * m_data;
+		std::size_t m_dimension;
+	};
+public:
+	///@param dimension of the stored points, 0 takes the dimension of the first point
+	explicit RationalPointStore(std::size_t dimension = 0);
+	RationalPointStore(const RationalPointStore & other) = default;
+	RationalPointStore(RationalPointStore && other) = default;
+	RationalPointStore & operator=(const RationalPointStore & other) = default;
+	RationalPointStore & operator=(RationalPointStore && other) = default;
+public:
+	inline std::size_t size() const { return m_offsets.size()-1; }
+	inline bool empty() const { return size() == 0; }
+	inline std::size_t dimension() const { return m_dimension; }
+	///number of limbs in the arena
+	inline std::size_t limbCount() const { return m_limbs.size(); }
+	///bytes allocated by the store
+	std::size_t memoryUsage() const;
+	void reserve(std::size_t points, std::size_t limbs);
+	void shrink_to_fit();
+	///keeps the dimension
+	void clear();
+public:
+	inline PointView operator[](std::size_t i) const { return PointView(m_limbs.data() + m_offsets[i], m_dimension); }
+	PointView at(std::size_t i) const;
+	void get(std::size_t i, RationalPoint & p) const;
+public:
+	///@param begin iterator of mpq_class, throws std::invalid_argument if the point does not have dimension() coordinates
+	template<typename T_INPUT_ITERATOR>
+	void push_back(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end);
+	void push_back(const RationalPoint & p);
+	///Snaps the points and appends them, see ProjectSN::snapBatch() for the parameters
+	///Points are snapped in blocks of snapBlockSize points such that only a single block exists as mpq_class at a time
+	template<typename T_FT>
+	void snap(const ProjectSN & proj, const std::vector<T_FT> & points, std::size_t dims, const ProjectSN::SnapConfig & sc, std::size_t threads = 0);
+public:
+	static constexpr std::size_t snapBlockSize = 4096;
+private:
+	void beginPoint(std::size_t dims);
+	///@param prevDen denominator of the previous coordinate of the point, nullptr for the first one
+	void append(mpq_srcptr v, mpz_srcptr prevDen);
+private:
+	std::size_t m_dimension;
+	std::vector<mp_limb_t> m_limbs;
+	///offsets of the points into m_limbs, the last entry is the end of the arena
+	std::vector<std::size_t> m_offsets;
+};
+
+//definitions
+
+template<typename T_OUTPUT_ITERATOR>
+void RationalPointStore::PointView::get(T_OUTPUT_ITERATOR out) const {
+	for(const_iterator it(begin()), e(end()); it != e; ++it, ++out) {
+		mpq_class & v = *out;
+		it->get(v);
+	}
+}
+
+template<typename T_INPUT_ITERATOR>
+void RationalPointStore::push_back(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end) {
+	using std::distance;
+	beginPoint(distance(begin, end));
+	mpz_srcptr prevDen = nullptr;
+	for(; begin != end; ++begin) {
+		mpq_srcptr v = begin->get_mpq_t();
+		append(v, prevDen);
+		prevDen = mpq_denref(v);
+	}
+	m_offsets.push_back(m_limbs.size());
+}
+
+template<typename T_FT>
+void RationalPointStore::snap(const ProjectSN & proj, const std::vector<T_FT> & points, std::size_t dims, const ProjectSN::SnapConfig & sc, std::size_t threads) {
+	if (!dims || points.size() % dims != 0) {
+		throw std::invalid_argument("ratss::RationalPointStore::snap: number of coordinates is not a multiple of dims");
+	}
+	std::vector<mpq_class> block;
+	for(std::size_t i(0), s(points.size()); i < s; i += snapBlockSize*dims) {
+		std::size_t blockEnd = std::min(s, i + snapBlockSize*dims);
+		block.resize(blockEnd - i);
+		proj.snapBatch(points.begin()+i, points.begin()+blockEnd, dims, block.begin(), sc, threads);
+		for(std::size_t j(0), bs(block.size()); j < bs; j += dims) {
+			push_back(block.begin()+j, block.begin()+j+dims);
+		}
+	}
+}
+
+}//end namespace LIB_RATSS_NAMESPACE
+
+#endif
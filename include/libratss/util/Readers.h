@@ -5,8 +5,13 @@
 #include <libratss/util/BasicCmdLineOptions.h>
 #include <libratss/util/InputOutputPoints.h>
 #include <libratss/util/InputOutput.h>
+#include <libratss/util/BinaryPointStream.h>
+#include <libratss/util/MappedFile.h>
+#include <libratss/util/TextPointParser.h>
 #include <libratss/ProjectSN.h>
 
+#include <memory>
+
 namespace LIB_RATSS_NAMESPACE {
 
 class FileReader {
@@ -39,23 +44,69 @@ void FileReader::visit(T_VISITOR visitor) {
 	auto & op = m_rp;
 	
 	ProjectSN proj;
+	ProjectSN::SnapConfig sc(cfg.snapType, cfg.precision, cfg.significands);
+	SnapWorkspace<mpfr::mpreal> ws;
+	if (cfg.cacheSize) {
+		sc.setCache(std::make_shared<SnapCache>(cfg.cacheSize));
+	}
 
 	if (cfg.progress) {
 		io.info() << std::endl;
 	}
 	std::size_t counter = 0;
+	
+	std::unique_ptr<BinaryPointReader> binary;
+	MappedFile mapped;
+	TextPointParser parser;
+	if (cfg.binaryInput()) {
+		binary.reset(new BinaryPointReader(io.input()));
+	}
+	else if (cfg.inFileName.size()) {
+		try {
+			mapped.open(cfg.inFileName);
+		}
+		catch (const std::runtime_error &) {
+			//not a regular file, use the input stream
+		}
+	}
+	const char * pos = mapped.data();
+	const char * end = pos + mapped.size();
+	bool streamInput = !binary && !mapped.isOpen();
 
-	while( io.input().good() ) {
-		for( ; io.input().good() && io.input().peek() == '\n'; ) {
-			io.input().get();
-			io.output().put('\n');
+	while( mapped.isOpen() || io.input().good() ) {
+		if (binary) {
+			if (cfg.rationalPassThrough ? !binary->read(op) : !binary->read(ip, cfg.precision)) {
+				break;
+			}
 		}
-		if (!io.input().good()) {
-			break;
+		else if (mapped.isOpen()) {
+			for( ; pos != end && *pos == '\n'; ++pos) {
+				io.output().put('\n');
+			}
+			if (pos == end) {
+				break;
+			}
+			if (cfg.rationalPassThrough) {
+				pos = parser.parse(pos, end, cfg.inFormat, cfg.precision, op);
+			}
+			else {
+				pos = parser.parse(pos, end, cfg.inFormat, cfg.precision, ip);
+			}
+		}
+		else {
+			for( ; io.input().good() && io.input().peek() == '\n'; ) {
+				io.input().get();
+				io.output().put('\n');
+			}
+			if (!io.input().good()) {
+				break;
+			}
 		}
 		bool opFromIp = !cfg.rationalPassThrough;
 		if (cfg.rationalPassThrough) {
-			op.assign(io.input(), cfg.inFormat, cfg.precision);
+			if (streamInput) {
+				op.assign(io.input(), cfg.inFormat, cfg.precision);
+			}
 			if (!op.valid()) {
 				if (!(cfg.snapType & ST_NORMALIZE)) {
 					std::cerr << "Input point read that is not on sphere but no normalization was requested" << std::endl;
@@ -66,7 +117,7 @@ void FileReader::visit(T_VISITOR visitor) {
 				}
 			}
 		}
-		else {
+		else if (streamInput) {
 			ip.assign(io.input(), cfg.inFormat, cfg.precision);
 		}
 		
@@ -83,7 +134,7 @@ void FileReader::visit(T_VISITOR visitor) {
 			ip.setPrecision(cfg.precision);
 			op.clear();
 			op.resize(ip.coords.size());
-			proj.snap(ip.coords.begin(), ip.coords.end(), op.coords.begin(), cfg.snapType, cfg.significands);
+			proj.snap(ip.coords.begin(), ip.coords.end(), op.coords.begin(), sc, ws);
 		}
 		visitor(ip, op);
 		
@@ -95,6 +146,10 @@ void FileReader::visit(T_VISITOR visitor) {
 	if (cfg.progress) {
 		io.info() << std::endl;
 	}
+	if (cfg.verbose && sc.cache()) {
+		const SnapCache & cache = *sc.cache();
+		io.info() << "Cache hit rate: " << cache.hitRate() << " (" << cache.hits() << " hits, " << cache.misses() << " misses, " << cache.evictions() << " evictions)" << std::endl;
+	}
 }
 
 
@@ -0,0 +1,50 @@
+#ifndef LIB_RATSS_UTIL_TEXT_POINT_PARSER_H
+#define LIB_RATSS_UTIL_TEXT_POINT_PARSER_H
+#pragma once
+
+#include <libratss/constants.h>
+#include <libratss/util/InputOutputPoints.h>
+
+#include <string>
+
+namespace LIB_RATSS_NAMESPACE {
+
+/** Parses points in the text formats of FloatPoint::assign and RationalPoint::assign from memory, e.g. a MappedFile.
+  * Numbers are parsed without iostreams and the result is the same as with the stream versions.
+  * A point ends at the end of the line or after dimension coordinates.
+  * Instances are cheap, use one per thread to parse independent chunks in parallel.
+  */
+class TextPointParser final {
+public:
+	TextPointParser();
+	~TextPointParser();
+public:
+	///@return position behind the last coordinate of the point, this is either a line break or end
+	const char * parse(const char * begin, const char * end, PointBase::Format fmt, int precision, FloatPoint & p, int dimension = -1);
+	///@return position behind the last coordinate of the point, this is either a line break or end
+	const char * parse(const char * begin, const char * end, PointBase::Format fmt, int precision, RationalPoint & p, int dimension = -1);
+public:
+	///@return position behind the line break of the current line or end
+	static const char * nextLine(const char * begin, const char * end);
+	///@return position of the first character that is not a line break
+	static const char * skipLineBreaks(const char * begin, const char * end);
+private:
+	///@return false if there is no token left in the current line
+	bool token(const char * & it, const char * end, const char * & tokenBegin);
+	void parse(const char * begin, const char * end, mpfr::mpreal & v);
+	void parse(const char * begin, const char * end, mpz_ptr v);
+	void parse(const char * begin, const char * end, mpq_class & v);
+	[[noreturn]] void invalid(const char * begin, const char * end) const;
+private:
+	std::string m_buffer;
+	mpq_class m_q;
+	mpz_class m_num;
+	mpz_class m_den;
+	FloatPoint m_fp;
+	//geo input is often on a grid, e.g. OSM coordinates are multiples of 1e-7
+	GeoCalc::TrigCache m_trig;
+};
+
+}//end namespace LIB_RATSS_NAMESPACE
+
+#endif
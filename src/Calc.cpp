@@ -3,7 +3,10 @@
 #include <assert.h>
 #include <cmath>
 
+#include <libratss/internal/JacobiPerron2D.h>
 #include <libratss/internal/Matrix.h>
+#include <libratss/internal/InplaceArithmetic.h>
+#include <libratss/internal/FixpointFast.h>
 
 namespace LIB_RATSS_NAMESPACE {
 
@@ -124,42 +127,56 @@ The issue here are not the large number since they should usually be between -1
 The problem are points that are close to 0 that are representable by floating points but to a lesser degree by a fixed point type
 */
 mpfr::mpreal Calc::toFixpoint(mpfr::mpreal const & v, int significands) const {
+	mpfr::mpreal result;
+	toFixpoint(result, v, significands);
+	return result;
+}
+
+void Calc::toFixpoint(mpfr::mpreal & result, mpfr::mpreal const & v, int significands) const {
 	assert(significands > 0);
 	assert(!isnan(v));
 	assert(isfinite(v));
-	using std::abs;
+	assert(&result != &v);
 	
-	int sign = v < 0 ? -1 : 1;
+	int sign = mpfr_sgn(v.mpfr_srcptr()) < 0 ? -1 : 1;
 	
-	if (v*sign >= 1) {
-		return mpfr::const_infinity(sign, significands);
+	if (mpfr_zero_p(v.mpfr_srcptr())) {
+		internal::setPrecision(result, significands, false);
+		mpfr_set_zero(result.mpfr_ptr(), sign);
+		return;
+	}
+	
+	mpfr_exp_t exp = mpfr_get_exp(v.mpfr_srcptr());
+	
+	if (exp > 0) { //abs(v) >= 1
+		internal::setPrecision(result, significands, false);
+		mpfr_set_inf(result.mpfr_ptr(), sign);
+		return;
 	}
-
-	mpfr_exp_t exp = v.get_exp();
-	mpfr::mpreal result(0, significands);
 	
-	assert(exp <= 0);
 	if (-exp > significands) {
-		result.setZero(sign);
+		internal::setPrecision(result, significands, false);
+		mpfr_set_zero(result.mpfr_ptr(), sign);
+		return;
+	}
+	
+	//our number has abs(exp) many 0 bits at the front
+	//In total we want signifcands many bits
+	//thus only signifcands-abs(exp) many bits of the mantissa remain
+	long int mantissaBits = significands + exp;
+	internal::setPrecision(result, std::max<long int>(2, mantissaBits), false); //a precision < 2 is not allowed
+	if (mantissaBits >= 2) {
+		mpfr_set(result.mpfr_ptr(), v.mpfr_srcptr(), MPFR_RNDZ);
+	}
+	else if (mantissaBits == 1) {
+		mpfr_set_si_2exp(result.mpfr_ptr(), sign, exp-1, MPFR_RNDZ);
 	}
 	else {
-		//this will get us the mantissa in base 2 without a sign character in front
-		result = v*sign;
-		char * binstr = ::mpfr_get_str(0, &exp, 2, significands, result.mpfr_ptr(), MPFR_RNDZ);
-		std::string strval(binstr);
-		::mpfr_free_str(binstr);
-		
-		//our number has abs(exp) many 0 bits at the front
-		//In total we want signifcands many bits
-		//thus only signifcands-abs(exp) many bits remain after adding the zeros in front
-		strval.resize(significands-abs(exp));
-		
-		result.setPrecision(std::max<int>(2, significands-abs(exp))); //a precision < 2 is not allowed
-		::mpfr_set_str(result.mpfr_ptr(), strval.data(), 2, MPFR_RNDZ);
-		::mpfr_set_exp(result.mpfr_ptr(), exp);
-		result *= sign;
+		//no bit remains. The previous string based implementation kept v rounded to 2 bits with the exponent of v.
+		//Keep that result in order to not change any snapped point.
+		mpfr_set(result.mpfr_ptr(), v.mpfr_srcptr(), MPFR_RNDN);
+		mpfr_set_exp(result.mpfr_ptr(), exp);
 	}
-	return result;
 }
 
 #if defined(LIB_RATSS_WITH_CGAL)
@@ -214,37 +231,12 @@ CORE_TWO::BigFloat Calc::toFixpoint(CORE_TWO::BigFloat const & v, int significan
 }
 #endif
 
-mpq_class fromRegContFrac(const std::vector<mpz_class> & cf) {
-	if (cf.size() == 1) {
-		return mpq_class(cf.back());
-	}
-
-	//we have a regular continous fraction in cf, let's reduce it
-	//the form is a_0 + ( 1 / (a_1 + 1 / (a_2 + 1 / (a_3 + ...))))
-	//we use the fast non-division form to reconstruct our fraction
-	mpz_class pn(cf.front()), pn1(1), pn2(0);
-	mpz_class qn(1), qn1(0), qn2(1);
-	for(auto it(cf.begin()+1), end(cf.end()); it != end; ++it) {
-		const mpz_class & a_i = *it;
-		pn = a_i * pn1 + pn2;
-		pn2 = pn1;
-		pn1 = pn;
-		
-		qn = a_i * qn1 + qn2;
-		qn2 = qn1;
-		qn1 = qn;
-	}
-	mpq_class result(qn, pn);
-	result.canonicalize();
-	return result;
-}
-
-mpq_class Calc::within(const mpq_class & lower, const mpq_class & upper) const {
+mpq_class Calc::within(const mpq_class & lower, const mpq_class & upper, int cfEngine) const {
 	if (lower == upper) {
 		return lower;
 	}
 	if (lower > upper) {
-		return within(upper, lower);
+		return within(upper, lower, cfEngine);
 	}
 	if (lower < 0 && upper > 0) {
 		return mpq_class(0);
@@ -253,53 +245,52 @@ mpq_class Calc::within(const mpq_class & lower, const mpq_class & upper) const {
 		return mpq_class(0);
 	}
 	if (lower < 0) { //this also means that upper is < 0
-		return - within(-upper, -lower);
+		return - within(-upper, -lower, cfEngine);
 	}
 	
-	
 	//now calculate continous fractions for lower and upper up to the point where they differ
-	std::vector<mpz_class> cf;
-	mpz_class ldiv, udiv;
-	mpq_class ltmp(lower), utmp(upper);
+	internal::ContinuedFraction lcf, ucf;
+	auto engine = internal::ContinuedFraction::engine(cfEngine);
+	lcf.init(lower.get_num_mpz_t(), lower.get_den_mpz_t());
+	ucf.init(upper.get_num_mpz_t(), upper.get_den_mpz_t());
+	mpz_class ldiv, udiv, lrem, urem;
+	mpz_class last;
 	while (true) {
-	
-		ldiv = ltmp.get_num() / ltmp.get_den();
-		udiv = utmp.get_num() / utmp.get_den();
+		lcf.runCommon(ucf, engine);
+		mpz_tdiv_qr(ldiv.get_mpz_t(), lrem.get_mpz_t(), lcf.d(), lcf.n());
+		mpz_tdiv_qr(udiv.get_mpz_t(), urem.get_mpz_t(), ucf.d(), ucf.n());
 		
-		//prepare for next iteration
-		ltmp -= mpq_class(ldiv);
-		utmp -= mpq_class(udiv);
-
 		//one is the prefix of the other
-		
-		if (ltmp == 0 && utmp == 0) {
-			cf.push_back(ldiv);
+		if (lrem == 0 && urem == 0) {
+			last = ldiv;
 			break;
 		}
-		else if (ltmp == 0 || utmp == 0) {
-			using std::min;
-			if (ltmp == 0) {
-				cf.push_back(ldiv);
+		else if (lrem == 0 || urem == 0) {
+			if (lrem == 0) {
+				last = ldiv;
 			}
 			else {
-				cf.push_back(udiv);
+				last = udiv;
 			}
 			break;
 		}
 		
 		if ( ldiv != udiv ) {
 			using std::min;
-			cf.push_back( min(ldiv, udiv)+mpz_class(1) );
+			last = min(ldiv, udiv)+1;
 			break;
 		}
 		else {
-			cf.push_back(ldiv);
+			lcf.step(ldiv.get_mpz_t());
+			ucf.step(udiv.get_mpz_t());
 		}
-		
-		ltmp = 1  / ltmp;
-		utmp = 1 / utmp;
 	}
-	mpq_class result = fromRegContFrac(cf);
+	//the convergents of lcf and ucf are the same
+	mpq_class result;
+	mpz_set(result.get_num_mpz_t(), lcf.h0());
+	mpz_addmul(result.get_num_mpz_t(), last.get_mpz_t(), lcf.h1());
+	mpz_set(result.get_den_mpz_t(), lcf.k0());
+	mpz_addmul(result.get_den_mpz_t(), last.get_mpz_t(), lcf.k1());
 	
 	//make sure that we always return the smallest possible denominator
 	if (result == lower || result == upper) {
@@ -322,110 +313,90 @@ mpq_class Calc::within(const mpq_class & lower, const mpq_class & upper) const {
 /// with the a_i beeing the representation of p/q
 /// Stopping after some i with r_i != 0 gives us and approximation of 
 mpq_class Calc::contFrac(const mpq_class& value, int significands, int mode) const {
-	
-	if (value < 0) {
-		return -contFrac(-value, significands, mode);
+	mpq_class result;
+	Scratch scratch;
+	contFrac(result, value, significands, mode, scratch);
+	return result;
+}
+
+void Calc::contFrac(mpq_class & result, const mpq_class & value, int significands, int mode, Scratch & scratch) const {
+	assert(&result != &value);
+	int sgn = mpq_sgn(value.get_mpq_t());
+	if (sgn == 0) {
+		mpq_set_ui(result.get_mpq_t(), 0, 1);
+		return;
 	}
-	if (value == 0) {
-		return mpq_class(0);
+	mpz_srcptr valueDen = value.get_den_mpz_t();
+	//value = intPart + n/d with 0 <= n/d < 1, n/d is canonical since value is
+	mpz_class & intPart = scratch.intPart;
+	mpz_class & n = scratch.t0;
+	mpz_tdiv_qr(intPart.get_mpz_t(), n.get_mpz_t(), value.get_num_mpz_t(), valueDen);
+	if (sgn < 0) {
+		mpz_neg(intPart.get_mpz_t(), intPart.get_mpz_t());
+		mpz_neg(n.get_mpz_t(), n.get_mpz_t());
 	}
-	mpz_class epsDenom(1);
-	epsDenom <<= significands;
-	mpq_class eps{mpz_class(1), epsDenom};
-	
-	if (value >= 1) {
-		mpz_class intPart = value.get_num() / value.get_den();
-		mpq_class remainder = value - intPart;
-		if ((mode & ST_GUARANTEE_DISTANCE) && remainder < eps) {
-			return mpq_class(intPart);
-		}
-		return intPart + contFrac(remainder, significands, mode);
+	//remainder < eps
+	mpz_mul_2exp(scratch.t1.get_mpz_t(), n.get_mpz_t(), significands);
+	if (mpz_sgn(intPart.get_mpz_t()) != 0 && (mode & ST_GUARANTEE_DISTANCE) && mpz_cmp(scratch.t1.get_mpz_t(), valueDen) < 0) {
+		mpq_set_z(result.get_mpq_t(), intPart.get_mpz_t());
 	}
-	//we now know that 0 < value < 1
-	
-#ifndef NDEBUG
-	std::vector<mpz_class> cf;
-#else
-	mpz_class cfBack;
-#endif
-	mpz_class distUpperBoundDenom;
-	mpz_class intPart;
-	mpq_class tmp(value);
-
-	//take care of the first iteration
-	intPart = tmp.get_num() / tmp.get_den();
-	tmp -= intPart;
-	
-#ifndef NDEBUG
-	cf.emplace_back( std::move(intPart) );
-#else
-	cfBack = std::move(intPart);
-#endif
-	//a_1 is now in cf, calculate a_2...
-	//eps is of the form 1/number, our bound is
-	//abs(value-p_n/q_n) < 1/(a_(n+1) * q_n**2 )
-	
-	//we have to calculate our continuous fraction on the fly in order to obey our significand as good as possible
-	#ifndef NDEBUG
-	mpz_class pn(cf.back());
-	#else
-	mpz_class pn(cfBack);
-	#endif
-	mpz_class pn1(1), pn2(0);
-	mpz_class qn(1), qn1(0), qn2(1);
-	
-	mpq_class result;
-	while(tmp > 0) {
-		assert(tmp <= 1);
-		tmp = 1 / tmp;
-		intPart = tmp.get_num() / tmp.get_den();
-		#ifndef NDEBUG
-		mpz_class qsq = cf.back()*cf.back();
-		#else
-		mpz_class qsq = cfBack*cfBack;
-		#endif
-		
-		tmp -= intPart;
-		#ifndef NDEBUG
-		cf.emplace_back( std::move(intPart) );
-		const mpz_class & a_i = cf.back();
-		#else
-		cfBack = std::move(intPart);
-		const mpz_class & a_i = cfBack;
-		#endif
-		pn = a_i * pn1 + pn2;
-		pn2 = pn1;
-		pn1 = pn;
-		
-		qn = a_i * qn1 + qn2;
-		qn2 = qn1;
-		qn1 = qn;
-		mpq_class nextResult(qn, pn);
-		nextResult.canonicalize();
-		assert(fromRegContFrac(cf) == nextResult);
+	//without any guarantee no convergent is accepted
+	else if (!(mode & (ST_GUARANTEE_DISTANCE|ST_GUARANTEE_SIZE)) || mpz_sgn(n.get_mpz_t()) == 0) {
+		mpq_set_z(result.get_mpq_t(), intPart.get_mpz_t());
+	}
+	else {
+		internal::ContinuedFraction & cf = scratch.cf;
+		auto engine = internal::ContinuedFraction::engine(mode);
+		cf.init(n.get_mpz_t(), valueDen);
+		cf.step(); //the partial quotient of n/d is 0
 		if (mode & ST_GUARANTEE_DISTANCE) {
-			if (abs(nextResult - value) <= eps) {
-				result = nextResult;
-				break;	
-			}
+			//abs(h1/k1 - n/d) = cf.n()/(k1*d) <= 2^-significands
+			mp_bitcnt_t denBits = mpz_sizeinbase(valueDen, 2);
+			cf.run(engine, [&scratch, valueDen, denBits, significands](mpz_srcptr rem, mpz_srcptr k) {
+				if (!mpz_sgn(rem)) {
+					return true;
+				}
+				mp_bitcnt_t lhs = mpz_sizeinbase(rem, 2) + significands;
+				mp_bitcnt_t rhs = mpz_sizeinbase(k, 2) + denBits;
+				if (lhs > rhs) {
+					return false;
+				}
+				if (lhs+1 < rhs) {
+					return true;
+				}
+				mpz_mul_2exp(scratch.t0.get_mpz_t(), rem, significands);
+				mpz_mul(scratch.t1.get_mpz_t(), k, valueDen);
+				return mpz_cmp(scratch.t0.get_mpz_t(), scratch.t1.get_mpz_t()) <= 0;
+			});
+			mpz_set(result.get_num_mpz_t(), cf.h1());
+			mpz_set(result.get_den_mpz_t(), cf.k1());
 		}
-		else if (mode & ST_GUARANTEE_SIZE) {
-			if (nextResult.get_den() <= eps.get_den()) {
-				result = nextResult;
+		else {
+			//maximum denominator
+			mpz_set_ui(scratch.t1.get_mpz_t(), 0);
+			mpz_setbit(scratch.t1.get_mpz_t(), significands);
+			mpz_srcptr maxDen = scratch.t1.get_mpz_t();
+			if (cf.run(engine, [maxDen](mpz_srcptr, mpz_srcptr k) { return mpz_cmp(k, maxDen) > 0; })) {
+				//the previous convergent is the result
+				mpz_set(result.get_num_mpz_t(), cf.h0());
+				mpz_set(result.get_den_mpz_t(), cf.k0());
 			}
 			else {
-				break;
+				mpz_set(result.get_num_mpz_t(), cf.h1());
+				mpz_set(result.get_den_mpz_t(), cf.k1());
 			}
 		}
+		//adding an integer keeps result canonical
+		mpz_addmul(result.get_num_mpz_t(), result.get_den_mpz_t(), intPart.get_mpz_t());
 	}
-	assert((mode & ST_GUARANTEE_SIZE) == 0 ||result.get_den() <= eps.get_den());
-	assert((mode & ST_GUARANTEE_DISTANCE) == 0 || abs(value-result) <= eps);
-	assert(result <= 1);
-	return result;
+	if (sgn < 0) {
+		mpq_neg(result.get_mpq_t(), result.get_mpq_t());
+	}
+	assert((mode & ST_GUARANTEE_SIZE) == 0 || result.get_den() <= (mpz_class(1) << significands));
+	assert((mode & ST_GUARANTEE_DISTANCE) == 0 || abs(value-result) <= mpq_class(mpz_class(1), mpz_class(1) << significands));
 }
 
 void Calc::jacobiPerron2D(const mpq_class& input1, const mpq_class& input2, mpq_class& output1, mpq_class & output2, int significands, int mode) const {
-	using Matrix = internal::Matrix<mpz_class>;
 	using std::abs;
 	
 	if (significands < 2) {
@@ -481,84 +452,13 @@ void Calc::jacobiPerron2D(const mpq_class& input1, const mpq_class& input2, mpq_
 		}
 	}
 	
-	Matrix result( Matrix::identity(3) );
-	Matrix mtxStep(3);
-	mtxStep(0, 2) = 1;
-	mtxStep(1, 0) = 1;
-	mtxStep(2, 1) = 1;
-	
-	mpz_class an, bn;
+	//runs on machine words if the common denominator of the input fits, otherwise on mpz_class, see internal/JacobiPerron2D.h
+	internal::JacobiPerron2D jp(input1, input2);
+	bool alphaIsZero = jp.run(significands, mode, output1, output2);
 	
-	mpq_class alpha(input1), beta(input2);
-	
-	mpq_class tmp1, tmp2;
-
-	mpq_class best_diff = 1;
-	
-	while(alpha != 0) {
-
-		tmp1 = 1 / alpha;
-		an = tmp1.get_num()/tmp1.get_den();
-		
-		tmp2 = beta / alpha;
-		bn = tmp2.get_num()/tmp2.get_den();
-		
-		alpha = tmp2 - bn;
-		beta = tmp1 - an;
-		
-		assert(alpha >= 0 && beta >= 0);
-		
-		mtxStep(0,0) = an;
-		mtxStep(2,0) = bn;
-		
-		result = result * mtxStep;
-
-		assert(result(0,0) > 0);
-		
-		if (mode & ST_GUARANTEE_DISTANCE) {
-			output1 = mpq_class( result(1, 0), result(0, 0) );
-			output2 = mpq_class( result(2, 0), result(0, 0) );
-			
-			output1.canonicalize();
-			output2.canonicalize();
-			
-			const mpq_class diff1 = abs(output1-input1);
-			const mpq_class diff2 = abs(output2-input2);
-			
-			if ( diff1 <= eps && diff2 <= eps) {
-				break;
-			}
-		}
-		else if (mode & ST_GUARANTEE_SIZE) {
-
-			mpq_class o1( result(1, 0), result(0, 0) );
-			mpq_class o2( result(2, 0), result(0, 0) );
-			
-			o1.canonicalize();
-			o2.canonicalize();
-			using std::max;
-			if (abs(max(o1.get_den(), o2.get_den())) <= eps.get_den()) {
-
-				const mpq_class diff1 = abs(o1-input1);
-				const mpq_class diff2 = abs(o2-input2);
-
-				if (max(diff1, diff2) < best_diff) {
-					best_diff = max(diff1, diff2);
-					output1 = std::move(o1);
-					output2 = std::move(o2);
-					
-					assert(output1.get_den() <= eps.get_den());
-					assert(output2.get_den() <= eps.get_den());
-				}
-			}
-			else {
-				break;
-			}
-		}
-	}
 	//TODO: if alpha = 0, but beta not good enough?
 	
-	if (alpha == 0) {
+	if (alphaIsZero) {
 		#ifdef LIBRATSS_DEBUG_VERBOSE
 		std::cerr << "ratss::Calc::jacobiPerron2D: simultaneous approximation failed. Using continued fractions." << std::endl;
 		#endif
@@ -598,7 +498,136 @@ void Calc::jacobiPerron2D(const mpq_class& input1, const mpq_class& input2, mpq_
 	}
 }
 
+void Calc::jacobiPerron(const std::vector<mpq_class>& input, std::vector<mpq_class>& output, int significands, int mode) const {
+	using Matrix = internal::Matrix<mpz_class>;
+	
+	if (significands < 2) {
+		throw std::underflow_error("ratss::Calc::jacobiPerron: significands is too small.");
+	}
+	
+	output.resize(input.size());
+	if (input.size() == 0) {
+		return;
+	}
+	else if (input.size() == 1) {
+		output[0] = contFrac(input[0], significands, mode);
+		return;
+	}
+	else if (input.size() == 2) {
+		jacobiPerron2D(input[0], input[1], output[0], output[1], significands, mode);
+		return;
+	}
+	
+	//The fractional parts of abs(input) are kept as integer vector x with abs(input[i]) = intPart[i] + x[i+1]/x[0].
+	//A step of Brun's algorithm reduces the largest entry x[c] modulo the second largest x[b],
+	//the iteration matrix keeps x_in = result*x by adding a multiple of column c to column b.
+	//Column c of the matrix is the approximation result(i+1, c)/result(0, c) which becomes exact once all other entries of x are 0.
+	std::size_t n = input.size();
+	std::vector<mpz_class> intPart(n);
+	std::vector<mpz_class> x(n+1);
+	mpz_class err, maxErr, d, k;
+	x[0] = 1;
+	for(const mpq_class & v : input) {
+		mpz_lcm(x[0].get_mpz_t(), x[0].get_mpz_t(), v.get_den_mpz_t());
+	}
+	for(std::size_t i(0); i < n; ++i) {
+		mpz_class & xi = x[i+1];
+		mpz_abs(xi.get_mpz_t(), input[i].get_num_mpz_t());
+		mpz_fdiv_qr(intPart[i].get_mpz_t(), xi.get_mpz_t(), xi.get_mpz_t(), input[i].get_den_mpz_t());
+		mpz_divexact(k.get_mpz_t(), x[0].get_mpz_t(), input[i].get_den_mpz_t());
+		xi *= k;
+	}
+	const std::vector<mpz_class> xIn(x);
+	
+	Matrix result( Matrix::identity(n+1) );
+	
+	mpz_class maxDen = mpz_class(1) << significands;
+	//best distance for ST_GUARANTEE_SIZE is bestNum/bestDen
+	mpz_class bestNum(1), bestDen(1);
+	//later steps change the columns, hence the approximation is copied to output right away
+	auto setOutput = [&output, &result, n](std::size_t c) {
+		for(std::size_t i(0); i < n; ++i) {
+			output[i] = mpq_class(result(i+1, c), result(0, c));
+			output[i].canonicalize();
+		}
+	};
+	bool done = false;
+	
+	while(true) {
+		//c is the largest and b the second largest entry of x, ties are resolved by the smaller index
+		std::size_t c = 0;
+		for(std::size_t i(1); i <= n; ++i) {
+			if (x[i] > x[c]) {
+				c = i;
+			}
+		}
+		const mpz_class & q = result(0, c);
+		if (q > 0) {
+			//input_i - p_i/q = err_i/(q*x_in[0])
+			maxErr = 0;
+			for(std::size_t i(1); i <= n; ++i) {
+				err = result(i, c)*xIn[0] - xIn[i]*q;
+				if (mpz_cmpabs(err.get_mpz_t(), maxErr.get_mpz_t()) > 0) {
+					mpz_abs(maxErr.get_mpz_t(), err.get_mpz_t());
+				}
+			}
+			d = q*xIn[0];
+			if (mode & ST_GUARANTEE_DISTANCE) {
+				if ((maxErr << significands) <= d) {
+					setOutput(c);
+					done = true;
+					break;
+				}
+			}
+			else if (mode & ST_GUARANTEE_SIZE) {
+				bool fits = true;
+				for(std::size_t i(1); fits && i <= n; ++i) {
+					mpz_gcd(k.get_mpz_t(), result(i, c).get_mpz_t(), q.get_mpz_t());
+					fits = q <= k*maxDen;
+				}
+				if (!fits) {
+					break;
+				}
+				if (maxErr*bestDen < bestNum*d) {
+					bestNum = maxErr;
+					bestDen = d;
+					setOutput(c);
+				}
+			}
+		}
+		std::size_t b = (c == 0 ? 1 : 0);
+		for(std::size_t i(0); i <= n; ++i) {
+			if (i != c && x[i] > x[b]) {
+				b = i;
+			}
+		}
+		if (x[b] == 0) {
+			break;
+		}
+		mpz_fdiv_qr(k.get_mpz_t(), x[c].get_mpz_t(), x[c].get_mpz_t(), x[b].get_mpz_t());
+		for(std::size_t i(0); i <= n; ++i) {
+			mpz_addmul(result(i, b).get_mpz_t(), k.get_mpz_t(), result(i, c).get_mpz_t());
+		}
+	}
+	//the last column is exact, hence ST_GUARANTEE_DISTANCE is always satisfied
+	assert(done || !(mode & ST_GUARANTEE_DISTANCE));
+	(void) done;
+	
+	for(std::size_t i(0); i < n; ++i) {
+		output[i] += intPart[i];
+		if (input[i] < 0) {
+			output[i] = -output[i];
+		}
+	}
+}
+
 mpq_class Calc::snap(const mpfr::mpreal& v, int st, int significands) const {
+	if ((st & ST_FX) && !(st & ST_CF)) {
+		mpq_class result;
+		if (internal::FixpointFast::snap(v, significands, result)) {
+			return result;
+		}
+	}
 	if (!isfinite(v)) {
 		throw std::runtime_error("Calc::snap: v=" + v.toString() + " is not finite");
 	}
@@ -617,7 +646,7 @@ mpq_class Calc::snap(const mpfr::mpreal& v, int st, int significands) const {
 			);
 		}
 		else {
-			return contFrac(snap(v, ST_FX, significands+2), significands+1, st & ST_GUARANTEE_MASK);
+			return contFrac(snap(v, ST_FX, significands+2), significands+1, st & (ST_GUARANTEE_MASK|ST_CF_ENGINE_MASK));
 		}
 	}
 	else if (st & ST_FX) {
@@ -638,6 +667,54 @@ mpq_class Calc::snap(const mpfr::mpreal& v, int st, int significands) const {
 	}
 }
 
+void Calc::snap(mpq_class & result, const mpfr::mpreal & v, int st, int significands, Scratch & scratch) const {
+	//abs(v) >= 1 and everything else that needs more than a single conversion uses the general version
+	if (!(st & (ST_CF|ST_FX|ST_FL)) || !mpfr_number_p(v.mpfr_srcptr()) ||
+		(mpfr_regular_p(v.mpfr_srcptr()) && mpfr_get_exp(v.mpfr_srcptr()) > 0) ||
+		((st & ST_CF) && v.getPrecision() < significands+2))
+	{
+		result = snap(v, st, significands);
+	}
+	else if (st & ST_CF) {
+		snap(scratch.q, v, ST_FX, significands+2, scratch);
+		contFrac(result, scratch.q, significands+1, st & (ST_GUARANTEE_MASK|ST_CF_ENGINE_MASK), scratch);
+	}
+	else if (st & ST_FX) {
+		if (!internal::FixpointFast::snap(v, significands, result)) {
+			toFixpoint(scratch.ft, v, significands);
+			Conversion<mpfr::mpreal>::toMpq(scratch.ft, result, scratch.f);
+		}
+	}
+	else if (significands > 0 && significands != v.getPrecision()) { //ST_FL
+		internal::setPrecision(scratch.ft, significands, false);
+		mpfr_set(scratch.ft.mpfr_ptr(), v.mpfr_srcptr(), mpfr::mpreal::get_default_rnd());
+		Conversion<mpfr::mpreal>::toMpq(scratch.ft, result, scratch.f);
+	}
+	else {
+		Conversion<mpfr::mpreal>::toMpq(v, result, scratch.f);
+	}
+}
+
+mpq_class Calc::snap(double v, int st, int significands) const {
+	mpq_class result;
+	//mpfr::mpreal(v) is only exact if the default precision is large enough
+	if (!(st & ST_FX) || (st & ST_CF) || mpfr::mpreal::get_default_prec() < 53 ||
+		!internal::FixpointFast::snap(v, significands, result))
+	{
+		result = snap(mpfr::mpreal(v), st, significands);
+	}
+	return result;
+}
+
+void Calc::snap(mpq_class & result, double v, int st, int significands, Scratch & scratch) const {
+	if (!(st & ST_FX) || (st & ST_CF) || mpfr::mpreal::get_default_prec() < 53 ||
+		!internal::FixpointFast::snap(v, significands, result))
+	{
+		//scratch.ft is used by the mpfr::mpreal version, hence we need a new variable here
+		snap(result, mpfr::mpreal(v), st, significands, scratch);
+	}
+}
+
 mpq_class
 Calc::snap(const mpq_class & v, int st, int significands) const {
 	mpq_class result;
@@ -661,7 +738,7 @@ Calc::snap(const mpq_class & v, int st, const mpq_class & eps) const {
 	if (st & ST_CF) {
 		mpq_class lower = v - eps;
 		mpq_class upper = v + eps;
-		result = within(lower, upper);
+		result = within(lower, upper, st & ST_CF_ENGINE_MASK);
 	}
 	else {
 		mpz_class tmp = eps.get_num() / eps.get_den() + int(eps.get_num() % eps.get_den() > 0);
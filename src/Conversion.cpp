@@ -166,14 +166,19 @@ Conversion<mpfr::mpreal>::moveFrom(const mpq_class & v) {
 
 mpq_class
 Conversion<mpfr::mpreal>::toMpq(const type & v) {
+	mpq_class result;
+	mpf_class tmpf;
+	toMpq(v, result, tmpf);
+	return result;
+}
+
+void
+Conversion<mpfr::mpreal>::toMpq(const type & v, mpq_class & result, mpf_class & tmp) {
 	if (!isfinite(v)) {
 		throw std::overflow_error("Conversion<mpfr::mpreal>: Cannot convert infinite value to rational");
 	}
-	mpf_class tmpf;
-	::mpfr_get_f(tmpf.get_mpf_t(), v.mpfr_xsrcptr(), MPFR_RNDZ);
-	
-	mpq_class result(tmpf);
-	return result;
+	::mpfr_get_f(tmp.get_mpf_t(), v.mpfr_xsrcptr(), MPFR_RNDZ);
+	::mpq_set_f(result.get_mpq_t(), tmp.get_mpf_t());
 }
 
 const mpfr::mpreal &
@@ -1,7 +1,63 @@
 #include <libratss/GeoCalc.h>
 
 namespace LIB_RATSS_NAMESPACE {
+namespace {
+
+bool isDouble(const mpfr::mpreal & v) {
+	return mpfr_number_p(v.mpfr_srcptr()) && mpfr_cmp_d(v.mpfr_srcptr(), mpfr_get_d(v.mpfr_srcptr(), MPFR_RNDN)) == 0;
+}
+
+} //end namespace
+
+GeoCalc::TrigCache::TrigCache(std::size_t maxEntries) :
+m_maxEntries(std::max<std::size_t>(maxEntries, 2)),
+m_hits(0),
+m_misses(0)
+{}
+
+void GeoCalc::TrigCache::clear() {
+	m_entries.clear();
+}
+
+void GeoCalc::TrigCache::reserve(std::size_t count) {
+	if (m_entries.size() + count > m_maxEntries) {
+		m_entries.clear();
+	}
+}
 
+const GeoCalc::TrigCache::Entry & GeoCalc::TrigCache::get(const mpfr::mpreal & deg, int calcPrecision) {
+	//deg/180 is rounded to the precision of deg, hence the key contains both precisions
+	mpfr_srcptr v = deg.mpfr_srcptr();
+	mpfr_prec_t prec = mpfr_get_prec(v);
+	m_key.clear();
+	m_key.append(reinterpret_cast<const char*>(&prec), sizeof(prec));
+	m_key.append(reinterpret_cast<const char*>(&calcPrecision), sizeof(calcPrecision));
+	if (mpfr_regular_p(v)) {
+		int sign = mpfr_signbit(v);
+		mpfr_exp_t exp = mpfr_get_exp(v);
+		m_key.append(reinterpret_cast<const char*>(&sign), sizeof(sign));
+		m_key.append(reinterpret_cast<const char*>(&exp), sizeof(exp));
+		m_key.append(static_cast<const char*>(mpfr_custom_get_significand(v)), mpfr_custom_get_size(prec));
+	}
+	else {
+		//zero keeps its sign, nan and inf are not worth caching but still need a unique key
+		int kind = mpfr_zero_p(v) ? (mpfr_signbit(v) ? -1 : 1) : 2;
+		m_key.append(reinterpret_cast<const char*>(&kind), sizeof(kind));
+	}
+	auto it = m_entries.find(m_key);
+	if (it != m_entries.end()) {
+		++m_hits;
+		return it->second;
+	}
+	++m_misses;
+	Entry & e = m_entries[m_key];
+	auto pi = mpfr::const_pi(calcPrecision);
+	mpfr::mpreal rad = deg/180 * pi;
+	e.sin.setPrecision(rad.getPrecision());
+	e.cos.setPrecision(rad.getPrecision());
+	mpfr_sin_cos(e.sin.mpfr_ptr(), e.cos.mpfr_ptr(), rad.mpfr_srcptr(), MPFR_RNDN);
+	return e;
+}
 
 bool GeoCalc::isOnSphere(const mpfr::mpreal & mpdx, const mpfr::mpreal & mpdy, const mpfr::mpreal & mpdz) const {
 	return (add(add(sq(mpdx), sq(mpdy)), sq(mpdz)) == 1);
@@ -59,6 +115,56 @@ void GeoCalc::cartesian(const mpfr::mpreal & lat, const mpfr::mpreal & lon, mpfr
 	z = sin(lat_rad);
 }
 
+void GeoCalc::cartesian(const mpfr::mpreal & lat, const mpfr::mpreal & lon, mpfr::mpreal & x, mpfr::mpreal & y, mpfr::mpreal & z, TrigCache & cache) const {
+	int outputPrecision = std::max<int>(std::max<int>(x.getPrecision(), y.getPrecision()), z.getPrecision());
+	int inputPrecision = std::max<int>(lat.getPrecision(), lon.getPrecision());
+	int calcPrecision = std::max<int>(inputPrecision, outputPrecision);
+	
+	cache.reserve(2);
+	const TrigCache::Entry & latTrig = cache.get(lat, calcPrecision);
+	const TrigCache::Entry & lonTrig = cache.get(lon, calcPrecision);
+	
+	x = mult(lonTrig.cos, latTrig.cos);
+	y = mult(lonTrig.sin, latTrig.cos);
+	z = latTrig.sin;
+}
+
+void GeoCalc::cartesian(double lat, double lon, internal::DoubleDouble & x, internal::DoubleDouble & y, internal::DoubleDouble & z) const {
+	internal::DoubleDouble sinLat, cosLat, sinLon, cosLon;
+	internal::DegreeSinCos::sinCos(lat, sinLat, cosLat);
+	internal::DegreeSinCos::sinCos(lon, sinLon, cosLon);
+	
+	//the products add 2^-100 to the error of sine and cosine, rounding adds another 2^-104
+	x = cosLon * cosLat;
+	y = sinLon * cosLat;
+	z = sinLat;
+}
+
+bool GeoCalc::cartesian(const mpfr::mpreal & lat, const mpfr::mpreal & lon, mpfr::mpreal & x, mpfr::mpreal & y, mpfr::mpreal & z, int accuracy, TrigCache * cache) const {
+	if (accuracy > cartesian_dd_accuracy || !isDouble(lat) || !isDouble(lon)) {
+		if (cache) {
+			cartesian(lat, lon, x, y, z, *cache);
+		}
+		else {
+			cartesian(lat, lon, x, y, z);
+		}
+		return false;
+	}
+	int outputPrecision = std::max<int>(std::max<int>(x.getPrecision(), y.getPrecision()), z.getPrecision());
+	int inputPrecision = std::max<int>(lat.getPrecision(), lon.getPrecision());
+	int calcPrecision = std::max<int>(inputPrecision, outputPrecision);
+	
+	internal::DoubleDouble xdd, ydd, zdd;
+	cartesian(mpfr_get_d(lat.mpfr_srcptr(), MPFR_RNDN), mpfr_get_d(lon.mpfr_srcptr(), MPFR_RNDN), xdd, ydd, zdd);
+	for(mpfr::mpreal * v : {&x, &y, &z}) {
+		mpfr_set_prec(v->mpfr_ptr(), calcPrecision);
+	}
+	xdd.toMpreal(x);
+	ydd.toMpreal(y);
+	zdd.toMpreal(z);
+	return true;
+}
+
 void GeoCalc::cartesianFromSpherical(const mpfr::mpreal & theta, const mpfr::mpreal & phi, mpfr::mpreal & x, mpfr::mpreal & y, mpfr::mpreal & z) const {
 	mpfr::mpreal sinTheta = sin(theta);
 	x = mult(sinTheta, cos (phi));
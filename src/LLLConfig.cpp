@@ -0,0 +1,137 @@
+#include <libratss/LLLConfig.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace LIB_RATSS_NAMESPACE {
+
+LLLConfig::LLLConfig() :
+LLLConfig(M_AUTO, FT_AUTO)
+{}
+
+LLLConfig::LLLConfig(Method method, FloatType floatType, int precision, bool earlyReduction) :
+m_method(method),
+m_floatType(floatType),
+m_precision(precision),
+m_earlyReduction(earlyReduction)
+{}
+
+LLLConfig::LLLConfig(const LLLConfig & other) :
+m_method(other.m_method),
+m_floatType(other.m_floatType),
+m_precision(other.m_precision),
+m_earlyReduction(other.m_earlyReduction)
+{}
+
+LLLConfig & LLLConfig::operator=(const LLLConfig & other) {
+	m_method = other.m_method;
+	m_floatType = other.m_floatType;
+	m_precision = other.m_precision;
+	m_earlyReduction = other.m_earlyReduction;
+	return *this;
+}
+
+bool LLLConfig::operator==(const LLLConfig & other) const {
+	return m_method == other.m_method && m_floatType == other.m_floatType &&
+		m_precision == other.m_precision && m_earlyReduction == other.m_earlyReduction;
+}
+
+bool LLLConfig::operator!=(const LLLConfig & other) const {
+	return !(*this == other);
+}
+
+LLLConfig LLLConfig::select(int dimension, std::size_t entryBits) const {
+	LLLConfig result(*this);
+	if (m_method == M_AUTO && m_floatType == FT_AUTO) {
+		//the lattices of SimApxLLL are of knapsack type which is what early reduction is made for
+		result.m_earlyReduction = true;
+	}
+	if (m_method == M_WRAPPER) {
+		//the wrapper chooses the float type itself
+		result.m_floatType = FT_AUTO;
+		result.m_precision = 0;
+		return result;
+	}
+	if (m_method == M_FAST && m_floatType == FT_AUTO) {
+		result.m_floatType = FT_DOUBLE;
+	}
+	if (result.m_floatType == FT_AUTO) {
+		int prec = requiredPrecision(dimension);
+		//The Gram matrix holds products of entries, their exponent has to fit as well
+		if (prec <= std::numeric_limits<double>::digits && 2*entryBits < std::size_t(std::numeric_limits<double>::max_exponent)) {
+			result.m_floatType = FT_DOUBLE;
+		}
+		else if (prec <= std::numeric_limits<double>::digits) {
+			result.m_floatType = FT_DPE;
+		}
+		else if (prec <= std::numeric_limits<long double>::digits && 2*entryBits < std::size_t(std::numeric_limits<long double>::max_exponent)) {
+			result.m_floatType = FT_LONG_DOUBLE;
+		}
+		else {
+			result.m_floatType = FT_MPFR;
+			result.m_precision = prec;
+		}
+	}
+	if (result.m_method == M_AUTO) {
+		//a float type without enough precision may fail, the wrapper increases the precision on its own
+		if (result.proved(dimension)) {
+			result.m_method = M_PROVED;
+		}
+		else {
+			result.m_method = M_WRAPPER;
+			result.m_floatType = FT_AUTO;
+			result.m_precision = 0;
+		}
+	}
+	return result;
+}
+
+bool LLLConfig::proved(int dimension) const {
+	if (m_floatType == FT_MPFR && m_precision == 0) {
+		return true; //fplll chooses the precision
+	}
+	return mantissaBits(m_floatType, m_precision) >= requiredPrecision(dimension);
+}
+
+LLLConfig LLLConfig::exact(int dimension) {
+	return LLLConfig(M_PROVED, FT_MPFR, requiredPrecision(dimension));
+}
+
+int LLLConfig::requiredPrecision(int dimension) {
+	constexpr double epsilon = 0.01;
+	double rho = (1.0 + default_eta)*(1.0 + default_eta) / (default_delta - default_eta*default_eta);
+	double d = std::max(dimension, 2);
+	return int(10 + 2*std::log2(d) - std::log2(epsilon) + d*std::log2(rho));
+}
+
+int LLLConfig::mantissaBits(FloatType ft, int precision) {
+	switch (ft) {
+	case FT_DOUBLE:
+	case FT_DPE:
+		return std::numeric_limits<double>::digits;
+	case FT_LONG_DOUBLE:
+		return std::numeric_limits<long double>::digits;
+	case FT_MPFR:
+		return precision;
+	default:
+		return -1;
+	}
+}
+
+std::string LLLConfig::toString(const LLLConfig & cfg) {
+	static const char * methods[] = {"auto", "wrapper", "fast", "heuristic", "proved"};
+	static const char * floatTypes[] = {"auto", "double", "long double", "dpe", "mpfr"};
+	std::string result = methods[cfg.method()];
+	result += ":";
+	result += floatTypes[cfg.floatType()];
+	if (cfg.floatType() == FT_MPFR && cfg.precision()) {
+		result += "(" + std::to_string(cfg.precision()) + ")";
+	}
+	if (cfg.earlyReduction()) {
+		result += ":early";
+	}
+	return result;
+}
+
+}//end namespace LIB_RATSS_NAMESPACE
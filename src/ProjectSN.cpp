@@ -10,13 +10,15 @@ SnapConfig(ST_FX | ST_NORMALIZE | ST_PLANE, 53)
 ProjectSN::SnapConfig::SnapConfig(int st, int precision, int significands) :
 m_st(st),
 m_precision(precision),
-m_significands(significands)
+m_significands(significands),
+m_autoThreads(1)
 {}
 
 ProjectSN::SnapConfig::SnapConfig(int st, int significands) :
 m_st(st),
 m_precision(-1),
-m_significands(significands)
+m_significands(significands),
+m_autoThreads(1)
 {
 	if (significands < 1) {
 		throw std::underflow_error("ratss::ProjectSN::SnapConfig: significands < 1");
@@ -26,7 +28,10 @@ m_significands(significands)
 ProjectSN::SnapConfig::SnapConfig(const SnapConfig & other) :
 m_st(other.m_st),
 m_precision(other.m_precision),
-m_significands(other.m_significands)
+m_significands(other.m_significands),
+m_lll(other.m_lll),
+m_autoThreads(other.m_autoThreads),
+m_cache(other.m_cache)
 {}
 
 ProjectSN::SnapConfig &
@@ -34,6 +39,9 @@ ProjectSN::SnapConfig::operator=(const SnapConfig & other) {
 	m_st = other.m_st;
 	m_precision = other.m_precision;
 	m_significands = other.m_significands;
+	m_lll = other.m_lll;
+	m_autoThreads = other.m_autoThreads;
+	m_cache = other.m_cache;
 	return *this;
 }
 
@@ -60,6 +68,30 @@ int ProjectSN::SnapConfig::significands(int) const {
 	return m_significands;
 }
 
+const LLLConfig & ProjectSN::SnapConfig::lll() const {
+	return m_lll;
+}
+
+void ProjectSN::SnapConfig::setLLL(const LLLConfig & v) {
+	m_lll = v;
+}
+
+std::size_t ProjectSN::SnapConfig::autoThreads() const {
+	return m_autoThreads;
+}
+
+void ProjectSN::SnapConfig::setAutoThreads(std::size_t v) {
+	m_autoThreads = v;
+}
+
+const std::shared_ptr<SnapCache> & ProjectSN::SnapConfig::cache() const {
+	return m_cache;
+}
+
+void ProjectSN::SnapConfig::setCache(const std::shared_ptr<SnapCache> & v) {
+	m_cache = v;
+}
+
 std::string ProjectSN::toString(ProjectSN::SnapType st) {
 	std::string result;
 	#define PRINT_FIELD_NAME(__NAME) if ((st & __NAME) == __NAME) { result += #__NAME "|"; }
@@ -78,6 +110,9 @@ std::string ProjectSN::toString(ProjectSN::SnapType st) {
 	PRINT_FIELD_NAME(ST_FPLLL)
 	PRINT_FIELD_NAME(ST_BRUTE_FORCE)
 	PRINT_FIELD_NAME(ST_NORMALIZE)
+	PRINT_FIELD_NAME(ST_CF_LEHMER)
+	PRINT_FIELD_NAME(ST_CF_HALF_GCD)
+	PRINT_FIELD_NAME(ST_FPLLL_WARM_START)
 	
 	if (result.size()) {
 		result.pop_back();
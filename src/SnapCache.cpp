@@ -0,0 +1,80 @@
+#include <libratss/SnapCache.h>
+
+namespace LIB_RATSS_NAMESPACE {
+
+SnapCache::SnapCache(std::size_t capacity) :
+m_entries(std::max<std::size_t>(1, (capacity+ways-1)/ways)*ways),
+m_hands(m_entries.size()/ways, 0),
+m_locks(new std::mutex[num_locks])
+{}
+
+SnapCache::~SnapCache() {}
+
+std::size_t SnapCache::findEntry(std::size_t set, std::size_t hash, const std::string & key) const {
+	const Entry * entries = m_entries.data() + set*ways;
+	std::size_t way = 0;
+	for(; way < ways; ++way) {
+		const Entry & e = entries[way];
+		if (e.valid && e.hash == hash && e.key == key) {
+			break;
+		}
+	}
+	return way;
+}
+
+void SnapCache::insert(const std::string & key, const std::vector<mpq_class> & point) {
+	std::size_t hash = std::hash<std::string>()(key);
+	std::size_t set = setOf(hash);
+	std::lock_guard<std::mutex> lck(lockOf(set));
+	Entry * entries = m_entries.data() + set*ways;
+	std::size_t way = findEntry(set, hash, key);
+	if (way < ways) { //another thread snapped the same point in the meantime
+		entries[way].referenced = true;
+		return;
+	}
+	for(way = 0; way < ways && entries[way].valid; ++way) {}
+	if (way == ways) {
+		//CLOCK: entries that were used since the hand passed them get a second chance
+		unsigned char & hand = m_hands[set];
+		for(; entries[hand].referenced; hand = (hand+1) % ways) {
+			entries[hand].referenced = false;
+		}
+		way = hand;
+		hand = (hand+1) % ways;
+		m_evictions.fetch_add(1, std::memory_order_relaxed);
+	}
+	Entry & e = entries[way];
+	e.hash = hash;
+	e.key = key;
+	e.point.assign(point.begin(), point.end());
+	e.valid = true;
+	e.referenced = false;
+}
+
+void SnapCache::clear() {
+	for(std::size_t i(0); i < num_locks; ++i) {
+		m_locks[i].lock();
+	}
+	for(Entry & e : m_entries) {
+		e.valid = false;
+		e.referenced = false;
+	}
+	std::fill(m_hands.begin(), m_hands.end(), 0);
+	for(std::size_t i(0); i < num_locks; ++i) {
+		m_locks[i].unlock();
+	}
+}
+
+double SnapCache::hitRate() const {
+	std::size_t h = hits();
+	std::size_t total = h + misses();
+	return total ? double(h)/double(total) : 0.0;
+}
+
+void SnapCache::resetCounters() {
+	m_hits = 0;
+	m_misses = 0;
+	m_evictions = 0;
+}
+
+}//end namespace LIB_RATSS_NAMESPACE
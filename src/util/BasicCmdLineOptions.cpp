@@ -41,6 +41,9 @@ BasicCmdLineOptions::SnapTypeHelper::SnapTypeHelper() {
 	ENTRY(PLANE, "P", "Snap in the plane")
 	ENTRY(PAPER, "PAPER", "Use Core::Expr to correctly scale down points to the plane.")
 	ENTRY(NORMALIZE, "N", "Normalize input to 1 before snapping.")
+	ENTRY(CF_LEHMER, "CFL", "Compute continued fractions with Lehmer's algorithm")
+	ENTRY(CF_HALF_GCD, "CFH", "Compute continued fractions with a recursive half-gcd, use for very large inputs")
+	ENTRY(FPLLL_WARM_START, "LLLW", "Reuse reduced bases while searching N for fplll")
 #undef ENTRY
 	
 // 	ENTRY(PAPER2, "PAPER2", "Use Core2::Expr to correctly scale down point to the plane. Also support geo points as input.")
@@ -232,6 +235,28 @@ int BasicCmdLineOptions::parse(int argc, char ** argv) {
 				++i;
 			}
 		}
+		else if (token == "--stats-format") {
+			if (i+1 < argc) {
+				std::string sfStr(argv[i+1]);
+				if (sfStr == "text") {
+					statsFormat = SF_TEXT;
+				}
+				else if (sfStr == "json") {
+					statsFormat = SF_JSON;
+				}
+				else if (sfStr == "csv") {
+					statsFormat = SF_CSV;
+				}
+				else {
+					std::cerr << "Unrecognized stats format: " << sfStr << std::endl;
+					return -1;
+				}
+				++i;
+			}
+			else {
+				return -1;
+			}
+		}
 		else if (token == "-if") {
 			if (i+1 < argc) {
 				std::string stStr(argv[i+1]);
@@ -250,6 +275,9 @@ int BasicCmdLineOptions::parse(int argc, char ** argv) {
 				else if (stStr == "split" || stStr == "sr") {
 					inFormat = FloatPoint::FM_CARTESIAN_SPLIT_RATIONAL;
 				}
+				else if (stStr == "binary" || stStr == "b") {
+					inFormat = FloatPoint::FM_BINARY;
+				}
 				else {
 					std::cerr << "Unrecognized input format: " << stStr << std::endl;
 				}
@@ -268,6 +296,9 @@ int BasicCmdLineOptions::parse(int argc, char ** argv) {
 				else if (stStr == "split" || stStr == "sr") {
 					outFormat = RationalPoint::FM_SPLIT_RATIONAL;
 				}
+				else if (stStr == "homogeneous" || stStr == "h") {
+					outFormat = RationalPoint::FM_HOMOGENEOUS;
+				}
 				else if (stStr == "float" || stStr == "double" || stStr == "d" || stStr == "f") {
 					outFormat = RationalPoint::FM_FLOAT;
 				}
@@ -280,6 +311,15 @@ int BasicCmdLineOptions::parse(int argc, char ** argv) {
 				else if (stStr == "spherical" || stStr == "sl") {
 					outFormat = RationalPoint::FM_SPHERICAL;
 				}
+				else if (stStr == "binary" || stStr == "b" || stStr == "binary-rational" || stStr == "br") {
+					outFormat = RationalPoint::FM_BINARY_RATIONAL;
+				}
+				else if (stStr == "binary-float" || stStr == "binary-double" || stStr == "bf" || stStr == "bd") {
+					outFormat = RationalPoint::FM_BINARY_FLOAT;
+				}
+				else if (stStr == "binary-float128" || stStr == "bf128") {
+					outFormat = RationalPoint::FM_BINARY_FLOAT128;
+				}
 				else {
 					std::cerr << "Unrecognized output format: " << stStr << std::endl;
 				}
@@ -298,6 +338,20 @@ int BasicCmdLineOptions::parse(int argc, char ** argv) {
 		else if (token == "--rational-pass-through") {
 			rationalPassThrough = true;
 		}
+		else if (token == "--cache") {
+			if (i+1 < argc) {
+				int n = ::atoi(argv[i+1]);
+				if (n < 0) {
+					std::cerr << "Cache size has to be >= 0" << std::endl;
+					return -1;
+				}
+				cacheSize = n;
+				++i;
+			}
+			else {
+				return -1;
+			}
+		}
 		else if (token == "-h" || token == "--help") {
 			return 0;
 		}
@@ -337,6 +391,10 @@ int BasicCmdLineOptions::parse(int argc, char ** argv) {
 	
 	parse_completed();
 	
+	if (statsFormat != SF_TEXT && !stats) {
+		stats = SM_SUM | SM_SIZE_IN_BITS | SM_DISTANCE_DOUBLE;
+	}
+	
 	if (stats && !(stats & (SM_EACH|SM_SUM))) {
 		stats |= SM_SUM;
 	}
@@ -356,17 +414,19 @@ void BasicCmdLineOptions::options_help(std::ostream& out) const {
 		"\t--verbose\tverbose\n"
 		"\t--progress\tprogress indicators\n"
 		"\t--stats <which>\tStatistics sum|each+bits|distr|dist\n"
+		"\t--stats-format (text|json|csv)\tformat of the summary statistics, json and csv contain percentiles and timings\n"
 		"\nComputation options\n"
 		"\t-c num\tset the precision of the input and the precision of subsequent computations in bits.\n"
 		"\t-p k\tset significands to k which translates to an epsilon of 2^-k\n"
 		"\t-Q num\tset the largest possible denominator. Only useful for brute force and lll modes.\n"
 		"\t-e rational\tset a specific epsilon given as a rational.\n"
+		"\t--cache num\tkeep up to num snapped points to reuse them for duplicate input points.\n"
 		"\nInput options:\n"
 		"\t--rational-pass-through\t don't snap rational input coordinates\n"
-		"\t-if format\tset input format: [spherical, geo, cartesian=[rational, split, float, float128]]\n"
+		"\t-if format\tset input format: [spherical, geo, cartesian=[rational, split, float, float128], binary (proj only)]\n"
 		"\t-i\tpath to input\n"
 		"\t--stats (sum|each|bits|distance)\tCompute statistics for all points (sum) or each point.\n"
-		"\t-of format\tset output format: [spherical, geo, rational, split, float, float128]\n"
+		"\t-of format\tset output format: [spherical, geo, rational, split, homogeneous, float, float128, binary-rational, binary-float, binary-float128 (binary formats: proj only)]\n"
 		"\t-o\tpath to output\n"
 		"\n-s snap type flags: \n";
 	for(auto st : m_sth.types()) {
@@ -380,6 +440,9 @@ void BasicCmdLineOptions::options_selection(std::ostream& out) const {
 		out << "Significands: " << significands << '\n';
 	}
 	out << "Snap type: " << m_sth.toString(snapType) << '\n';
+	if (cacheSize) {
+		out << "Cache size: " << cacheSize << '\n';
+	}
 	out << "Input format: ";
 	if (inFormat == FloatPoint::FM_GEO) {
 		out << "geo";
@@ -402,6 +465,12 @@ void BasicCmdLineOptions::options_selection(std::ostream& out) const {
 			out << " pass-through";
 		}
 	}
+	else if (inFormat == FloatPoint::FM_BINARY) {
+		out << "binary";
+		if (rationalPassThrough) {
+			out << " pass-through";
+		}
+	}
 	out << '\n';
 	out << "Output format: ";
 #define FORMAT_CASE(__ENUM, __STR) case RationalPoint::__ENUM: out << __STR; break;
@@ -411,7 +480,12 @@ void BasicCmdLineOptions::options_selection(std::ostream& out) const {
 		FORMAT_CASE(FM_RATIONAL, "rational")
 		FORMAT_CASE(FM_FLOAT, "float")
 		FORMAT_CASE(FM_SPLIT_RATIONAL, "split rational")
+		FORMAT_CASE(FM_HOMOGENEOUS, "homogeneous")
 		FORMAT_CASE(FM_FLOAT128, "float128")
+		FORMAT_CASE(FM_BINARY_RATIONAL, "binary rational")
+		FORMAT_CASE(FM_BINARY_FLOAT, "binary float")
+		FORMAT_CASE(FM_BINARY_FLOAT128, "binary float128")
+		FORMAT_CASE(FM_BINARY, "binary")
 		FORMAT_CASE(FM_INVALID, "invalid")
 	};
 #undef FORMAT_CASE
@@ -0,0 +1,352 @@
+#include <libratss/util/BinaryPointStream.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace LIB_RATSS_NAMESPACE {
+namespace {
+
+const char magic[8] = {'R', 'A', 'T', 'S', 'S', 'B', 'P', 'S'};
+const std::uint8_t version = 1;
+
+std::uint8_t hostByteOrder() {
+	std::uint16_t v = 1;
+	std::uint8_t b;
+	std::memcpy(&b, &v, 1);
+	return b;
+}
+
+std::size_t numLimbs(mpfr_prec_t precision) {
+	return mpfr_custom_get_size(precision) / sizeof(mp_limb_t);
+}
+
+//numbers with more limbs are rejected before anything is allocated for them (2^30 bits with 64 bit limbs)
+const std::size_t maxLimbs = std::size_t(1) << 24;
+
+} //end namespace
+
+BinaryPointHeader::BinaryPointHeader(Encoding encoding, std::uint32_t dimension, std::int32_t precision) :
+encoding(encoding),
+dimension(dimension),
+precision(precision)
+{}
+
+BinaryPointHeader BinaryPointHeader::fromFormat(PointBase::Format fmt, std::uint32_t dimension) {
+	switch (fmt) {
+	case PointBase::FM_BINARY_RATIONAL:
+		return BinaryPointHeader(BE_RATIONAL, dimension, 0);
+	case PointBase::FM_BINARY_FLOAT:
+		return BinaryPointHeader(BE_DOUBLE, dimension, 53);
+	case PointBase::FM_BINARY_FLOAT128:
+		return BinaryPointHeader(BE_MPFR, dimension, 128);
+	default:
+		throw std::runtime_error("ratss::BinaryPointHeader::fromFormat: not a binary output format");
+	};
+}
+
+void BinaryPointHeader::read(std::istream & is) {
+	char buffer[24];
+	is.read(buffer, sizeof(buffer));
+	if (is.gcount() != sizeof(buffer) || std::memcmp(buffer, magic, sizeof(magic)) != 0) {
+		throw std::runtime_error("ratss::BinaryPointHeader::read: input is not a binary point stream");
+	}
+	if (std::uint8_t(buffer[8]) != version) {
+		throw std::runtime_error("ratss::BinaryPointHeader::read: unsupported version");
+	}
+	if (std::uint8_t(buffer[10]) != sizeof(mp_limb_t) || std::uint8_t(buffer[11]) != hostByteOrder()) {
+		throw std::runtime_error("ratss::BinaryPointHeader::read: stream was written on a machine with a different limb size or byte order");
+	}
+	encoding = Encoding(buffer[9]);
+	std::memcpy(&dimension, buffer+12, sizeof(dimension));
+	std::memcpy(&precision, buffer+16, sizeof(precision));
+	bool valid = false;
+	switch (encoding) {
+	case BE_DOUBLE:
+		valid = (precision == 53);
+		break;
+	case BE_MPFR:
+		valid = (MPFR_PREC_MIN <= precision && precision <= MPFR_PREC_MAX);
+		break;
+	case BE_RATIONAL:
+		valid = (precision == 0);
+		break;
+	default:
+		break;
+	};
+	if (!valid) {
+		throw std::runtime_error("ratss::BinaryPointHeader::read: invalid encoding or precision");
+	}
+}
+
+void BinaryPointHeader::write(std::ostream & os) const {
+	char buffer[24] = {0};
+	std::memcpy(buffer, magic, sizeof(magic));
+	buffer[8] = char(version);
+	buffer[9] = char(encoding);
+	buffer[10] = char(sizeof(mp_limb_t));
+	buffer[11] = char(hostByteOrder());
+	std::memcpy(buffer+12, &dimension, sizeof(dimension));
+	std::memcpy(buffer+16, &precision, sizeof(precision));
+	os.write(buffer, sizeof(buffer));
+}
+
+BinaryPointReader::BinaryPointReader(std::istream & is) :
+m_is(is)
+{
+	m_header.read(m_is);
+	if (m_header.encoding == BinaryPointHeader::BE_MPFR) {
+		if (numLimbs(m_header.precision) > maxLimbs) {
+			throw std::runtime_error("ratss::BinaryPointReader: precision too large");
+		}
+		m_limbs.resize(numLimbs(m_header.precision));
+	}
+	//the size of seekable streams bounds the size of the numbers in it
+	std::istream::pos_type pos = m_is.tellg();
+	if (pos != std::istream::pos_type(-1) && m_is.seekg(0, std::ios_base::end)) {
+		m_remaining = std::size_t(m_is.tellg() - pos);
+		m_is.seekg(pos);
+	}
+	else {
+		m_is.clear();
+	}
+}
+
+BinaryPointReader::~BinaryPointReader() {}
+
+bool BinaryPointReader::read(FloatPoint & p, int precision) {
+	if (!begin()) {
+		return false;
+	}
+	p.coords.resize(m_header.dimension);
+	for(mpfr::mpreal & v : p.coords) {
+		if (m_header.encoding == BinaryPointHeader::BE_DOUBLE) {
+			double d;
+			read(&d, sizeof(d));
+			v.setPrecision(53);
+			mpfr_set_d(v.mpfr_ptr(), d, MPFR_RNDN);
+		}
+		else if (m_header.encoding == BinaryPointHeader::BE_MPFR) {
+			read(v);
+		}
+		else {
+			mpq_class tmp;
+			read(tmp);
+			v = Conversion<mpq_class>::toMpreal(tmp, precision);
+		}
+	}
+	return true;
+}
+
+bool BinaryPointReader::read(RationalPoint & p) {
+	if (!begin()) {
+		return false;
+	}
+	p.coords.resize(m_header.dimension);
+	for(mpq_class & v : p.coords) {
+		if (m_header.encoding == BinaryPointHeader::BE_DOUBLE) {
+			double d;
+			read(&d, sizeof(d));
+			mpq_set_d(v.get_mpq_t(), d);
+		}
+		else if (m_header.encoding == BinaryPointHeader::BE_MPFR) {
+			read(m_ft);
+			if (!mpfr_number_p(m_ft.mpfr_srcptr())) {
+				throw std::runtime_error("ratss::BinaryPointReader::read: coordinate is not a number");
+			}
+			mpfr_get_q(v.get_mpq_t(), m_ft.mpfr_srcptr());
+		}
+		else {
+			read(v);
+		}
+	}
+	return true;
+}
+
+bool BinaryPointReader::begin() {
+	return m_is.peek() != std::istream::traits_type::eof();
+}
+
+void BinaryPointReader::read(void * data, std::size_t size) {
+	m_is.read(static_cast<char*>(data), size);
+	if (std::size_t(m_is.gcount()) != size) {
+		throw std::runtime_error("ratss::BinaryPointReader::read: truncated point");
+	}
+	m_remaining -= std::min(m_remaining, size);
+}
+
+void BinaryPointReader::read(mpfr::mpreal & v) {
+	std::int32_t kind;
+	std::int64_t exp;
+	read(&kind, sizeof(kind));
+	read(&exp, sizeof(exp));
+	if (kind < -MPFR_REGULAR_KIND || kind > MPFR_REGULAR_KIND) {
+		throw std::runtime_error("ratss::BinaryPointReader::read: invalid mpfr kind");
+	}
+	if (kind == MPFR_REGULAR_KIND || kind == -MPFR_REGULAR_KIND) {
+		read(m_limbs.data(), m_limbs.size()*sizeof(mp_limb_t));
+		if (exp < mpfr_get_emin() || exp > mpfr_get_emax() || !(m_limbs.back() >> (GMP_NUMB_BITS-1))) {
+			throw std::runtime_error("ratss::BinaryPointReader::read: invalid mpfr number");
+		}
+	}
+	mpfr_t tmp;
+	mpfr_custom_init_set(tmp, kind, exp, m_header.precision, m_limbs.data());
+	v.setPrecision(m_header.precision);
+	mpfr_set(v.mpfr_ptr(), tmp, MPFR_RNDN);
+}
+
+void BinaryPointReader::read(mpq_class & v) {
+	std::int32_t numSize;
+	std::uint32_t denSize;
+	read(&numSize, sizeof(numSize));
+	read(v.get_num_mpz_t(), numSize);
+	read(&denSize, sizeof(denSize));
+	if (!denSize || denSize > std::uint32_t(std::numeric_limits<std::int32_t>::max())) {
+		throw std::runtime_error("ratss::BinaryPointReader::read: invalid denominator");
+	}
+	read(v.get_den_mpz_t(), std::int32_t(denSize));
+	mpq_canonicalize(v.get_mpq_t());
+}
+
+void BinaryPointReader::read(mpz_ptr v, std::int32_t size) {
+	if (!size) {
+		mpz_set_ui(v, 0);
+		return;
+	}
+	if (size == std::numeric_limits<std::int32_t>::min()) {
+		throw std::runtime_error("ratss::BinaryPointReader::read: invalid number size");
+	}
+	mp_size_t n = (size < 0 ? -size : size);
+	if (std::size_t(n) > maxLimbs || std::size_t(n)*sizeof(mp_limb_t) > m_remaining) {
+		throw std::runtime_error("ratss::BinaryPointReader::read: number is larger than the remaining stream");
+	}
+	mp_limb_t * limbs = mpz_limbs_write(v, n);
+	read(limbs, n*sizeof(mp_limb_t));
+	if (!limbs[n-1]) {
+		throw std::runtime_error("ratss::BinaryPointReader::read: number is not normalized");
+	}
+	mpz_limbs_finish(v, size);
+}
+
+BinaryPointWriter::BinaryPointWriter(std::ostream & os, PointBase::Format fmt) :
+m_os(os),
+m_fmt(fmt)
+{
+	//check the format early
+	m_header = BinaryPointHeader::fromFormat(fmt, 0);
+	m_header.encoding = BinaryPointHeader::BE_INVALID;
+}
+
+BinaryPointWriter::~BinaryPointWriter() {}
+
+void BinaryPointWriter::write(const RationalPoint & p) {
+	begin(p.coords.size());
+	for(const mpq_class & v : p.coords) {
+		if (m_header.encoding == BinaryPointHeader::BE_DOUBLE) {
+			double d = Conversion<mpq_class>::toMpreal(v, 53).toDouble();
+			write(&d, sizeof(d));
+		}
+		else if (m_header.encoding == BinaryPointHeader::BE_MPFR) {
+			m_ft.setPrecision(m_header.precision);
+			mpfr_set_q(m_ft.mpfr_ptr(), v.get_mpq_t(), MPFR_RNDN);
+			write(m_ft);
+		}
+		else {
+			write(v);
+		}
+	}
+}
+
+void BinaryPointWriter::write(const FloatPoint & p) {
+	begin(p.coords.size());
+	for(const mpfr::mpreal & v : p.coords) {
+		if (m_header.encoding == BinaryPointHeader::BE_DOUBLE) {
+			double d = v.toDouble();
+			write(&d, sizeof(d));
+		}
+		else if (m_header.encoding == BinaryPointHeader::BE_MPFR) {
+			if (v.getPrecision() == m_header.precision) {
+				write(v);
+			}
+			else {
+				m_ft.setPrecision(m_header.precision);
+				mpfr_set(m_ft.mpfr_ptr(), v.mpfr_srcptr(), MPFR_RNDN);
+				write(m_ft);
+			}
+		}
+		else {
+			if (!mpfr_number_p(v.mpfr_srcptr())) {
+				throw std::runtime_error("ratss::BinaryPointWriter::write: coordinate is not a number");
+			}
+			mpq_class tmp;
+			mpfr_get_q(tmp.get_mpq_t(), v.mpfr_srcptr());
+			write(tmp);
+		}
+	}
+}
+
+void BinaryPointWriter::begin(std::size_t dimension) {
+	if (m_header.encoding == BinaryPointHeader::BE_INVALID) {
+		m_header = BinaryPointHeader::fromFormat(m_fmt, dimension);
+		m_header.write(m_os);
+	}
+	else if (m_header.dimension != dimension) {
+		throw std::runtime_error("ratss::BinaryPointWriter::write: all points need to have the same dimension");
+	}
+}
+
+void BinaryPointWriter::write(const void * data, std::size_t size) {
+	m_os.write(static_cast<const char*>(data), size);
+}
+
+void BinaryPointWriter::write(const mpfr::mpreal & v) {
+	mpfr_srcptr x = v.mpfr_srcptr();
+	std::int32_t kind;
+	std::int64_t exp = 0;
+	if (mpfr_nan_p(x)) {
+		kind = MPFR_NAN_KIND;
+	}
+	else if (mpfr_inf_p(x)) {
+		kind = MPFR_INF_KIND;
+	}
+	else if (mpfr_zero_p(x)) {
+		kind = MPFR_ZERO_KIND;
+	}
+	else {
+		kind = MPFR_REGULAR_KIND;
+		exp = mpfr_get_exp(x);
+	}
+	if (kind != MPFR_NAN_KIND && mpfr_signbit(x)) {
+		kind = -kind;
+	}
+	write(&kind, sizeof(kind));
+	write(&exp, sizeof(exp));
+	if (kind == MPFR_REGULAR_KIND || kind == -MPFR_REGULAR_KIND) {
+		write(mpfr_custom_get_significand(x), numLimbs(m_header.precision)*sizeof(mp_limb_t));
+	}
+}
+
+void BinaryPointWriter::write(const mpq_class & v) {
+	write(v.get_num_mpz_t(), true);
+	write(v.get_den_mpz_t(), false);
+}
+
+void BinaryPointWriter::write(mpz_srcptr v, bool withSign) {
+	std::size_t n = mpz_size(v);
+	if (n > std::size_t(std::numeric_limits<std::int32_t>::max())) {
+		throw std::runtime_error("ratss::BinaryPointWriter::write: number too large");
+	}
+	if (withSign) {
+		std::int32_t size = std::int32_t(n) * mpz_sgn(v);
+		write(&size, sizeof(size));
+	}
+	else {
+		std::uint32_t size = std::uint32_t(n);
+		write(&size, sizeof(size));
+	}
+	write(mpz_limbs_read(v), n*sizeof(mp_limb_t));
+}
+
+}//end namespace LIB_RATSS_NAMESPACE
@@ -38,27 +38,34 @@ void FloatPoint::assign(std::istream & is, Format fmt, int precision, int dimens
 		}
 	}
 	else if (fmt == FM_GEO) {
-		coords.resize(3);
 		mpfr::mpreal lat, lon;
 		is >> lat >> lon;
-		precision = std::max<int>(precision, 53);
-		lat.setPrecision(precision);
-		lon.setPrecision(precision);
-		c.cartesian(lat, lon, coords[0], coords[1], coords[2]);
+		assignGeo(lat, lon, precision);
 	}
 	else if (fmt == FM_SPHERICAL) {
-		coords.resize(3);
 		mpfr::mpreal theta, phi;
 		is >> theta >> phi;
-		precision = std::max<int>(precision, 53);
-		theta.setPrecision(precision);
-		phi.setPrecision(precision);
-		c.cartesianFromSpherical(theta, phi, coords[0], coords[1], coords[2]);
+		assignSpherical(theta, phi, precision);
 	}
 	else {
 		throw std::runtime_error("ratss::FloatPoint: unsupported format");
 	}
 }
+void FloatPoint::assignGeo(mpfr::mpreal & lat, mpfr::mpreal & lon, int precision, GeoCalc::TrigCache * cache) {
+	coords.resize(3);
+	precision = std::max<int>(precision, 53);
+	lat.setPrecision(precision);
+	lon.setPrecision(precision);
+	//the mpfr variant is not more accurate than 2^-precision either
+	c.cartesian(lat, lon, coords[0], coords[1], coords[2], precision, cache);
+}
+void FloatPoint::assignSpherical(mpfr::mpreal & theta, mpfr::mpreal & phi, int precision) {
+	coords.resize(3);
+	precision = std::max<int>(precision, 53);
+	theta.setPrecision(precision);
+	phi.setPrecision(precision);
+	c.cartesianFromSpherical(theta, phi, coords[0], coords[1], coords[2]);
+}
 void FloatPoint::print(std::ostream & out) const {
 	if (!coords.size()) {
 		return;
@@ -133,6 +140,11 @@ void RationalPoint::assign(std::istream & is, Format fmt, int precision, int dim
 			coords.emplace_back(std::move(tmp));
 		}
 	}
+	else if (fmt == FM_CARTESIAN_HOMOGENEOUS) {
+		HomogeneousPoint hp;
+		hp.assign(is, dimension);
+		hp.get(*this);
+	}
 	else {
 		FloatPoint fp;
 		try {
@@ -165,6 +177,11 @@ void RationalPoint::print(std::ostream & out, Format fmt) const {
 			out << ' ' << it->get_num() << ' ' << it->get_den();
 		}
 	}
+	else if (fmt == FM_HOMOGENEOUS) {
+		HomogeneousPoint hp;
+		hp.assign(*this);
+		hp.print(out);
+	}
 	else if (fmt == FM_FLOAT) {
 		std::streamsize prec = out.precision();
 		out.precision(std::numeric_limits<double>::digits10+1);
@@ -221,5 +238,80 @@ bool RationalPoint::valid() const {
 	return tmp == mpq_class(1);
 }
 
+HomogeneousPoint::HomogeneousPoint() {}
+
+void HomogeneousPoint::clear() {
+	coords.clear();
+	denominator = 0;
+}
+
+void HomogeneousPoint::resize(std::size_t _n) {
+	coords.resize(_n);
+}
+
+void HomogeneousPoint::assign(const RationalPoint & p) {
+	coords.resize(p.coords.size());
+	Calc().commonDenominator(p.coords.cbegin(), p.coords.cend(), coords.begin(), denominator);
+}
+
+void HomogeneousPoint::assign(std::istream & is, int dimension) {
+	coords.clear();
+	mpz_class tmp;
+	//the denominator is the last number of the line, so trailing white space must not skip to the next line
+	auto atLineEnd = [&is]() -> bool {
+		for(int c = is.peek(); c == ' ' || c == '\t' || c == '\r'; c = is.peek()) {
+			is.get();
+		}
+		return !is.good() || is.peek() == '\n' || is.peek() == std::char_traits<char>::eof();
+	};
+	while (dimension < 0 || (int) coords.size() != dimension+1) {
+		if (atLineEnd()) {
+			break;
+		}
+		is >> tmp;
+		if (is.fail()) {
+			throw std::runtime_error("ratss::HomogeneousPoint::assign: invalid number");
+		}
+		coords.emplace_back(std::move(tmp));
+	}
+	if (!coords.size()) {
+		throw std::runtime_error("ratss::HomogeneousPoint::assign: missing denominator");
+	}
+	//otherwise a missing coordinate would silently turn the last numerator into the denominator
+	if (dimension >= 0 && ((int) coords.size() != dimension+1 || !atLineEnd())) {
+		throw std::runtime_error("ratss::HomogeneousPoint::assign: expected " + std::to_string(dimension) + " numerators and a denominator");
+	}
+	denominator = std::move(coords.back());
+	coords.pop_back();
+	if (denominator == 0) {
+		throw std::runtime_error("ratss::HomogeneousPoint::assign: denominator is 0");
+	}
+}
+
+void HomogeneousPoint::get(RationalPoint & p) const {
+	p.coords.resize(coords.size());
+	for(std::size_t i(0), s(coords.size()); i < s; ++i) {
+		mpq_class & v = p.coords[i];
+		v.get_num() = coords[i];
+		v.get_den() = denominator;
+		v.canonicalize();
+	}
+}
+
+void HomogeneousPoint::print(std::ostream & out) const {
+	for(const mpz_class & v : coords) {
+		out << v << ' ';
+	}
+	out << denominator;
+}
+
+bool HomogeneousPoint::valid() const {
+	mpz_class tmp(0);
+	for(const mpz_class & v : coords) {
+		mpz_addmul(tmp.get_mpz_t(), v.get_mpz_t(), v.get_mpz_t());
+	}
+	return denominator != 0 && tmp == denominator*denominator;
+}
+
 
 }//end namespace LIB_RATSS_NAMESPACE
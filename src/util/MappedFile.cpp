@@ -0,0 +1,76 @@
+#include <libratss/util/MappedFile.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace LIB_RATSS_NAMESPACE {
+
+MappedFile::MappedFile() {}
+
+MappedFile::MappedFile(const std::string & fileName) {
+	open(fileName);
+}
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+void MappedFile::open(const std::string & fileName) {
+	close();
+	m_fd = ::open(fileName.c_str(), O_RDONLY);
+	if (m_fd < 0) {
+		throw std::runtime_error("ratss::MappedFile::open: could not open " + fileName);
+	}
+	struct stat st;
+	if (::fstat(m_fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+		close();
+		throw std::runtime_error("ratss::MappedFile::open: not a regular file: " + fileName);
+	}
+	m_size = st.st_size;
+	if (!m_size) { //mmap does not support empty mappings
+		return;
+	}
+	void * data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+	if (data == MAP_FAILED) {
+		close();
+		throw std::runtime_error("ratss::MappedFile::open: could not map " + fileName);
+	}
+	::madvise(data, m_size, MADV_SEQUENTIAL);
+	m_data = static_cast<const char*>(data);
+}
+
+void MappedFile::close() {
+	if (m_data) {
+		::munmap(const_cast<char*>(m_data), m_size);
+	}
+	if (m_fd >= 0) {
+		::close(m_fd);
+	}
+	m_fd = -1;
+	m_data = nullptr;
+	m_size = 0;
+}
+
+std::vector<MappedFile::Span> MappedFile::chunks(std::size_t count) const {
+	std::vector<Span> result;
+	const char * end = m_data + m_size;
+	std::size_t chunkSize = m_size / std::max<std::size_t>(count, 1) + 1;
+	for(const char * begin = m_data; begin != end; ) {
+		const char * chunkEnd = end;
+		if (std::size_t(end - begin) > chunkSize) {
+			const char * nl = static_cast<const char*>(std::memchr(begin + chunkSize, '\n', end - begin - chunkSize));
+			chunkEnd = nl ? nl+1 : end;
+		}
+		result.emplace_back(begin, chunkEnd);
+		begin = chunkEnd;
+	}
+	return result;
+}
+
+}//end namespace LIB_RATSS_NAMESPACE
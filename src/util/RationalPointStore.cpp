@@ -0,0 +1,206 @@
+#include <libratss/util/RationalPointStore.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace LIB_RATSS_NAMESPACE {
+namespace {
+
+struct Header {
+	std::int32_t numSize; //with the sign of the value
+	std::uint32_t denSize;
+};
+
+constexpr std::size_t headerLimbs = (sizeof(Header) + sizeof(mp_limb_t) - 1) / sizeof(mp_limb_t);
+constexpr std::uint32_t denIsOne = 0;
+constexpr std::uint32_t denIsPrevious = std::numeric_limits<std::uint32_t>::max();
+
+//gmp may read the first limb of a number with size 0
+const mp_limb_t zeroLimb = 0;
+const mp_limb_t oneLimb = 1;
+
+inline Header header(const mp_limb_t * data) {
+	Header h;
+	std::memcpy(&h, data, sizeof(Header));
+	return h;
+}
+
+inline std::size_t storedLimbs(const Header & h) {
+	std::size_t denLimbs = (h.denSize == denIsOne || h.denSize == denIsPrevious) ? 0 : h.denSize;
+	return headerLimbs + std::abs(h.numSize) + denLimbs;
+}
+
+} //end namespace
+
+//CoordinateView
+
+RationalPointStore::CoordinateView::CoordinateView() {
+	setNum(nullptr, 0);
+	setDen(nullptr, 0);
+}
+
+RationalPointStore::CoordinateView::CoordinateView(const CoordinateView & other) : m_q(other.m_q) {}
+
+RationalPointStore::CoordinateView & RationalPointStore::CoordinateView::operator=(const CoordinateView & other) {
+	m_q = other.m_q;
+	return *this;
+}
+
+void RationalPointStore::CoordinateView::get(mpq_class & v) const {
+	mpq_set(v.get_mpq_t(), &m_q);
+}
+
+mpq_class RationalPointStore::CoordinateView::get() const {
+	mpq_class v;
+	get(v);
+	return v;
+}
+
+void RationalPointStore::CoordinateView::setNum(const mp_limb_t * limbs, std::int32_t size) {
+	__mpz_struct & num = *mpq_numref(&m_q);
+	num._mp_size = size;
+	num._mp_alloc = std::max<int>(1, std::abs(size));
+	num._mp_d = const_cast<mp_limb_t*>(size ? limbs : &zeroLimb);
+}
+
+void RationalPointStore::CoordinateView::setDen(const mp_limb_t * limbs, std::int32_t size) {
+	__mpz_struct & den = *mpq_denref(&m_q);
+	den._mp_size = size ? size : 1;
+	den._mp_alloc = den._mp_size;
+	den._mp_d = const_cast<mp_limb_t*>(size ? limbs : &oneLimb);
+}
+
+//const_iterator
+
+RationalPointStore::const_iterator::const_iterator(const mp_limb_t * data, std::size_t remaining) :
+m_data(data),
+m_remaining(remaining)
+{
+	if (m_remaining) {
+		load();
+	}
+}
+
+RationalPointStore::const_iterator & RationalPointStore::const_iterator::operator++() {
+	m_data += storedLimbs(header(m_data));
+	--m_remaining;
+	if (m_remaining) {
+		load();
+	}
+	return *this;
+}
+
+RationalPointStore::const_iterator RationalPointStore::const_iterator::operator++(int) {
+	const_iterator tmp(*this);
+	++(*this);
+	return tmp;
+}
+
+void RationalPointStore::const_iterator::load() {
+	Header h = header(m_data);
+	const mp_limb_t * limbs = m_data + headerLimbs;
+	m_v.setNum(limbs, h.numSize);
+	//the denominator of the previous coordinate is still set
+	if (h.denSize != denIsPrevious) {
+		m_v.setDen(limbs + std::abs(h.numSize), h.denSize);
+	}
+}
+
+//PointView
+
+RationalPointStore::PointView::PointView(const mp_limb_t * data, std::size_t dimension) :
+m_data(data),
+m_dimension(dimension)
+{}
+
+RationalPointStore::CoordinateView RationalPointStore::PointView::operator[](std::size_t i) const {
+	const_iterator it(begin());
+	for(; i; --i) {
+		++it;
+	}
+	return *it;
+}
+
+void RationalPointStore::PointView::get(RationalPoint & p) const {
+	p.coords.resize(m_dimension);
+	get(p.coords.begin());
+}
+
+//RationalPointStore
+
+RationalPointStore::RationalPointStore(std::size_t dimension) :
+m_dimension(dimension),
+m_offsets(1, 0)
+{}
+
+std::size_t RationalPointStore::memoryUsage() const {
+	return sizeof(RationalPointStore) + m_limbs.capacity()*sizeof(mp_limb_t) + m_offsets.capacity()*sizeof(std::size_t);
+}
+
+void RationalPointStore::reserve(std::size_t points, std::size_t limbs) {
+	m_offsets.reserve(points+1);
+	m_limbs.reserve(limbs);
+}
+
+void RationalPointStore::shrink_to_fit() {
+	m_offsets.shrink_to_fit();
+	m_limbs.shrink_to_fit();
+}
+
+void RationalPointStore::clear() {
+	m_limbs.clear();
+	m_offsets.resize(1);
+}
+
+RationalPointStore::PointView RationalPointStore::at(std::size_t i) const {
+	if (i >= size()) {
+		throw std::out_of_range("ratss::RationalPointStore::at: index out of range");
+	}
+	return (*this)[i];
+}
+
+void RationalPointStore::get(std::size_t i, RationalPoint & p) const {
+	at(i).get(p);
+}
+
+void RationalPointStore::push_back(const RationalPoint & p) {
+	push_back(p.coords.cbegin(), p.coords.cend());
+}
+
+void RationalPointStore::beginPoint(std::size_t dims) {
+	if (!m_dimension && empty()) {
+		m_dimension = dims;
+	}
+	if (dims != m_dimension || !dims) {
+		throw std::invalid_argument("ratss::RationalPointStore::push_back: point has " + std::to_string(dims) + " coordinates instead of " + std::to_string(m_dimension));
+	}
+}
+
+void RationalPointStore::append(mpq_srcptr v, mpz_srcptr prevDen) {
+	mpz_srcptr num = mpq_numref(v);
+	mpz_srcptr den = mpq_denref(v);
+	Header h;
+	h.numSize = num->_mp_size;
+	std::size_t numLimbs = std::abs(h.numSize);
+	std::size_t denLimbs = 0;
+	if (mpz_cmp_ui(den, 1) == 0) {
+		h.denSize = denIsOne;
+	}
+	else if (prevDen && mpz_cmp(den, prevDen) == 0) {
+		h.denSize = denIsPrevious;
+	}
+	else {
+		denLimbs = den->_mp_size;
+		h.denSize = denLimbs;
+	}
+	std::size_t pos = m_limbs.size();
+	m_limbs.resize(pos + headerLimbs + numLimbs + denLimbs);
+	mp_limb_t * data = m_limbs.data() + pos;
+	std::memset(data, 0, headerLimbs*sizeof(mp_limb_t));
+	std::memcpy(data, &h, sizeof(Header));
+	std::memcpy(data + headerLimbs, num->_mp_d, numLimbs*sizeof(mp_limb_t));
+	std::memcpy(data + headerLimbs + numLimbs, den->_mp_d, denLimbs*sizeof(mp_limb_t));
+}
+
+}//end namespace LIB_RATSS_NAMESPACE
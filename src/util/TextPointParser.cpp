@@ -0,0 +1,217 @@
+#include <libratss/util/TextPointParser.h>
+
+#include <cfloat>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace LIB_RATSS_NAMESPACE {
+namespace {
+
+inline bool isSpace(char c) {
+	return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+} //end namespace
+
+TextPointParser::TextPointParser() {}
+
+TextPointParser::~TextPointParser() {}
+
+const char * TextPointParser::parse(const char * begin, const char * end, PointBase::Format fmt, int precision, FloatPoint & p, int dimension) {
+	const char * it = begin;
+	const char * tb;
+	std::size_t n = 0;
+	if (fmt == PointBase::FM_CARTESIAN_FLOAT || fmt == PointBase::FM_CARTESIAN_FLOAT128 || fmt == PointBase::FM_CARTESIAN_RATIONAL) {
+		for( ; (int) n != dimension && token(it, end, tb); ++n) {
+			if (p.coords.size() <= n) {
+				p.coords.emplace_back();
+			}
+			if (fmt == PointBase::FM_CARTESIAN_RATIONAL) {
+				parse(tb, it, m_q);
+				p.coords[n] = Conversion<mpq_class>::toMpreal(m_q, precision);
+			}
+			else {
+				parse(tb, it, p.coords[n]);
+			}
+		}
+		p.coords.resize(n);
+	}
+	else if (fmt == PointBase::FM_CARTESIAN_SPLIT_RATIONAL) {
+		for( ; (int) n != dimension && token(it, end, tb); ++n) {
+			parse(tb, it, m_q.get_num_mpz_t());
+			if (!token(it, end, tb)) {
+				throw std::runtime_error("ratss::TextPointParser::parse: missing denominator");
+			}
+			parse(tb, it, m_q.get_den_mpz_t());
+			if (m_q.get_den() == 0) {
+				invalid(tb, it);
+			}
+			m_q.canonicalize();
+			if (p.coords.size() <= n) {
+				p.coords.emplace_back();
+			}
+			p.coords[n] = Conversion<mpq_class>::toMpreal(m_q, precision);
+		}
+		p.coords.resize(n);
+	}
+	else if (fmt == PointBase::FM_GEO || fmt == PointBase::FM_SPHERICAL) {
+		mpfr::mpreal a, b;
+		if (!token(it, end, tb)) {
+			throw std::runtime_error("ratss::TextPointParser::parse: missing coordinate");
+		}
+		parse(tb, it, a);
+		if (!token(it, end, tb)) {
+			throw std::runtime_error("ratss::TextPointParser::parse: missing coordinate");
+		}
+		parse(tb, it, b);
+		if (fmt == PointBase::FM_GEO) {
+			p.assignGeo(a, b, precision, &m_trig);
+		}
+		else {
+			p.assignSpherical(a, b, precision);
+		}
+	}
+	else {
+		throw std::runtime_error("ratss::TextPointParser::parse: unsupported format");
+	}
+	return it;
+}
+
+const char * TextPointParser::parse(const char * begin, const char * end, PointBase::Format fmt, int precision, RationalPoint & p, int dimension) {
+	const char * it = begin;
+	const char * tb;
+	std::size_t n = 0;
+	if (fmt == PointBase::FM_CARTESIAN_RATIONAL) {
+		for( ; (int) n != dimension && token(it, end, tb); ++n) {
+			if (p.coords.size() <= n) {
+				p.coords.emplace_back();
+			}
+			parse(tb, it, p.coords[n]);
+		}
+		p.coords.resize(n);
+	}
+	else if (fmt == PointBase::FM_CARTESIAN_SPLIT_RATIONAL) {
+		for( ; (int) n != dimension && token(it, end, tb); ++n) {
+			if (p.coords.size() <= n) {
+				p.coords.emplace_back();
+			}
+			mpq_class & v = p.coords[n];
+			parse(tb, it, v.get_num_mpz_t());
+			if (!token(it, end, tb)) {
+				throw std::runtime_error("ratss::TextPointParser::parse: missing denominator");
+			}
+			parse(tb, it, v.get_den_mpz_t());
+			if (v.get_den() == 0) {
+				invalid(tb, it);
+			}
+			v.canonicalize();
+		}
+		p.coords.resize(n);
+	}
+	else {
+		it = parse(begin, end, fmt, precision, m_fp, dimension);
+		p.coords.resize(m_fp.coords.size());
+		for(std::size_t i(0), s(m_fp.coords.size()); i < s; ++i) {
+			p.coords[i] = Conversion<mpfr::mpreal>::toMpq(m_fp.coords[i]);
+		}
+	}
+	return it;
+}
+
+const char * TextPointParser::nextLine(const char * begin, const char * end) {
+	const char * nl = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+	return nl ? nl+1 : end;
+}
+
+const char * TextPointParser::skipLineBreaks(const char * begin, const char * end) {
+	for( ; begin != end && *begin == '\n'; ++begin) {}
+	return begin;
+}
+
+bool TextPointParser::token(const char * & it, const char * end, const char * & tokenBegin) {
+	for( ; it != end && isSpace(*it); ++it) {}
+	if (it == end || *it == '\n') {
+		return false;
+	}
+	tokenBegin = it;
+	for( ; it != end && *it != '\n' && !isSpace(*it); ++it) {}
+	return true;
+}
+
+void TextPointParser::parse(const char * begin, const char * end, mpfr::mpreal & v) {
+	//same as operator>>(std::istream&, mpfr::mpreal&) which parses with the default precision
+	mpfr_prec_t prec = mpfr::mpreal::get_default_prec();
+	if (mpfr_get_prec(v.mpfr_srcptr()) != prec) {
+		mpfr_set_prec(v.mpfr_ptr(), prec);
+	}
+	if (prec == std::numeric_limits<double>::digits && mpfr::mpreal::get_default_rnd() == MPFR_RNDN) {
+		//from_chars rounds correctly to the nearest double, just like mpfr_set_str
+		double d;
+		auto r = std::from_chars(begin, end, d);
+		if (r.ec == std::errc() && r.ptr == end && std::isfinite(d) && (d == 0 || std::abs(d) >= DBL_MIN)) {
+			mpfr_set_d(v.mpfr_ptr(), d, MPFR_RNDN);
+			return;
+		}
+	}
+	m_buffer.assign(begin, end);
+	if (mpfr_set_str(v.mpfr_ptr(), m_buffer.c_str(), 10, mpfr::mpreal::get_default_rnd()) != 0) {
+		invalid(begin, end);
+	}
+}
+
+void TextPointParser::parse(const char * begin, const char * end, mpz_ptr v) {
+	const char * it = begin;
+	bool negative = false;
+	if (it != end && (*it == '-' || *it == '+')) {
+		negative = (*it == '-');
+		++it;
+	}
+	if (it == end) {
+		invalid(begin, end);
+	}
+	if (end - it <= std::numeric_limits<unsigned long>::digits10) {
+		unsigned long r = 0;
+		for( ; it != end; ++it) {
+			unsigned int digit = static_cast<unsigned char>(*it) - '0';
+			if (digit > 9) {
+				invalid(begin, end);
+			}
+			r = r*10 + digit;
+		}
+		mpz_set_ui(v, r);
+		if (negative) {
+			mpz_neg(v, v);
+		}
+		return;
+	}
+	m_buffer.assign(negative ? "-" : "");
+	m_buffer.append(it, end);
+	if (mpz_set_str(v, m_buffer.c_str(), 10) != 0) {
+		invalid(begin, end);
+	}
+}
+
+void TextPointParser::parse(const char * begin, const char * end, mpq_class & v) {
+	const char * slash = static_cast<const char*>(std::memchr(begin, '/', end - begin));
+	if (slash) {
+		parse(begin, slash, v.get_num_mpz_t());
+		parse(slash+1, end, v.get_den_mpz_t());
+		if (v.get_den() == 0) {
+			invalid(begin, end);
+		}
+		v.canonicalize();
+	}
+	else {
+		parse(begin, end, v.get_num_mpz_t());
+		mpz_set_ui(v.get_den_mpz_t(), 1);
+	}
+}
+
+void TextPointParser::invalid(const char * begin, const char * end) const {
+	throw std::runtime_error("ratss::TextPointParser::parse: invalid number: " + std::string(begin, end));
+}
+
+}//end namespace LIB_RATSS_NAMESPACE
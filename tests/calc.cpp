@@ -1,8 +1,15 @@
 #include <libratss/constants.h>
 #include <libratss/Calc.h>
+#include <libratss/GeoCalc.h>
+#include <libratss/internal/JacobiPerron2D.h>
+#include <libratss/internal/Matrix.h>
+
+#include <limits>
+#include <random>
 
 #include "TestBase.h"
 #include "../common/generators.h"
+#include "../common/stats.h"
 
 namespace LIB_RATSS_NAMESPACE {
 namespace tests {
@@ -11,7 +18,18 @@ class CalcTest: public TestBase {
 CPPUNIT_TEST_SUITE( CalcTest );
 CPPUNIT_TEST( withinSpecial );
 CPPUNIT_TEST( contFracRandom );
+CPPUNIT_TEST( contFracEngines );
+CPPUNIT_TEST( bruteForce );
 CPPUNIT_TEST( jacobiPerron2D );
+CPPUNIT_TEST( jacobiPerronEngine );
+CPPUNIT_TEST( jacobiPerronND );
+CPPUNIT_TEST( matrixMultiply );
+CPPUNIT_TEST( fixpointFast );
+CPPUNIT_TEST( lllConfig );
+CPPUNIT_TEST( lllEach );
+CPPUNIT_TEST( geoDoubleDouble );
+CPPUNIT_TEST( geoTrigCache );
+CPPUNIT_TEST( logHistogram );
 CPPUNIT_TEST_SUITE_END();
 public:
 	static std::size_t num_random_test_points;
@@ -20,7 +38,18 @@ public:
 public:
 	void withinSpecial();
 	void contFracRandom();
+	void contFracEngines();
+	void bruteForce();
 	void jacobiPerron2D();
+	void jacobiPerronEngine();
+	void jacobiPerronND();
+	void matrixMultiply();
+	void fixpointFast();
+	void lllConfig();
+	void lllEach();
+	void geoDoubleDouble();
+	void geoTrigCache();
+	void logHistogram();
 };
 
 std::size_t CalcTest::num_random_test_points;
@@ -41,7 +70,137 @@ namespace LIB_RATSS_NAMESPACE {
 namespace tests {
 
 void CalcTest::contFracRandom() {
-	;
+	std::mt19937_64 gen(0);
+	std::uniform_int_distribution<int> bits(1, 256);
+	std::uniform_int_distribution<int> sigs(1, 128);
+	gmp_randclass rnd(gmp_randinit_default);
+	rnd.seed(0);
+	Calc::Scratch scratch;
+	mpq_class inplace;
+	for(std::size_t i(0); i < num_random_test_points; ++i) {
+		mpq_class value(rnd.get_z_bits(bits(gen)), rnd.get_z_bits(bits(gen))+1);
+		value.canonicalize();
+		if (i % 2) {
+			value = -value;
+		}
+		int significands = sigs(gen);
+		mpq_class eps(mpz_class(1), mpz_class(1) << significands);
+		std::stringstream ss;
+		ss << value << " with " << significands << " significands";
+		
+		mpq_class result = calc.contFrac(value, significands, ST_GUARANTEE_DISTANCE);
+		CPPUNIT_ASSERT_MESSAGE(ss.str(), abs(result - value) <= eps);
+		calc.contFrac(inplace, value, significands, ST_GUARANTEE_DISTANCE, scratch);
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), result, inplace);
+		
+		result = calc.contFrac(value, significands, ST_GUARANTEE_SIZE);
+		CPPUNIT_ASSERT_MESSAGE(ss.str(), result.get_den() <= eps.get_den());
+		calc.contFrac(inplace, value, significands, ST_GUARANTEE_SIZE, scratch);
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), result, inplace);
+	}
+	for(std::size_t i(0); i < num_random_test_points; ++i) {
+		mpfr::mpreal v(std::ldexp(double(gen() >> 11), -53), 128);
+		int significands = sigs(gen) % 100 + 1;
+		for(int st : {ST_CF_GUARANTEE_DISTANCE, ST_CF_GUARANTEE_SIZE}) {
+			calc.snap(inplace, v, st, significands, scratch);
+			CPPUNIT_ASSERT_EQUAL(calc.snap(v, st, significands), inplace);
+		}
+	}
+}
+
+void CalcTest::contFracEngines() {
+	std::mt19937_64 gen(0);
+	std::uniform_int_distribution<int> bits(1, 1024);
+	gmp_randclass rnd(gmp_randinit_default);
+	rnd.seed(0);
+	Calc::Scratch scratch;
+	mpq_class expected, result;
+	for(std::size_t i(0); i < num_random_test_points/10+20; ++i) {
+		//the last values exceed ContinuedFraction::half_gcd_threshold
+		int maxBits = (i < num_random_test_points/10 ? bits(gen) : 3*internal::ContinuedFraction::half_gcd_threshold);
+		mpq_class value(rnd.get_z_bits(maxBits), mpz_class(1) << (gen() % maxBits + 1));
+		value.canonicalize();
+		if (i % 2) {
+			value = -value;
+		}
+		int significands = gen() % maxBits + 1;
+		std::stringstream ss;
+		ss << value << " with " << significands << " significands";
+		for(int mode : {ST_GUARANTEE_DISTANCE, ST_GUARANTEE_SIZE}) {
+			calc.contFrac(expected, value, significands, mode, scratch);
+			for(int engine : {ST_CF_LEHMER, ST_CF_HALF_GCD}) {
+				calc.contFrac(result, value, significands, mode | engine, scratch);
+				CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), expected, result);
+			}
+		}
+		mpq_class eps(mpz_class(1), mpz_class(1) << significands);
+		expected = calc.within(value - eps, value);
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), expected, calc.within(value - eps, value, ST_CF_LEHMER));
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), expected, calc.within(value - eps, value, ST_CF_HALF_GCD));
+	}
+	//integer part differs from 0
+	CPPUNIT_ASSERT_EQUAL(mpq_class("19/6"), calc.within(mpq_class("311/100"), mpq_class("319/100")));
+	CPPUNIT_ASSERT_EQUAL(mpq_class("19/6"), calc.within(mpq_class("311/100"), mpq_class("319/100"), ST_CF_LEHMER));
+}
+
+void CalcTest::bruteForce() {
+	std::mt19937_64 gen(0);
+	gmp_randclass rnd(gmp_randinit_default);
+	rnd.seed(0);
+	for(std::size_t i(0); i < num_random_test_points/100; ++i) {
+		std::size_t dims = gen() % 4 + 1;
+		int significands = gen() % 10 + 1;
+		std::vector<mpq_class> input(dims);
+		for(mpq_class & v : input) {
+			v = mpq_class(rnd.get_z_bits(significands+2), mpz_class(1) << (significands+2));
+			v.canonicalize();
+			if (gen() % 2) {
+				v = -v;
+			}
+		}
+		//inputs with small exact denominators
+		if (i % 10 == 0) {
+			for(mpq_class & v : input) {
+				v = mpq_class(gen() % 7, 8);
+			}
+		}
+		std::stringstream ss;
+		ss << "input " << i << " with " << significands << " significands";
+		SimApxBruteForce<mpq_class, 0> expected(input.begin(), input.end());
+		expected.run(significands+1);
+		SimApxBruteForce<std::int64_t, 0> result(input.begin(), input.end());
+		result.setThreadCount(i % 3 + 1);
+		result.run(significands+1);
+		auto eit = expected.numerators_begin();
+		for(auto it(result.numerators_begin()); it != result.numerators_end(); ++it, ++eit) {
+			mpq_class q(*it, result.denominator());
+			q.canonicalize();
+			CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), mpq_class(*eit/expected.denominator()), q);
+		}
+	}
+	//more denominators than SimApxBruteForce::task_size
+	std::vector<mpq_class> input = {mpq_class("12345678/33554432"), mpq_class("-23456789/33554432")};
+	SimApxBruteForce<std::int64_t, 0> single(input.begin(), input.end());
+	single.run(24);
+	SimApxBruteForce<std::int64_t, 0> multi(input.begin(), input.end());
+	multi.setThreadCount(4);
+	multi.run(24);
+	CPPUNIT_ASSERT_EQUAL(single.denominator(), multi.denominator());
+	CPPUNIT_ASSERT(std::equal(single.numerators_begin(), single.numerators_end(), multi.numerators_begin()));
+	//a common denominator of 2^32 and 2^31 denominators do not fit into int64
+	input = {mpq_class(mpz_class(12345), mpz_class(1) << 32)};
+	CPPUNIT_ASSERT(!SimApxBruteForce<std::int64_t, 0>(input.begin(), input.end()).fits(std::size_t(1) << 31));
+	CPPUNIT_ASSERT(SimApxBruteForce<std::int64_t, 0>(input.begin(), input.end()).fits(std::size_t(1) << 30));
+	//toRational has to select an engine that does not overflow
+	std::vector<double> dinput = {0.375, -0.6875, 0.8125};
+	for(int significands : {29, 30, 31}) {
+		std::vector<mpq_class> output;
+		calc.toRational(dinput.begin(), dinput.end(), std::back_inserter(output), ST_BRUTE_FORCE, significands);
+		CPPUNIT_ASSERT_EQUAL(dinput.size(), output.size());
+		for(std::size_t i(0); i < dinput.size(); ++i) {
+			CPPUNIT_ASSERT_EQUAL(mpq_class(dinput[i]), output[i]);
+		}
+	}
 }
 
 void CalcTest::jacobiPerron2D() {
@@ -61,6 +220,424 @@ void CalcTest::jacobiPerron2D() {
 	CPPUNIT_ASSERT_EQUAL(input2, output2);
 }
 
+namespace {
+
+//The rational iteration as it was before internal::JacobiPerron2D
+bool jacobiPerronReference(const mpq_class & input1, const mpq_class & input2, mpq_class & output1, mpq_class & output2, int significands, int mode) {
+	using Matrix = internal::Matrix<mpz_class>;
+	using std::abs;
+	mpq_class eps = mpq_class(mpz_class(1), mpz_class(1) << significands);
+	Matrix result( Matrix::identity(3) );
+	Matrix mtxStep(3);
+	mtxStep(0, 2) = 1;
+	mtxStep(1, 0) = 1;
+	mtxStep(2, 1) = 1;
+	mpz_class an, bn;
+	mpq_class alpha(input1), beta(input2);
+	mpq_class tmp1, tmp2;
+	mpq_class best_diff = 1;
+	while(alpha != 0) {
+		tmp1 = 1 / alpha;
+		an = tmp1.get_num()/tmp1.get_den();
+		tmp2 = beta / alpha;
+		bn = tmp2.get_num()/tmp2.get_den();
+		alpha = tmp2 - bn;
+		beta = tmp1 - an;
+		mtxStep(0,0) = an;
+		mtxStep(2,0) = bn;
+		result = result * mtxStep;
+		mpq_class o1( result(1, 0), result(0, 0) );
+		mpq_class o2( result(2, 0), result(0, 0) );
+		o1.canonicalize();
+		o2.canonicalize();
+		if (mode & ST_GUARANTEE_DISTANCE) {
+			output1 = o1;
+			output2 = o2;
+			if (abs(o1-input1) <= eps && abs(o2-input2) <= eps) {
+				break;
+			}
+		}
+		else {
+			if (std::max(o1.get_den(), o2.get_den()) > eps.get_den()) {
+				break;
+			}
+			mpq_class diff = std::max(abs(o1-input1), abs(o2-input2));
+			if (diff < best_diff) {
+				best_diff = diff;
+				output1 = o1;
+				output2 = o2;
+			}
+		}
+	}
+	return alpha == 0;
+}
+
+} //end namespace
+
+void CalcTest::jacobiPerronEngine() {
+	std::mt19937_64 gen(0);
+	gmp_randclass rnd(gmp_randinit_default);
+	rnd.seed(0);
+	std::size_t machineWords = 0;
+	for(std::size_t i(0); i < num_random_test_points/10; ++i) {
+		//inputs of up to 63 bits run on machine words
+		int inputBits = 8 + gen() % 120;
+		mpz_class den = rnd.get_z_bits(inputBits) + 1;
+		mpq_class input1(rnd.get_z_bits(inputBits) % (den+1), den);
+		mpq_class input2(rnd.get_z_bits(inputBits) % (den+1), i % 3 ? den : den+1);
+		input1.canonicalize();
+		input2.canonicalize();
+		int significands = 2 + gen() % (inputBits+10);
+		std::stringstream ss;
+		ss << input1 << ", " << input2 << " with " << significands << " significands";
+		for(int mode : {ST_GUARANTEE_DISTANCE, ST_GUARANTEE_SIZE}) {
+			mpq_class expected1(-1), expected2(-1), output1(-1), output2(-1);
+			bool expectedAlphaIsZero = jacobiPerronReference(input1, input2, expected1, expected2, significands, mode);
+			internal::JacobiPerron2D jp(input1, input2);
+			CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), expectedAlphaIsZero, jp.run(significands, mode, output1, output2));
+			CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), expected1, output1);
+			CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), expected2, output2);
+			machineWords += jp.machineWords();
+		}
+	}
+	CPPUNIT_ASSERT(machineWords > 0);
+	CPPUNIT_ASSERT(machineWords < 2*(num_random_test_points/10));
+}
+
+void CalcTest::jacobiPerronND() {
+	std::mt19937_64 gen(0);
+	gmp_randclass rnd(gmp_randinit_default);
+	rnd.seed(0);
+	std::vector<mpq_class> input, output;
+	for(std::size_t i(0); i < num_random_test_points/10; ++i) {
+		std::size_t dims = 1 + gen() % 6;
+		int inputBits = 8 + gen() % 200;
+		input.resize(dims);
+		for(mpq_class & v : input) {
+			//values with an integral part, negative values and exact zeros
+			v = mpq_class(rnd.get_z_bits(inputBits+2) - (mpz_class(1) << (inputBits+1)), mpz_class(1) << inputBits);
+			v.canonicalize();
+			if (gen() % 8 == 0) {
+				v = 0;
+			}
+		}
+		int significands = 2 + gen() % (inputBits+10);
+		mpq_class eps(mpz_class(1), mpz_class(1) << significands);
+		std::stringstream ss;
+		ss << "dimension " << dims << " with " << significands << " significands:";
+		for(const mpq_class & v : input) {
+			ss << ' ' << v;
+		}
+		calc.jacobiPerron(input, output, significands, ST_GUARANTEE_DISTANCE);
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), dims, output.size());
+		for(std::size_t j(0); j < dims; ++j) {
+			CPPUNIT_ASSERT_MESSAGE(ss.str(), abs(input[j] - output[j]) <= eps);
+		}
+		calc.jacobiPerron(input, output, significands, ST_GUARANTEE_SIZE);
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), dims, output.size());
+		for(std::size_t j(0); j < dims; ++j) {
+			CPPUNIT_ASSERT_MESSAGE(ss.str(), output[j].get_den() <= eps.get_den());
+			CPPUNIT_ASSERT_MESSAGE(ss.str(), abs(input[j] - output[j]) < 1);
+		}
+	}
+	//exact if the common denominator is small enough
+	input = {mpq_class("1/7"), mpq_class("-2/7"), mpq_class("13/7"), mpq_class("0")};
+	calc.jacobiPerron(input, output, 4, ST_GUARANTEE_SIZE);
+	CPPUNIT_ASSERT(input == output);
+	calc.jacobiPerron(input, output, 32, ST_GUARANTEE_DISTANCE);
+	CPPUNIT_ASSERT(input == output);
+}
+
+void CalcTest::matrixMultiply() {
+	using Matrix = internal::Matrix<mpz_class>;
+	gmp_randclass rnd(gmp_randinit_default);
+	rnd.seed(0);
+	//out starts with the wrong dimension and is reused afterwards
+	Matrix out(1);
+	for(std::size_t dim(1); dim <= 6; ++dim) {
+		for(int round(0); round < 10; ++round) {
+			Matrix a(dim), b(dim);
+			for(std::size_t r(0); r < dim; ++r) {
+				for(std::size_t c(0); c < dim; ++c) {
+					a(r, c) = rnd.get_z_bits(200) - (mpz_class(1) << 199);
+					b(r, c) = rnd.get_z_bits(100) - (mpz_class(1) << 99);
+				}
+			}
+			Matrix::multiplyInto(out, a, b);
+			CPPUNIT_ASSERT_EQUAL(dim, out.dimension());
+			for(std::size_t r(0); r < dim; ++r) {
+				for(std::size_t c(0); c < dim; ++c) {
+					mpz_class expected(0);
+					for(std::size_t k(0); k < dim; ++k) {
+						expected += a(r, k)*b(k, c);
+					}
+					CPPUNIT_ASSERT_EQUAL(expected, out(r, c));
+				}
+			}
+			Matrix product = a*b;
+			for(std::size_t r(0); r < dim; ++r) {
+				for(std::size_t c(0); c < dim; ++c) {
+					CPPUNIT_ASSERT_EQUAL(out(r, c), product(r, c));
+				}
+			}
+		}
+	}
+	Matrix a( Matrix::identity(3) );
+	CPPUNIT_ASSERT_THROW(Matrix::multiplyInto(a, a, Matrix(3)), std::domain_error);
+	CPPUNIT_ASSERT_THROW(Matrix::multiplyInto(out, a, Matrix(4)), std::domain_error);
+	//other types use the generic loop
+	internal::Matrix<double> d( internal::Matrix<double>::identity(2) );
+	d(0, 1) = 2;
+	internal::Matrix<double> dd(2);
+	internal::Matrix<double>::multiplyInto(dd, d, d);
+	CPPUNIT_ASSERT_EQUAL(4.0, dd(0, 1));
+	CPPUNIT_ASSERT_EQUAL(1.0, dd(1, 1));
+}
+
+void CalcTest::fixpointFast() {
+	std::mt19937_64 gen(0);
+	std::uniform_real_distribution<double> mantissa(-1, 1);
+	std::uniform_int_distribution<int> exponent(-60, 0);
+	std::vector<double> values = {0.0, -0.0, 0.5, -0.5, std::ldexp(1, -20), std::ldexp(3, -22), std::nextafter(1.0, 0.0)};
+	for(std::size_t i(0); i < num_random_test_points; ++i) {
+		values.push_back( std::ldexp(mantissa(gen), exponent(gen)) );
+	}
+	Calc::Scratch scratch;
+	mpq_class inplace;
+	for(double v : values) {
+		for(int significands(1); significands <= 53; ++significands) {
+			mpq_class expected = Conversion<mpfr::mpreal>::toMpq( calc.toFixpoint(mpfr::mpreal(v, 53), significands) );
+			std::stringstream ss;
+			ss << std::setprecision(17) << v << " with " << significands << " significands";
+			CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), expected, calc.snap(v, ST_FX, significands));
+			CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), expected, calc.snap(mpfr::mpreal(v, 53), ST_FX, significands));
+			calc.snap(inplace, v, ST_FX, significands, scratch);
+			CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), expected, inplace);
+		}
+	}
+}
+
+void CalcTest::lllConfig() {
+	for(int d(2); d < 100; ++d) {
+		for(std::size_t entryBits : {64, 1000, 100000}) {
+			LLLConfig cfg = LLLConfig().select(d, entryBits);
+			std::stringstream ss;
+			ss << "dimension " << d << " with " << entryBits << " bits: " << LLLConfig::toString(cfg);
+			CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), LLLConfig::M_PROVED, cfg.method());
+			CPPUNIT_ASSERT_MESSAGE(ss.str(), cfg.proved(d));
+			if (d > 30) {
+				CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), LLLConfig::FT_MPFR, cfg.floatType());
+			}
+		}
+	}
+	CPPUNIT_ASSERT_EQUAL(LLLConfig::FT_DOUBLE, LLLConfig().select(4, 64).floatType());
+	CPPUNIT_ASSERT_EQUAL(LLLConfig::FT_DPE, LLLConfig().select(4, 100000).floatType());
+	//explicit choices are kept, too little precision falls back to the wrapper
+	LLLConfig heuristic(LLLConfig::M_HEURISTIC, LLLConfig::FT_DOUBLE);
+	CPPUNIT_ASSERT(heuristic == heuristic.select(50, 64));
+	CPPUNIT_ASSERT_EQUAL(LLLConfig::M_WRAPPER, LLLConfig(LLLConfig::M_AUTO, LLLConfig::FT_DOUBLE).select(50, 64).method());
+	CPPUNIT_ASSERT_EQUAL(LLLConfig::FT_AUTO, LLLConfig(LLLConfig::M_WRAPPER, LLLConfig::FT_MPFR, 100).select(4, 64).floatType());
+}
+
+void CalcTest::lllEach() {
+#if defined(LIB_RATSS_WITH_FPLLL)
+	using Iterator = std::vector<mpq_class>::const_iterator;
+	std::mt19937_64 gen(0);
+	gmp_randclass rnd(gmp_randinit_default);
+	rnd.seed(0);
+	std::size_t dims = 3;
+	std::size_t numPoints = 20;
+	int significands = 16;
+	std::vector<mpq_class> points(numPoints*dims);
+	for(mpq_class & v : points) {
+		v = mpq_class(rnd.get_z_bits(53), mpz_class(1) << 53);
+		v.canonicalize();
+		if (gen() % 2) {
+			v = -v;
+		}
+	}
+	SimApxLLL<Iterator> prototype(points.cbegin(), points.cbegin()+dims, significands);
+	for(SnapType st : {ST_GUARANTEE_DISTANCE, ST_GUARANTEE_SIZE}) {
+		for(std::size_t threads : {1, 4}) {
+			std::vector<mpz_class> denominators, numerators;
+			prototype.runEach(points.cbegin(), numPoints, st, denominators, numerators, threads);
+			CPPUNIT_ASSERT_EQUAL(numPoints, denominators.size());
+			CPPUNIT_ASSERT_EQUAL(numPoints*dims, numerators.size());
+			for(std::size_t i(0); i < numPoints; ++i) {
+				std::stringstream ss;
+				ss << "point " << i << " with " << threads << " threads and snap type " << st;
+				SimApxLLL<Iterator> single(points.cbegin()+i*dims, points.cbegin()+(i+1)*dims, significands);
+				single.run(st);
+				CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), single.denominator(), denominators[i]);
+				CPPUNIT_ASSERT_MESSAGE(ss.str(), std::equal(single.numerators_begin(), single.numerators_end(), numerators.begin()+i*dims));
+			}
+		}
+	}
+	std::vector<mpz_class> denominators, numerators;
+	calc.lllEach(points.cbegin(), numPoints, dims, denominators, numerators, significands);
+	for(std::size_t i(0); i < numPoints; ++i) {
+		mpz_class denominator;
+		std::vector<mpz_class> expected;
+		calc.lll(points.cbegin()+i*dims, points.cbegin()+(i+1)*dims, std::back_inserter(expected), denominator, significands);
+		CPPUNIT_ASSERT_EQUAL(denominator, denominators[i]);
+		CPPUNIT_ASSERT(std::equal(expected.begin(), expected.end(), numerators.begin()+i*dims));
+	}
+#endif
+}
+
+void CalcTest::geoDoubleDouble() {
+	std::mt19937_64 gen(0);
+	std::uniform_real_distribution<double> latDist(-90, 90);
+	std::uniform_real_distribution<double> lonDist(-180, 360);
+	//multiples of 45 and 90 as well as the borders of the table and of the quadrants
+	std::vector<std::pair<double, double>> values = {
+		{0, 0}, {90, 180}, {-90, -180}, {45, 360}, {44.5, 45.5}, {-44.5, -45.5}, {0.5, -0.5},
+		{std::nextafter(45.0, 0.0), std::nextafter(90.0, 180.0)}, {89.999999999, 359.999999999}, {1e-300, -1e-300}
+	};
+	for(std::size_t i(0); i < num_random_test_points; ++i) {
+		values.emplace_back(latDist(gen), lonDist(gen));
+	}
+	GeoCalc gc;
+	mpfr::mpreal eps(std::ldexp(1.0, -GeoCalc::cartesian_dd_accuracy), 256);
+	mpfr::mpreal x(0, 256), y(0, 256), z(0, 256), xf(0, 128), yf(0, 128), zf(0, 128);
+	internal::DoubleDouble xdd, ydd, zdd;
+	for(const auto & v : values) {
+		std::stringstream ss;
+		ss << std::setprecision(17) << "lat=" << v.first << " lon=" << v.second;
+		gc.cartesian(mpfr::mpreal(v.first, 256), mpfr::mpreal(v.second, 256), x, y, z);
+		gc.cartesian(v.first, v.second, xdd, ydd, zdd);
+		CPPUNIT_ASSERT_MESSAGE(ss.str(), abs(x - xdd.hi - xdd.lo) <= eps);
+		CPPUNIT_ASSERT_MESSAGE(ss.str(), abs(y - ydd.hi - ydd.lo) <= eps);
+		CPPUNIT_ASSERT_MESSAGE(ss.str(), abs(z - zdd.hi - zdd.lo) <= eps);
+		
+		//rounding to 128 bits adds at most another eps
+		CPPUNIT_ASSERT(gc.cartesian(mpfr::mpreal(v.first, 53), mpfr::mpreal(v.second, 53), xf, yf, zf, 64));
+		CPPUNIT_ASSERT_EQUAL(mpfr_prec_t(128), xf.getPrecision());
+		CPPUNIT_ASSERT_MESSAGE(ss.str(), abs(x - xf) <= 2*eps);
+		CPPUNIT_ASSERT_MESSAGE(ss.str(), abs(y - yf) <= 2*eps);
+		CPPUNIT_ASSERT_MESSAGE(ss.str(), abs(z - zf) <= 2*eps);
+	}
+	
+	//sine and cosine of multiples of 90 are exact
+	internal::DoubleDouble s, c;
+	internal::DegreeSinCos::sinCos(-270, s, c);
+	CPPUNIT_ASSERT(s.hi == 1 && s.lo == 0 && c.hi == 0 && c.lo == 0);
+	internal::DegreeSinCos::sinCos(180, s, c);
+	CPPUNIT_ASSERT(s.hi == 0 && s.lo == 0 && c.hi == -1 && c.lo == 0);
+	
+	//mpfr is used if the inputs are not doubles or more accuracy is needed
+	mpfr::mpreal third = mpfr::mpreal(1, 128) / 3;
+	CPPUNIT_ASSERT(!gc.cartesian(third, mpfr::mpreal(1, 128), xf, yf, zf, 64));
+	CPPUNIT_ASSERT(!gc.cartesian(mpfr::mpreal(1, 128), mpfr::mpreal(1, 128), xf, yf, zf, GeoCalc::cartesian_dd_accuracy+1));
+}
+
+void CalcTest::geoTrigCache() {
+	GeoCalc gc;
+	//grid with a resolution of 1e-7 degree
+	std::vector<mpfr::mpreal> lats, lons;
+	for(int i(0); i < 20; ++i) {
+		lats.push_back(mpfr::mpreal(523456789 + 7*i, 128) / 10000000);
+	}
+	for(int i(0); i < 30; ++i) {
+		lons.push_back(mpfr::mpreal(-134567890 - 3*i, 128) / 10000000);
+	}
+	for(std::size_t maxEntries : {GeoCalc::TrigCache::default_max_entries, std::size_t(16)}) {
+		GeoCalc::TrigCache cache(maxEntries);
+		mpfr::mpreal x, y, z, xc, yc, zc;
+		for(const mpfr::mpreal & lat : lats) {
+			for(const mpfr::mpreal & lon : lons) {
+				std::stringstream ss;
+				ss << "lat=" << lat << " lon=" << lon;
+				gc.cartesian(lat, lon, x, y, z);
+				gc.cartesian(lat, lon, xc, yc, zc, cache);
+				CPPUNIT_ASSERT_MESSAGE(ss.str(), x == xc && y == yc && z == zc);
+				CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), x.getPrecision(), xc.getPrecision());
+				CPPUNIT_ASSERT(cache.size() <= maxEntries);
+			}
+		}
+		CPPUNIT_ASSERT_EQUAL(2*lats.size()*lons.size(), cache.hits() + cache.misses());
+		if (maxEntries >= lats.size() + lons.size()) {
+			CPPUNIT_ASSERT_EQUAL(lats.size() + lons.size(), cache.misses());
+		}
+	}
+	
+	//a different precision of the computation is a different entry
+	GeoCalc::TrigCache cache;
+	mpfr::mpreal x(0, 128), y(0, 128), z(0, 256), x2(0, 128), y2(0, 128), z2(0, 128);
+	gc.cartesian(lats[0], lons[0], x, y, z, cache);
+	CPPUNIT_ASSERT_EQUAL(mpfr_prec_t(256), x.getPrecision());
+	gc.cartesian(lats[0], lons[0], x2, y2, z2, cache);
+	CPPUNIT_ASSERT_EQUAL(std::size_t(4), cache.misses());
+	gc.cartesian(lats[0], lons[0], x, y, z, cache);
+	CPPUNIT_ASSERT_EQUAL(std::size_t(4), cache.misses());
+}
+
+void CalcTest::logHistogram() {
+	//integers up to 2^(precision+1) are exact
+	LogHistogram h(5);
+	for(int i(1); i <= 64; ++i) {
+		h.record(i);
+	}
+	CPPUNIT_ASSERT_EQUAL(std::size_t(64), h.count());
+	CPPUNIT_ASSERT_EQUAL(1.0, h.min());
+	CPPUNIT_ASSERT_EQUAL(64.0, h.max());
+	CPPUNIT_ASSERT_EQUAL(32.5, h.mean());
+	CPPUNIT_ASSERT_EQUAL(32.0, h.quantile(0.5));
+	CPPUNIT_ASSERT_EQUAL(58.0, h.quantile(0.9));
+	CPPUNIT_ASSERT_EQUAL(1.0, h.quantile(0));
+	CPPUNIT_ASSERT_EQUAL(64.0, h.quantile(1));
+	CPPUNIT_ASSERT_THROW(h.record(-1), std::domain_error);
+	CPPUNIT_ASSERT_THROW(h.record(std::numeric_limits<double>::infinity()), std::domain_error);
+	CPPUNIT_ASSERT_THROW(h.record(std::numeric_limits<double>::quiet_NaN()), std::domain_error);
+	CPPUNIT_ASSERT_EQUAL(std::size_t(64), h.count());
+	
+	//the relative error is bounded by 2^-precision, also for values < 1
+	std::mt19937 gen(0);
+	std::lognormal_distribution<double> dist(-20, 8);
+	std::vector<double> values;
+	std::vector<LogHistogram> parts(4, LogHistogram(7));
+	for(std::size_t i(0); i < num_random_test_points; ++i) {
+		values.push_back(dist(gen));
+		parts[i % parts.size()].record(values.back());
+	}
+	values.push_back(0);
+	parts[0].record(0);
+	std::sort(values.begin(), values.end());
+	LogHistogram merged(7);
+	for(const LogHistogram & part : parts) {
+		merged.merge(part);
+	}
+	CPPUNIT_ASSERT_EQUAL(values.size(), merged.count());
+	CPPUNIT_ASSERT_EQUAL(values.front(), merged.min());
+	CPPUNIT_ASSERT_EQUAL(values.back(), merged.max());
+	for(double q : {0.001, 0.1, 0.5, 0.9, 0.99, 0.999}) {
+		double expected = values.at(std::size_t(std::ceil(q*values.size()))-1);
+		double error = std::abs(merged.quantile(q) - expected);
+		CPPUNIT_ASSERT_MESSAGE(std::to_string(q), error <= std::ldexp(expected, -7));
+	}
+	CPPUNIT_ASSERT_EQUAL(0.0, merged.quantile(0.5/values.size()));
+	CPPUNIT_ASSERT_THROW(merged.merge(LogHistogram(5)), std::invalid_argument);
+	
+	//merging per-thread accumulators is the same as accumulating sequentially
+	SnapStats all, first, second;
+	std::vector<mpq_class> pt = {mpq_class(1, 3), mpq_class(mpz_class(1), mpz_class(1) << 100), mpq_class(-2)};
+	for(int i(0); i < 10; ++i) {
+		(i % 2 ? first : second).update(pt.begin(), pt.end());
+		(i % 2 ? first : second).latency.record(100*i);
+		all.update(pt.begin(), pt.end());
+		all.latency.record(100*i);
+	}
+	first.merge(second);
+	CPPUNIT_ASSERT_EQUAL(all.points, first.points);
+	CPPUNIT_ASSERT_EQUAL(std::size_t(30), first.denomBits.count());
+	CPPUNIT_ASSERT_EQUAL(101.0, first.denomBits.max());
+	CPPUNIT_ASSERT_EQUAL(3.0, first.limbs.max());
+	std::stringstream a, b;
+	all.printJson(a);
+	first.printJson(b);
+	CPPUNIT_ASSERT_EQUAL(a.str(), b.str());
+}
+
 void CalcTest::withinSpecial() {
 	mpq_class lower, upper, within;
 	std::stringstream ss;
@@ -0,0 +1,402 @@
+#include <libratss/constants.h>
+#include <libratss/util/BinaryPointStream.h>
+#include <libratss/util/InputOutputPoints.h>
+#include <libratss/util/MappedFile.h>
+#include <libratss/util/TextPointParser.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+
+#include <unistd.h>
+
+#include "TestBase.h"
+
+namespace LIB_RATSS_NAMESPACE {
+namespace tests {
+
+class IOTest: public TestBase {
+CPPUNIT_TEST_SUITE( IOTest );
+CPPUNIT_TEST( binaryRational );
+CPPUNIT_TEST( binaryDouble );
+CPPUNIT_TEST( binaryMpfr );
+CPPUNIT_TEST( binaryInvalid );
+CPPUNIT_TEST( textParser );
+CPPUNIT_TEST_SUITE_END();
+public:
+	void binaryRational();
+	void binaryDouble();
+	void binaryMpfr();
+	void binaryInvalid();
+	void textParser();
+protected:
+	///text input with blank lines in the given format
+	std::string textInput(PointBase::Format fmt, bool trailingNewline);
+	///parses the file with TextPointParser in chunks and with the stream versions and compares the points
+	template<typename T_POINT>
+	void textParserCompare(const MappedFile & file, const std::string & data, PointBase::Format fmt, int precision);
+	///header of a BE_RATIONAL stream with one coordinate followed by the raw size fields and limbs
+	std::string rationalStream(std::int32_t numSize, const std::vector<mp_limb_t> & num, std::uint32_t denSize, const std::vector<mp_limb_t> & den);
+};
+
+}} // end namespace ratss::tests
+
+int main(int argc, char ** argv) {
+	LIB_RATSS_NAMESPACE::tests::TestBase::init(argc, argv);
+	srand( 0 );
+	CppUnit::TextUi::TestRunner runner;
+	runner.addTest(  LIB_RATSS_NAMESPACE::tests::IOTest::suite() );
+	bool ok = runner.run();
+	return ok ? 0 : 1;
+}
+
+namespace LIB_RATSS_NAMESPACE {
+namespace tests {
+
+std::string IOTest::rationalStream(std::int32_t numSize, const std::vector<mp_limb_t> & num, std::uint32_t denSize, const std::vector<mp_limb_t> & den) {
+	std::stringstream ss;
+	BinaryPointHeader(BinaryPointHeader::BE_RATIONAL, 1, 0).write(ss);
+	ss.write(reinterpret_cast<const char*>(&numSize), sizeof(numSize));
+	ss.write(reinterpret_cast<const char*>(num.data()), num.size()*sizeof(mp_limb_t));
+	ss.write(reinterpret_cast<const char*>(&denSize), sizeof(denSize));
+	ss.write(reinterpret_cast<const char*>(den.data()), den.size()*sizeof(mp_limb_t));
+	return ss.str();
+}
+
+void IOTest::binaryRational() {
+	std::vector<RationalPoint> points = {
+		RationalPoint("0 0 1", PointBase::FM_RATIONAL),
+		RationalPoint("-1/3 2/3 -2/3", PointBase::FM_RATIONAL),
+		RationalPoint("3/5 0 -4/5", PointBase::FM_RATIONAL)
+	};
+	RationalPoint big;
+	big.coords = {mpq_class(1, 3), -mpq_class(mpz_class(1) << 200, (mpz_class(1) << 201) + 1), mpq_class(mpz_class(1) << 100)};
+	points.push_back(big);
+
+	std::stringstream ss;
+	BinaryPointWriter writer(ss, PointBase::FM_BINARY_RATIONAL);
+	for(const RationalPoint & p : points) {
+		writer.write(p);
+	}
+	std::string data = ss.str();
+	{
+		std::istringstream is(data);
+		BinaryPointReader reader(is);
+		CPPUNIT_ASSERT_EQUAL(std::uint32_t(3), reader.header().dimension);
+		RationalPoint rp;
+		for(const RationalPoint & p : points) {
+			CPPUNIT_ASSERT(reader.read(rp));
+			CPPUNIT_ASSERT(p.coords == rp.coords);
+		}
+		CPPUNIT_ASSERT(!reader.read(rp));
+	}
+	{
+		std::istringstream is(data);
+		BinaryPointReader reader(is);
+		FloatPoint fp;
+		for(const RationalPoint & p : points) {
+			CPPUNIT_ASSERT(reader.read(fp, 128));
+			for(std::size_t i(0); i < 3; ++i) {
+				CPPUNIT_ASSERT_EQUAL(Conversion<mpq_class>::toMpreal(p.coords[i], 128), fp.coords[i]);
+			}
+		}
+	}
+	//fractions that are not reduced are canonicalized
+	{
+		std::istringstream is(rationalStream(-1, {6}, 1, {4}));
+		BinaryPointReader reader(is);
+		RationalPoint rp;
+		CPPUNIT_ASSERT(reader.read(rp));
+		CPPUNIT_ASSERT_EQUAL(mpq_class(-3, 2), rp.coords.at(0));
+		CPPUNIT_ASSERT_EQUAL(mpz_class(2), rp.coords.at(0).get_den());
+	}
+}
+
+void IOTest::binaryDouble() {
+	FloatPoint p;
+	std::vector<double> values = {0.5, -0.25, 1e-300, 0, -1, 0.1};
+	p.assign(values.begin(), values.end(), 53);
+
+	std::stringstream ss;
+	BinaryPointWriter writer(ss, PointBase::FM_BINARY_FLOAT);
+	writer.write(p);
+	writer.write(p);
+	std::string data = ss.str();
+	CPPUNIT_ASSERT_EQUAL(24 + 2*values.size()*sizeof(double), data.size());
+	{
+		std::istringstream is(data);
+		BinaryPointReader reader(is);
+		CPPUNIT_ASSERT_EQUAL(std::int32_t(53), reader.header().precision);
+		FloatPoint fp;
+		for(int round(0); round < 2; ++round) {
+			CPPUNIT_ASSERT(reader.read(fp, 53));
+			CPPUNIT_ASSERT_EQUAL(values.size(), fp.coords.size());
+			for(std::size_t i(0); i < values.size(); ++i) {
+				CPPUNIT_ASSERT_EQUAL(values[i], fp.coords[i].toDouble());
+			}
+		}
+		CPPUNIT_ASSERT(!reader.read(fp, 53));
+	}
+	{
+		std::istringstream is(data);
+		BinaryPointReader reader(is);
+		RationalPoint rp;
+		CPPUNIT_ASSERT(reader.read(rp));
+		for(std::size_t i(0); i < values.size(); ++i) {
+			CPPUNIT_ASSERT_EQUAL(mpq_class(values[i]), rp.coords[i]);
+		}
+	}
+}
+
+void IOTest::binaryMpfr() {
+	int prec = 128;
+	FloatPoint p;
+	p.coords = {mpfr::mpreal(1, prec)/3, -mpfr::sqrt(mpfr::mpreal(2, prec)), mpfr::mpreal(0, prec), -mpfr::mpreal(0, prec), mpfr::const_infinity(1, prec)};
+
+	std::stringstream ss;
+	BinaryPointWriter writer(ss, PointBase::FM_BINARY_FLOAT128);
+	writer.write(p);
+	//a different precision is rounded to the one of the stream
+	FloatPoint lowPrec;
+	lowPrec.assign(p.coords.begin(), p.coords.begin()+2, 64);
+	lowPrec.coords.push_back(mpfr::mpreal(0.75, 64));
+	lowPrec.coords.push_back(mpfr::mpreal(-2, 64));
+	lowPrec.coords.push_back(mpfr::mpreal(1e10, 64));
+	writer.write(lowPrec);
+
+	std::istringstream is(ss.str());
+	BinaryPointReader reader(is);
+	CPPUNIT_ASSERT_EQUAL(std::int32_t(prec), reader.header().precision);
+	FloatPoint fp;
+	CPPUNIT_ASSERT(reader.read(fp, prec));
+	CPPUNIT_ASSERT_EQUAL(p.coords.size(), fp.coords.size());
+	for(std::size_t i(0); i < p.coords.size(); ++i) {
+		CPPUNIT_ASSERT_EQUAL(prec, int(fp.coords[i].getPrecision()));
+		CPPUNIT_ASSERT(mpfr_equal_p(p.coords[i].mpfr_srcptr(), fp.coords[i].mpfr_srcptr()));
+		CPPUNIT_ASSERT_EQUAL(mpfr_signbit(p.coords[i].mpfr_srcptr()) != 0, mpfr_signbit(fp.coords[i].mpfr_srcptr()) != 0);
+	}
+	CPPUNIT_ASSERT(reader.read(fp, prec));
+	for(std::size_t i(0); i < lowPrec.coords.size(); ++i) {
+		CPPUNIT_ASSERT_EQUAL(lowPrec.coords[i], fp.coords[i]);
+	}
+	CPPUNIT_ASSERT(!reader.read(fp, prec));
+
+	//infinity has no rational value
+	std::istringstream is2(ss.str());
+	BinaryPointReader reader2(is2);
+	RationalPoint rp;
+	CPPUNIT_ASSERT_THROW(reader2.read(rp), std::runtime_error);
+}
+
+void IOTest::binaryInvalid() {
+	RationalPoint p("1/3 -2/3 2/3", PointBase::FM_RATIONAL);
+	std::stringstream ss;
+	BinaryPointWriter writer(ss, PointBase::FM_BINARY_RATIONAL);
+	writer.write(p);
+	std::string data = ss.str();
+	RationalPoint rp;
+
+	//truncated header
+	{
+		std::istringstream is(data.substr(0, 10));
+		CPPUNIT_ASSERT_THROW(BinaryPointReader reader(is), std::runtime_error);
+	}
+	//wrong magic
+	{
+		std::string bad = data;
+		bad[0] = 'X';
+		std::istringstream is(bad);
+		CPPUNIT_ASSERT_THROW(BinaryPointReader reader(is), std::runtime_error);
+	}
+	//unsupported version
+	{
+		std::string bad = data;
+		bad[8] = 2;
+		std::istringstream is(bad);
+		CPPUNIT_ASSERT_THROW(BinaryPointReader reader(is), std::runtime_error);
+	}
+	//invalid encoding and precisions that do not match the encoding
+	for(std::pair<int, std::int32_t> ep : std::vector<std::pair<int, std::int32_t>>{{0, 0}, {7, 0}, {BinaryPointHeader::BE_DOUBLE, 64}, {BinaryPointHeader::BE_RATIONAL, 53}, {BinaryPointHeader::BE_MPFR, 0}}) {
+		std::string bad = data;
+		bad[9] = char(ep.first);
+		std::memcpy(&bad[16], &ep.second, sizeof(ep.second));
+		std::istringstream is(bad);
+		CPPUNIT_ASSERT_THROW(BinaryPointReader reader(is), std::runtime_error);
+	}
+	//truncated point
+	for(std::size_t cut : {std::size_t(1), sizeof(mp_limb_t), sizeof(mp_limb_t)+4}) {
+		std::istringstream is(data.substr(0, data.size()-cut));
+		BinaryPointReader reader(is);
+		CPPUNIT_ASSERT_THROW(reader.read(rp), std::runtime_error);
+	}
+	//size fields that do not fit the stream
+	for(std::int32_t size : {std::numeric_limits<std::int32_t>::min(), std::numeric_limits<std::int32_t>::max(), std::int32_t(1) << 30, -2}) {
+		std::istringstream is(rationalStream(size, {1}, 1, {3}));
+		BinaryPointReader reader(is);
+		CPPUNIT_ASSERT_THROW(reader.read(rp), std::runtime_error);
+	}
+	//zero or too large denominators
+	for(std::uint32_t size : {std::uint32_t(0), std::numeric_limits<std::uint32_t>::max(), std::uint32_t(1) << 30}) {
+		std::istringstream is(rationalStream(1, {1}, size, {3}));
+		BinaryPointReader reader(is);
+		CPPUNIT_ASSERT_THROW(reader.read(rp), std::runtime_error);
+	}
+	//leading zero limb
+	{
+		std::istringstream is(rationalStream(1, {0}, 1, {3}));
+		BinaryPointReader reader(is);
+		CPPUNIT_ASSERT_THROW(reader.read(rp), std::runtime_error);
+	}
+}
+
+namespace {
+
+void assertEqual(const std::string & msg, const FloatPoint & expected, const FloatPoint & p) {
+	CPPUNIT_ASSERT_EQUAL_MESSAGE(msg, expected.coords.size(), p.coords.size());
+	for(std::size_t i(0); i < p.coords.size(); ++i) {
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(msg, expected.coords[i].getPrecision(), p.coords[i].getPrecision());
+		CPPUNIT_ASSERT_MESSAGE(msg, mpfr_equal_p(expected.coords[i].mpfr_srcptr(), p.coords[i].mpfr_srcptr()));
+	}
+}
+
+void assertEqual(const std::string & msg, const RationalPoint & expected, const RationalPoint & p) {
+	CPPUNIT_ASSERT_MESSAGE(msg, expected.coords == p.coords);
+}
+
+} //end namespace
+
+std::string IOTest::textInput(PointBase::Format fmt, bool trailingNewline) {
+	std::mt19937_64 gen(fmt);
+	std::uniform_real_distribution<double> urd(-1, 1);
+	std::ostringstream ss;
+	ss.precision(17);
+	ss << "\n\n";
+	for(std::size_t line(0); line < 200; ++line) {
+		if (line % 7 == 3) {
+			ss << '\n';
+		}
+		if (fmt == PointBase::FM_GEO) {
+			//grid coordinates as in OSM data hit the trigonometric cache
+			ss << (gen() % 1800000000)*1e-7 - 90 << ' ' << (line % 5)*1e-7 + 8.5;
+		}
+		else if (fmt == PointBase::FM_SPHERICAL) {
+			ss << urd(gen)*3 << '\t' << urd(gen)*6;
+		}
+		else {
+			for(int i(0); i < 3; ++i) {
+				if (i) {
+					ss << ' ';
+				}
+				if (fmt == PointBase::FM_CARTESIAN_FLOAT) {
+					ss << (line % 3 ? urd(gen) : urd(gen)*1e-30);
+				}
+				else if (fmt == PointBase::FM_CARTESIAN_FLOAT128) {
+					ss << (mpfr::mpreal(urd(gen), 128)/3).toString(40);
+				}
+				else {
+					//numerators of more than one machine word and fractions that are not reduced
+					mpz_class num = mpz_class(std::int64_t(gen() >> (gen() % 64))) * (line % 4 ? 1 : -6);
+					mpz_class den = mpz_class(gen() | 1) * (line % 11 ? 1 : 4);
+					if (line % 2) {
+						num *= mpz_class(gen());
+					}
+					if (fmt == PointBase::FM_CARTESIAN_RATIONAL) {
+						ss << num << '/' << den;
+					}
+					else {
+						ss << num << ' ' << den;
+					}
+				}
+			}
+		}
+		if (line+1 < 200 || trailingNewline) {
+			ss << '\n';
+		}
+	}
+	return ss.str();
+}
+
+template<typename T_POINT>
+void IOTest::textParserCompare(const MappedFile & file, const std::string & data, PointBase::Format fmt, int precision) {
+	std::vector<T_POINT> expected;
+	std::istringstream is(data);
+	while (is.good()) {
+		for( ; is.good() && is.peek() == '\n'; is.get()) {}
+		if (!is.good()) {
+			break;
+		}
+		expected.emplace_back();
+		expected.back().assign(is, fmt, precision);
+	}
+	CPPUNIT_ASSERT_EQUAL(std::size_t(200), expected.size());
+	
+	std::size_t midLineSplits = 0;
+	TextPointParser parser;
+	T_POINT p;
+	for(std::size_t count(1); count < 20; ++count) {
+		//chunks() moves the boundaries to the next line, check that some of them started in the middle of a line
+		std::size_t rawChunkSize = file.size()/count + 1;
+		if (count > 1 && rawChunkSize < file.size() && file.data()[rawChunkSize-1] != '\n') {
+			++midLineSplits;
+		}
+		std::size_t n = 0;
+		for(const MappedFile::Span & chunk : file.chunks(count)) {
+			CPPUNIT_ASSERT(chunk.begin == file.data() || chunk.begin[-1] == '\n');
+			for(const char * it = chunk.begin; (it = TextPointParser::skipLineBreaks(it, chunk.end)) != chunk.end; ++n) {
+				it = parser.parse(it, chunk.end, fmt, precision, p);
+				CPPUNIT_ASSERT(it == chunk.end || *it == '\n');
+				CPPUNIT_ASSERT(n < expected.size());
+				std::stringstream msg;
+				msg << "Format " << fmt << " with " << count << " chunks at point " << n;
+				assertEqual(msg.str(), expected[n], p);
+			}
+		}
+		CPPUNIT_ASSERT_EQUAL(expected.size(), n);
+	}
+	CPPUNIT_ASSERT(midLineSplits > 0);
+}
+
+void IOTest::textParser() {
+	std::vector<PointBase::Format> floatFormats = {
+		PointBase::FM_CARTESIAN_FLOAT, PointBase::FM_CARTESIAN_FLOAT128,
+		PointBase::FM_CARTESIAN_RATIONAL, PointBase::FM_CARTESIAN_SPLIT_RATIONAL,
+		PointBase::FM_GEO, PointBase::FM_SPHERICAL
+	};
+	char fileName[] = "/tmp/ratss_io_test_XXXXXX";
+	int fd = ::mkstemp(fileName);
+	CPPUNIT_ASSERT(fd >= 0);
+	::close(fd);
+	for(PointBase::Format fmt : floatFormats) {
+		for(bool trailingNewline : {true, false}) {
+			std::string data = textInput(fmt, trailingNewline);
+			{
+				std::ofstream out(fileName, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+				out << data;
+			}
+			MappedFile file(fileName);
+			CPPUNIT_ASSERT_EQUAL(data.size(), file.size());
+			textParserCompare<FloatPoint>(file, data, fmt, 128);
+			textParserCompare<RationalPoint>(file, data, fmt, 128);
+		}
+	}
+	std::remove(fileName);
+	
+	//a point ends at the line break even if the next line has coordinates
+	std::string twoLines = "1/2 1/3\n1/5\n";
+	TextPointParser parser;
+	RationalPoint rp;
+	const char * it = parser.parse(twoLines.data(), twoLines.data()+twoLines.size(), PointBase::FM_RATIONAL, 0, rp);
+	CPPUNIT_ASSERT(it == twoLines.data()+7);
+	CPPUNIT_ASSERT(RationalPoint("1/2 1/3", PointBase::FM_RATIONAL).coords == rp.coords);
+	it = parser.parse(twoLines.data(), twoLines.data()+twoLines.size(), PointBase::FM_RATIONAL, 0, rp, 1);
+	CPPUNIT_ASSERT(it == twoLines.data()+3);
+	std::string oddSplit = "1 2 3";
+	CPPUNIT_ASSERT_THROW(parser.parse(oddSplit.data(), oddSplit.data()+oddSplit.size(), PointBase::FM_SPLIT_RATIONAL, 0, rp), std::runtime_error);
+	std::string bad = "1/0 2";
+	CPPUNIT_ASSERT_THROW(parser.parse(bad.data(), bad.data()+bad.size(), PointBase::FM_RATIONAL, 0, rp), std::runtime_error);
+}
+
+}} //end namespace LIB_RATSS_NAMESPACE::tests
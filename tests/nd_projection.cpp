@@ -1,6 +1,10 @@
 #include <libratss/constants.h>
 #include <libratss/ProjectSN.h>
 #include <libratss/util/InputOutputPoints.h>
+#include <libratss/util/RationalPointStore.h>
+
+#include <algorithm>
+#include <random>
 
 #include "TestBase.h"
 #include "../common/generators.h"
@@ -16,6 +20,7 @@ CPPUNIT_TEST( snapFlPlane );
 CPPUNIT_TEST( snapFxPlane );
 CPPUNIT_TEST( snapCfPlane );
 CPPUNIT_TEST( snapJpPlane );
+CPPUNIT_TEST( snapJpHigherDimensions );
 CPPUNIT_TEST( snapFlSphere );
 CPPUNIT_TEST( snapFxSphere );
 CPPUNIT_TEST( snapCfSphere );
@@ -24,6 +29,12 @@ CPPUNIT_TEST( snaplllSphere );
 // CPPUNIT_TEST( snapJpSphere );
 CPPUNIT_TEST( snapSpecial );
 CPPUNIT_TEST( snapRandomCore );
+CPPUNIT_TEST( snapBatch );
+CPPUNIT_TEST( snapAuto );
+CPPUNIT_TEST( snapCache );
+CPPUNIT_TEST( snapHomogeneous );
+CPPUNIT_TEST( pointStore );
+CPPUNIT_TEST( plane2SphereFixedWidth );
 CPPUNIT_TEST_SUITE_END();
 public:
 	using Projector = ProjectSN;
@@ -49,10 +60,22 @@ public:
 	void snaplllSphere() { snapRandom({ST_FPLLL}, {ST_SPHERE}); }
 public:
 	void snapSpecial();
+	void snapJpHigherDimensions();
 	void snapRandomCore();
+	void snapBatch();
+	void snapAuto();
+	void snapCache();
+	void snapHomogeneous();
+	void pointStore();
+	void plane2SphereFixedWidth();
 protected:
 	void snapCore(const RationalPoint & pt, int significands);
 	void snapRandom(const std::vector<int> & snapMethod, const std::vector<int> & snapLocation);
+	///cartesian coordinates of the first numPoints random points, three consecutive values per point
+	std::vector<mpfr::mpreal> randomInput(std::size_t numPoints, int prec) const;
+	///snaps every point of input on its own, the reference for the batched and cached variants
+	template<typename T_FT>
+	static std::vector<mpq_class> snapEach(const Projector & p, const std::vector<T_FT> & input, const ProjectSN::SnapConfig & sc);
 private:
 	std::vector<SphericalCoord> coords;
 };
@@ -153,6 +176,44 @@ void NDProjectionTest::snapSpecial() {
 	snapCore(pt, 2);
 }
 
+void NDProjectionTest::snapJpHigherDimensions() {
+	Projector p;
+	int prec = 128;
+	std::mt19937_64 gen(0);
+	std::normal_distribution<double> dist;
+	
+	std::size_t numPoints = std::min<std::size_t>(coords.size(), 500);
+	for(std::size_t dims : {4, 5, 6}) {
+		std::vector<mpfr::mpreal> input(dims);
+		std::vector<mpq_class> output(dims);
+		for(std::size_t i(0); i < numPoints; ++i) {
+			for(mpfr::mpreal & x : input) {
+				x = mpfr::mpreal(dist(gen), prec);
+			}
+			p.calc().normalize(input.begin(), input.end(), input.begin());
+			for(int sig : {8, 31, 64}) {
+				mpq_class projEps = mpq_class(mpz_class(1), mpz_class(1) << sig)*2.1;
+				for(int snapType : {ST_JP_GUARANTEE_DISTANCE | ST_PLANE, ST_JP_GUARANTEE_SIZE | ST_PLANE}) {
+					p.snap(input.begin(), input.end(), output.begin(), snapType, sig);
+					std::stringstream ss;
+					ss << "Dimension " << dims << " with " << sig << " significands and snap-type " << ProjectSN::toString((ProjectSN::SnapType) snapType);
+					mpq_class sqLen(0);
+					for(const mpq_class & x : output) {
+						sqLen += x*x;
+					}
+					CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), mpq_class(1), sqLen);
+					if (snapType & ST_GUARANTEE_DISTANCE) {
+						for(std::size_t j(0); j < dims; ++j) {
+							using std::abs;
+							CPPUNIT_ASSERT_MESSAGE(ss.str(), abs(Conversion<mpfr::mpreal>::toMpq(input[j]) - output[j]) <= projEps);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
 void NDProjectionTest::snapRandomCore() {
 	RationalPoint pt(3);
 	for(int significand : NDProjectionTest::significands) {
@@ -167,6 +228,373 @@ void NDProjectionTest::snapRandomCore() {
 	}
 }
 
+std::vector<mpfr::mpreal> NDProjectionTest::randomInput(std::size_t numPoints, int prec) const {
+	GeoCalc gc;
+	numPoints = std::min(numPoints, coords.size());
+	std::vector<mpfr::mpreal> input;
+	input.reserve(3*numPoints);
+	for(std::size_t i(0); i < numPoints; ++i) {
+		mpfr::mpreal x, y, z;
+		gc.cartesianFromSpherical(mpfr::mpreal(coords[i].theta, prec), mpfr::mpreal(coords[i].phi, prec), x, y, z);
+		input.insert(input.end(), {x, y, z});
+	}
+	return input;
+}
+
+template<typename T_FT>
+std::vector<mpq_class> NDProjectionTest::snapEach(const Projector & p, const std::vector<T_FT> & input, const ProjectSN::SnapConfig & sc) {
+	std::vector<mpq_class> result(input.size());
+	for(std::size_t i(0); i < input.size(); i += 3) {
+		p.snap(input.begin()+i, input.begin()+i+3, result.begin()+i, sc);
+	}
+	return result;
+}
+
+void NDProjectionTest::snapBatch() {
+	Projector p;
+	int prec = 128;
+	std::vector<mpfr::mpreal> input = randomInput(coords.size(), prec);
+	
+	std::vector<int> snapTypes = {
+		ST_FX | ST_PLANE | ST_NORMALIZE,
+		ST_CF | ST_SPHERE,
+		ST_JP | ST_PLANE
+	};
+	
+	for(int snapType : snapTypes) {
+		for(int sig : {16, 53}) {
+			ProjectSN::SnapConfig sc(snapType, prec, sig);
+			std::vector<mpq_class> expected = snapEach(p, input, sc);
+			for(std::size_t threads : {1, 2, 4}) {
+				std::vector<mpq_class> output;
+				p.snapBatch(input, 3, output, sc, threads);
+				CPPUNIT_ASSERT_EQUAL(expected.size(), output.size());
+				for(std::size_t i(0); i < expected.size(); ++i) {
+					if (expected[i] != output[i]) {
+						std::stringstream ss;
+						ss << "Batch snapping with " << threads << " threads, " << sig << " significands and snap-type "
+							<< ProjectSN::toString((ProjectSN::SnapType) snapType) << " differs at coordinate " << i;
+						CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), expected[i], output[i]);
+					}
+				}
+			}
+		}
+	}
+	
+	//double input snapped in the plane takes the blocked path
+	std::vector<double> dinput(input.size());
+	std::transform(input.begin(), input.end(), dinput.begin(), [](const mpfr::mpreal & v) { return v.toDouble(); });
+	for(int snapType : {ST_FX | ST_PLANE, ST_FX | ST_PLANE | ST_NORMALIZE, ST_CF | ST_PLANE | ST_NORMALIZE}) {
+		ProjectSN::SnapConfig sc(snapType, 53, 31);
+		std::vector<mpq_class> expected = snapEach(p, dinput, sc);
+		for(std::size_t threads : {1, 3}) {
+			std::vector<mpq_class> output;
+			p.snapBatch(dinput, 3, output, sc, threads);
+			CPPUNIT_ASSERT_MESSAGE(ProjectSN::toString((ProjectSN::SnapType) snapType), expected == output);
+		}
+	}
+	
+	std::vector<mpq_class> output;
+	CPPUNIT_ASSERT_THROW(p.snapBatch(std::vector<mpfr::mpreal>(4), 3, output, ProjectSN::SnapConfig()), std::invalid_argument);
+}
+
+void NDProjectionTest::snapAuto() {
+	Projector p;
+	int prec = 128;
+	
+	//every point is snapped once per candidate for the exhaustive search
+	std::vector<mpfr::mpreal> input = randomInput(500, prec);
+	//exact points reach the lower bound of the distance policies
+	input.insert(input.end(), {mpfr::mpreal(0, prec), mpfr::mpreal(0, prec), mpfr::mpreal(1, prec)});
+	input.insert(input.end(), {mpfr::mpreal(0.6, prec), mpfr::mpreal(0, prec), mpfr::mpreal(-0.8, prec)});
+	
+	const Calc & calc = p.calc();
+	std::vector<int> candidates(AutoSnapStats::candidates.begin(), AutoSnapStats::candidates.begin()+6); //without ST_FPLLL
+	int autoTypes = ST_AUTO | ST_AUTO_CF | ST_AUTO_FX | ST_AUTO_FL | ST_AUTO_JP;
+	for(int policy : AutoSnapStats::policies) {
+		for(int sig : {8, 31, 64}) {
+			SnapWorkspace<mpfr::mpreal> ws, wsParallel;
+			ProjectSN::SnapConfig sc(ST_PLANE | autoTypes | policy, prec, sig);
+			sc.setAutoThreads(3);
+			std::vector<mpq_class> result(3), tmp(3);
+			std::size_t numPoints = input.size()/3;
+			for(std::size_t i(0); i < input.size(); i += 3) {
+				auto begin = input.begin()+i;
+				auto end = begin+3;
+				//exhaustive search
+				std::vector<mpq_class> expected;
+				mpq_class bestGrade;
+				for(int st : candidates) {
+					p.snap(begin, end, tmp.begin(), ST_PLANE | st, sig);
+					mpq_class myGrade;
+					switch (policy) {
+					case ST_AUTO_POLICY_MIN_SUM_DENOM: myGrade = calc.summedDenomSize(tmp.begin(), tmp.end()); break;
+					case ST_AUTO_POLICY_MIN_MAX_DENOM: myGrade = calc.maxDenom(tmp.begin(), tmp.end()); break;
+					case ST_AUTO_POLICY_MIN_TOTAL_LIMBS: myGrade = calc.limbCount(tmp.begin(), tmp.end()); break;
+					case ST_AUTO_POLICY_MIN_SQUARED_DISTANCE: myGrade = calc.squaredDistance(begin, end, tmp.begin()); break;
+					default: myGrade = calc.maxNorm(begin, end, tmp.begin()); break;
+					}
+					if (expected.empty() || myGrade < bestGrade) {
+						expected = tmp;
+						bestGrade = myGrade;
+					}
+				}
+				p.snap(begin, end, result.begin(), ST_PLANE | autoTypes | policy, sig, ws);
+				std::stringstream ss;
+				ss << "Policy " << AutoSnapStats::policyIndex(policy) << " with " << sig << " significands at point " << i/3;
+				CPPUNIT_ASSERT_MESSAGE(ss.str(), expected == result);
+				p.snap(begin, end, result.begin(), sc, wsParallel);
+				CPPUNIT_ASSERT_MESSAGE(ss.str() + " with 3 threads", expected == result);
+			}
+			std::size_t wins = 0;
+			for(int st : candidates) {
+				wins += ws.autoStats.wins(policy, st);
+			}
+			CPPUNIT_ASSERT_EQUAL(numPoints, wins);
+			CPPUNIT_ASSERT_EQUAL(numPoints*candidates.size(), ws.autoStats.graded + ws.autoStats.aborted + ws.autoStats.skipped);
+			std::size_t snapped = 0;
+			for(std::size_t count : ws.autoStats.snapCount) {
+				snapped += count;
+			}
+			CPPUNIT_ASSERT_EQUAL(ws.autoStats.graded + ws.autoStats.aborted, snapped);
+			for(int st : candidates) {
+				CPPUNIT_ASSERT_EQUAL(ws.autoStats.wins(policy, st), wsParallel.autoStats.wins(policy, st));
+			}
+			CPPUNIT_ASSERT_EQUAL(numPoints*candidates.size(), wsParallel.autoStats.graded + wsParallel.autoStats.aborted + wsParallel.autoStats.skipped);
+		}
+	}
+	
+	//the first candidate of a new workspace snaps the exact point with distance 0, all others are skipped
+	for(int policy : {ST_AUTO_POLICY_MIN_SQUARED_DISTANCE, ST_AUTO_POLICY_MIN_MAX_NORM}) {
+		SnapWorkspace<mpfr::mpreal> ws;
+		std::vector<mpq_class> result(3);
+		p.snap(input.end()-6, input.end()-3, result.begin(), ST_PLANE | autoTypes | policy, 31, ws);
+		CPPUNIT_ASSERT_EQUAL(std::size_t(1), ws.autoStats.graded);
+		CPPUNIT_ASSERT_EQUAL(candidates.size()-1, ws.autoStats.skipped);
+		CPPUNIT_ASSERT_EQUAL(std::size_t(1), ws.autoStats.wins(policy, ST_FL));
+	}
+}
+
+void NDProjectionTest::snapCache() {
+	Projector p;
+	int prec = 128;
+	
+	//every point occurs three times
+	std::vector<mpfr::mpreal> input = randomInput(200, prec);
+	std::size_t numCoords = input.size();
+	std::size_t numPoints = numCoords/3;
+	input.insert(input.end(), input.begin(), input.end());
+	input.insert(input.end(), input.begin(), input.begin()+numCoords);
+	
+	for(int snapType : {ST_FX | ST_PLANE | ST_NORMALIZE, ST_CF | ST_SPHERE}) {
+		ProjectSN::SnapConfig sc(snapType, prec, 31);
+		std::vector<mpq_class> expected = snapEach(p, input, sc);
+		
+		auto cache = std::make_shared<SnapCache>();
+		sc.setCache(cache);
+		std::vector<mpq_class> output(input.size());
+		SnapWorkspace<mpfr::mpreal> ws;
+		for(std::size_t i(0); i < input.size(); i += 3) {
+			p.snap(input.begin()+i, input.begin()+i+3, output.begin()+i, sc, ws);
+		}
+		CPPUNIT_ASSERT(expected == output);
+		CPPUNIT_ASSERT_EQUAL(numPoints, cache->misses());
+		CPPUNIT_ASSERT_EQUAL(2*numPoints, cache->hits());
+		CPPUNIT_ASSERT_EQUAL(std::size_t(0), cache->evictions());
+		
+		//the key contains the precision of the input
+		std::vector<mpfr::mpreal> lowPrec(input.begin(), input.begin()+3);
+		for(mpfr::mpreal & v : lowPrec) {
+			v.setPrecision(prec+1);
+		}
+		p.snap(lowPrec.begin(), lowPrec.end(), output.begin(), sc, ws);
+		CPPUNIT_ASSERT_EQUAL(numPoints+1, cache->misses());
+		
+		//a cache smaller than the number of distinct points evicts but returns the same points
+		for(std::size_t threads : {1, 3}) {
+			cache = std::make_shared<SnapCache>(16);
+			sc.setCache(cache);
+			p.snapBatch(input, 3, output, sc, threads);
+			CPPUNIT_ASSERT(expected == output);
+			CPPUNIT_ASSERT_EQUAL(3*numPoints, cache->hits() + cache->misses());
+			CPPUNIT_ASSERT(cache->evictions() > 0);
+		}
+	}
+}
+
+void NDProjectionTest::snapHomogeneous() {
+	Projector p;
+	int prec = 128;
+	
+	std::vector<mpfr::mpreal> input = randomInput(200, prec);
+	//points on the axes and off the sphere
+	input.insert(input.end(), {mpfr::mpreal(0, prec), mpfr::mpreal(0, prec), mpfr::mpreal(-1, prec)});
+	input.insert(input.end(), {mpfr::mpreal(0.6, prec), mpfr::mpreal(0.8, prec), mpfr::mpreal(0, prec)});
+	
+	std::vector<int> snapTypes = {
+		ST_FX | ST_PLANE, ST_CF | ST_PLANE, ST_JP | ST_PLANE, ST_FL | ST_PLANE,
+		ST_FX | ST_SPHERE,
+		ST_CF | ST_PLANE | ST_NORMALIZE,
+		ST_PLANE | ST_AUTO | ST_AUTO_CF | ST_AUTO_FX | ST_AUTO_POLICY_MIN_MAX_DENOM
+	};
+	for(int snapType : snapTypes) {
+		for(int sig : {16, 31, 53}) {
+			ProjectSN::SnapConfig sc(snapType, prec, sig);
+			SnapWorkspace<mpfr::mpreal> ws;
+			std::vector<mpq_class> expected(3);
+			HomogeneousPoint hp;
+			RationalPoint rp;
+			for(std::size_t i(0); i < input.size(); i += 3) {
+				auto begin = input.begin()+i;
+				std::vector<mpfr::mpreal> pt(begin, begin+3);
+				if (snapType & ST_NORMALIZE) {
+					//move the point off the sphere
+					for(mpfr::mpreal & v : pt) {
+						v *= 3;
+					}
+				}
+				p.snap(pt.begin(), pt.end(), expected.begin(), sc);
+				hp.resize(3);
+				p.snapHomogeneous(pt.begin(), pt.end(), hp.coords.begin(), hp.denominator, sc, ws);
+				std::stringstream ss;
+				ss << ProjectSN::toString((ProjectSN::SnapType) snapType) << " with " << sig << " significands at point " << i/3;
+				CPPUNIT_ASSERT_MESSAGE(ss.str(), hp.valid());
+				if (snapType == (ST_FX | ST_PLANE)) {
+					//the numerators are shifted to the largest denominator in the plane
+					CPPUNIT_ASSERT_MESSAGE(ss.str(), mpz_popcount(hp.denominator.get_mpz_t()) == 1);
+				}
+				hp.get(rp);
+				CPPUNIT_ASSERT_MESSAGE(ss.str(), expected == rp.coords);
+				
+				//text roundtrip
+				std::stringstream io;
+				hp.print(io);
+				io << " \n";
+				RationalPoint rp2;
+				rp2.assign(io, PointBase::FM_HOMOGENEOUS, 0);
+				CPPUNIT_ASSERT_MESSAGE(ss.str(), expected == rp2.coords);
+				std::stringstream io2;
+				rp2.print(io2, PointBase::FM_HOMOGENEOUS);
+				HomogeneousPoint hp2;
+				hp2.assign(io2, 3);
+				CPPUNIT_ASSERT_MESSAGE(ss.str(), hp2.valid());
+				hp2.get(rp2);
+				CPPUNIT_ASSERT_MESSAGE(ss.str(), expected == rp2.coords);
+			}
+		}
+	}
+	//an explicit dimension has to match the number of coordinates
+	for(const char * line : {"1 2 3\n", "1 2 3 4 5\n", "1 2 3 4 5 6\n", "1 2 3 4 5"}) {
+		std::stringstream io(line);
+		HomogeneousPoint hp;
+		CPPUNIT_ASSERT_THROW_MESSAGE(line, hp.assign(io, 3), std::runtime_error);
+	}
+	{
+		std::stringstream io("1 2 3 4 \n5");
+		HomogeneousPoint hp;
+		hp.assign(io, 3);
+		CPPUNIT_ASSERT(hp.coords == std::vector<mpz_class>({1, 2, 3}) && hp.denominator == 4);
+		CPPUNIT_ASSERT(io.peek() == '\n');
+	}
+}
+
+void NDProjectionTest::pointStore() {
+	Projector p;
+	int prec = 128;
+	std::vector<mpfr::mpreal> input = randomInput(coords.size(), prec);
+	
+	for(int snapType : {ST_FX | ST_PLANE, ST_JP | ST_PLANE, ST_FX | ST_SPHERE}) {
+		for(int sig : {16, 31, 128}) {
+			ProjectSN::SnapConfig sc(snapType, prec, sig);
+			std::vector<mpq_class> expected;
+			p.snapBatch(input, 3, expected, sc);
+			
+			RationalPointStore store;
+			store.snap(p, input, 3, sc, 2);
+			CPPUNIT_ASSERT_EQUAL(coords.size(), store.size());
+			CPPUNIT_ASSERT_EQUAL(std::size_t(3), store.dimension());
+			RationalPoint rp;
+			for(std::size_t i(0); i < store.size(); ++i) {
+				RationalPointStore::PointView pv = store[i];
+				std::size_t j = 0;
+				for(const RationalPointStore::CoordinateView & v : pv) {
+					CPPUNIT_ASSERT(mpq_equal(v, expected[3*i+j].get_mpq_t()));
+					++j;
+				}
+				CPPUNIT_ASSERT_EQUAL(std::size_t(3), j);
+				CPPUNIT_ASSERT(mpz_cmp(pv[2].get_den_mpz_t(), expected[3*i+2].get_den_mpz_t()) == 0);
+				store.get(i, rp);
+				CPPUNIT_ASSERT(std::equal(rp.coords.begin(), rp.coords.end(), expected.begin()+3*i));
+			}
+		}
+	}
+	
+	//special values
+	RationalPointStore store(3);
+	RationalPoint rp;
+	std::vector<RationalPoint> points = {
+		RationalPoint("0 0 1", PointBase::FM_RATIONAL),
+		RationalPoint("-1/3 2/3 -2/3", PointBase::FM_RATIONAL),
+		RationalPoint("3/5 0 -4/5", PointBase::FM_RATIONAL),
+		RationalPoint("1/2 1/3 -1/7", PointBase::FM_RATIONAL)
+	};
+	rp.coords = {mpq_class(1, 3), -mpq_class(mpz_class(1) << 200, (mpz_class(1) << 201) + 1), mpq_class(mpz_class(1) << 100)};
+	points.push_back(rp);
+	for(const RationalPoint & pt : points) {
+		store.push_back(pt);
+	}
+	CPPUNIT_ASSERT_EQUAL(points.size(), store.size());
+	for(std::size_t i(0); i < points.size(); ++i) {
+		store.get(i, rp);
+		CPPUNIT_ASSERT(points[i].coords == rp.coords);
+		CPPUNIT_ASSERT_EQUAL(points[i].coords[1], store[i][1].get());
+	}
+	//shared denominators are only stored once
+	std::size_t limbs = store.limbCount();
+	store.push_back(points[1]);
+	std::size_t sharedLimbs = store.limbCount() - limbs;
+	store.push_back(RationalPoint("-1/3 2/5 -2/7", PointBase::FM_RATIONAL));
+	CPPUNIT_ASSERT_EQUAL(sharedLimbs + 2, store.limbCount() - limbs - sharedLimbs);
+	CPPUNIT_ASSERT_THROW(store.push_back(RationalPoint("1 0", PointBase::FM_RATIONAL)), std::invalid_argument);
+	CPPUNIT_ASSERT_THROW(store.at(store.size()), std::out_of_range);
+	store.clear();
+	CPPUNIT_ASSERT(store.empty());
+	CPPUNIT_ASSERT_EQUAL(std::size_t(3), store.dimension());
+}
+
+void NDProjectionTest::plane2SphereFixedWidth() {
+	Projector p;
+	std::mt19937_64 gen(0);
+	//denominators of up to 80 bits make sure that we also test the fallback to gmp
+	for(std::size_t round(0); round < num_random_test_points; ++round) {
+		int dims = 2 + gen() % 5;
+		int bits = 1 + gen() % 80;
+		int projCoord = gen() % dims;
+		PositionOnSphere pos = PositionOnSphere((projCoord+1) * (gen() % 2 ? 1 : -1));
+		std::vector<mpq_class> input(dims), output(dims);
+		for(int i(0); i < dims; ++i) {
+			if (i != projCoord) {
+				mpz_class den = mpz_class(1) << (gen() % bits);
+				mpz_class num = mpz_class(gen() >> (64 - std::min(bits, 63)));
+				if (gen() % 2) {
+					num = -num;
+				}
+				input[i] = mpq_class(num, den);
+				input[i].canonicalize();
+			}
+		}
+		p.plane2Sphere(input.begin(), input.end(), pos, output.begin());
+		mpq_class denom(1);
+		for(int i(0); i < dims; ++i) {
+			denom += input[i]*input[i];
+		}
+		for(int i(0); i < dims; ++i) {
+			mpq_class expected = (i == projCoord ? mpq_class((std::signbit<int>(pos) ? 1 : -1) * ((denom-2)/denom)) : mpq_class(2*input[i]/denom));
+			CPPUNIT_ASSERT_EQUAL(expected, output[i]);
+		}
+	}
+}
+
 void NDProjectionTest::snapCore(const RationalPoint & pt, int significand) {
 #if defined(LIB_RATSS_WITH_CGAL)
 	Projector p;
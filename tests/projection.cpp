@@ -146,7 +146,8 @@ void CLS_TMPL_NAME::quadrantTest() {
 		//In the plane we have
 		//y_i = x_i/(1-x_d) = (p_i/2^n)/(1-p_d/2^n) = (p_i/2^n)* 2^n/(2^n-p_d) = p_i/(2^n-p_d)
 		//Thus an lcm of (2^n-p_d)=Q thus Q<=2^(n+1) since p_d may be negative but abs(p_d) <= 2^n
-		switch (snapType) {
+		//ST_FPLLL_WARM_START has the same guarantees as ST_FPLLL
+		switch (snapType & ~ST_FPLLL_WARM_START) {
 		case ST_CF_GUARANTEE_SIZE:
 			maxQ = bits;
 			break;
@@ -291,6 +292,10 @@ int main(int argc, char ** argv) {
 	TEST_INSTANCE(ST_SPHERE, ST_FPLLL_GUARANTEE_DISTANCE);
 	TEST_INSTANCE(ST_PLANE, ST_FPLLL_GUARANTEE_SIZE);
 	TEST_INSTANCE(ST_SPHERE, ST_FPLLL_GUARANTEE_SIZE);
+	TEST_INSTANCE(ST_PLANE, ST_FPLLL_GUARANTEE_DISTANCE | ST_FPLLL_WARM_START);
+	TEST_INSTANCE(ST_SPHERE, ST_FPLLL_GUARANTEE_DISTANCE | ST_FPLLL_WARM_START);
+	TEST_INSTANCE(ST_PLANE, ST_FPLLL_GUARANTEE_SIZE | ST_FPLLL_WARM_START);
+	TEST_INSTANCE(ST_SPHERE, ST_FPLLL_GUARANTEE_SIZE | ST_FPLLL_WARM_START);
 #endif
 	
 #if defined(LIB_RATSS_WITH_CGAL) and defined(LIB_RATSS_WITH_FPLLL)
@@ -2,9 +2,18 @@
 #include <libratss/util/BasicCmdLineOptions.h>
 #include <libratss/util/InputOutputPoints.h>
 #include <libratss/util/InputOutput.h>
+#include <libratss/util/BinaryPointStream.h>
+#include <libratss/util/MappedFile.h>
+#include <libratss/util/TextPointParser.h>
+#include <libratss/internal/BoundedQueue.h>
 
 #include "../common/stats.h"
+#include <chrono>
 #include <fstream>
+#include <sstream>
+#include <map>
+#include <memory>
+#include <thread>
 #include "types.h"
 
 using namespace LIB_RATSS_NAMESPACE;
@@ -14,16 +23,31 @@ class Config: public BasicCmdLineOptions {
 public:
 	bool check{false};
 	bool planeCoords{false};
+	std::size_t threads{1};
+	ProjectSN::SnapConfig snapConfig; //set after parsing, holds the cache shared by all threads
 public:
 	Config() {}
 	using BasicCmdLineOptions::parse;
-	bool parse(const std::string & token, int &, int , char **) override {
+	bool parse(const std::string & token, int & i, int argc, char ** argv) override {
 		if (token == "--check") {
 			check = true;
 		}
 		else if (token == "--print-plane-coords")  {
 			planeCoords = true;
 		}
+		else if (token == "--threads") {
+			if (i+1 < argc) {
+				int n = ::atoi(argv[i+1]);
+				if (n < 0) {
+					throw ParseError("Number of threads has to be >= 0");
+				}
+				threads = n ? n : std::max<std::size_t>(1, std::thread::hardware_concurrency());
+				++i;
+			}
+			else {
+				throw ParseError("--threads needs an argument");
+			}
+		}
 		else {
 			return false;
 		}
@@ -35,20 +59,392 @@ public:
 		out << "prg OPTIONS\n"
 			"Options:\n"
 			"\t--print-plane-coords\tprint coordinates in the plane\n"
-			"\t--check\tcheck projected points\n";
+			"\t--check\tcheck projected points\n"
+			"\t--threads num\tsnap with num threads, 0 uses all cores. Output is identical to the sequential mode\n";
 		out << std::endl;
 	}
 	void print(std::ostream & out) const {
 		out << "Check: " << (check ? "yes" : "no") << '\n';
+		out << "Threads: " << threads << '\n';
 		BasicCmdLineOptions::options_selection(out);
 	}
 };
 
+///Summary of the points snapped by one thread, the text format uses bc and apxds, json and csv use snap
+struct Summary {
+	ratss::BitCount bc;
+	MinMaxMeanStats<double> apxds;
+	SnapStats snap;
+	void merge(const Summary & other) {
+		bc.merge(other.bc);
+		apxds.merge(other.apxds);
+		snap.merge(other.snap);
+	}
+};
+
+///Point sources and sinks other than the text streams of InputOutput
+struct PointIO {
+	//binary point streams, only set if requested by -if/-of
+	std::unique_ptr<BinaryPointReader> binaryInput;
+	std::unique_ptr<BinaryPointWriter> binaryOutput;
+	//text input file, the points are parsed by snapJob
+	MappedFile mappedInput;
+	const char * mappedPos{nullptr};
+};
+
+///A single unit of work: blank lines preceding a point and the point itself
+struct Job {
+	std::size_t seq{0}; //position in the job stream, blank lines at the end of the input get their own job
+	std::size_t id{0}; //number of the point
+	std::size_t blankLines{0};
+	bool hasPoint{false};
+	bool opFromIp{false};
+	bool separator{false};
+	MappedFile::Span text; //unparsed point if the input is memory mapped
+	FloatPoint ip;
+	RationalPoint op;
+	RationalPoint opp;
+	HomogeneousPoint hop; //snapped point if it is written as is in FM_HOMOGENEOUS
+	bool homogeneous{false};
+	std::size_t bitSize{0};
+	mpq_class maxNorm;
+	std::string info; //info output of snapJob in parallel mode
+	std::exception_ptr error;
+};
+
+///Decides how the point of a job is snapped once it was read
+void prepareJob(const Config & cfg, Job & job) {
+	job.opFromIp = !cfg.rationalPassThrough;
+	job.homogeneous = false;
+	if (cfg.rationalPassThrough) {
+		if (!job.op.valid()) {
+			if (!(cfg.snapType & ST_NORMALIZE)) {
+				std::cerr << "Input point read that is not on sphere but no normalization was requested" << std::endl;
+			}
+			else {
+				job.ip.assign(job.op.coords.begin(), job.op.coords.end(), cfg.precision);
+				job.opFromIp = true;
+			}
+		}
+		else if (cfg.check || (cfg.stats & (cfg.SM_DISTANCE_DOUBLE | cfg.SM_DISTANCE_RATIONAL))) {
+			job.ip.assign(job.op.coords.begin(), job.op.coords.end(), cfg.precision);
+		}
+	}
+}
+
+///@return false if there is nothing left to process
+bool readJob(const Config & cfg, InputOutput & io, PointIO & pio, Job & job) {
+	job.blankLines = 0;
+	job.hasPoint = false;
+	job.separator = false;
+	job.text = MappedFile::Span();
+	if (pio.mappedInput.isOpen()) {
+		//only find the line of the point, parsing is done by snapJob
+		const char * end = pio.mappedInput.span().end;
+		const char * it = TextPointParser::skipLineBreaks(pio.mappedPos, end);
+		job.blankLines = it - pio.mappedPos;
+		pio.mappedPos = it;
+		if (it == end) {
+			return job.blankLines;
+		}
+		const char * lineEnd = TextPointParser::nextLine(it, end);
+		if (lineEnd[-1] == '\n') {
+			--lineEnd;
+		}
+		job.text = MappedFile::Span(it, lineEnd);
+		pio.mappedPos = lineEnd;
+		//same as the stream version: the last point is followed by a separator if the input does not end with a line break
+		job.separator = (lineEnd == end);
+		job.hasPoint = true;
+		return true;
+	}
+	if (pio.binaryInput) {
+		if (cfg.rationalPassThrough ? !pio.binaryInput->read(job.op) : !pio.binaryInput->read(job.ip, cfg.precision)) {
+			return false;
+		}
+	}
+	else {
+		for( ; io.input().good() && io.input().peek() == '\n'; ) {
+			io.input().get();
+			++job.blankLines;
+		}
+		if (!io.input().good()) {
+			return job.blankLines;
+		}
+		if (cfg.rationalPassThrough) {
+			job.op.assign(io.input(), cfg.inFormat, cfg.precision);
+		}
+		else {
+			job.ip.assign(io.input(), cfg.inFormat, cfg.precision);
+		}
+	}
+	prepareJob(cfg, job);
+	//binary input has neither separators nor blank lines, every point is written on its own line
+	job.separator = !pio.binaryInput && io.input().peek() != '\n';
+	job.hasPoint = true;
+	return true;
+}
+
+///Snaps, checks and computes the per-point statistics, does not touch the input or output
+///@param ws workspace of the calling thread
+///@param summary accumulator of the calling thread
+void snapJob(const Config & cfg, const ProjectSN & proj, TextPointParser & parser, SnapWorkspace<mpfr::mpreal> & ws, Job & job, std::ostream & info, Summary & summary) {
+	if (!job.hasPoint) {
+		return;
+	}
+	if (!job.text.empty()) {
+		if (cfg.rationalPassThrough) {
+			parser.parse(job.text.begin, job.text.end, cfg.inFormat, cfg.precision, job.op);
+		}
+		else {
+			parser.parse(job.text.begin, job.text.end, cfg.inFormat, cfg.precision, job.ip);
+		}
+		prepareJob(cfg, job);
+	}
+	FloatPoint & ip = job.ip;
+	RationalPoint & op = job.op;
+	if (job.opFromIp) {
+		if (cfg.snapType & ST_NORMALIZE) {
+			if (cfg.verbose) {
+				info << "Normalizing (" << ip << ") to ";
+			}
+			ip.normalize();
+			if (cfg.verbose) {
+				info << '(' << ip << ')' << '\n';
+			}
+		}
+		ip.setPrecision(cfg.precision);
+		//nothing else needs the canonical coordinates, so skip computing them
+		job.homogeneous = (cfg.outFormat == RationalPoint::FM_HOMOGENEOUS && !cfg.check && !cfg.planeCoords && !cfg.stats);
+		if (job.homogeneous) {
+			job.hop.resize(ip.coords.size());
+			proj.snapHomogeneous(ip.coords.begin(), ip.coords.end(), job.hop.coords.begin(), job.hop.denominator, cfg.snapConfig, ws);
+			return;
+		}
+		op.clear();
+		op.resize(ip.coords.size());
+		auto start = std::chrono::steady_clock::now();
+		proj.snap(ip.coords.begin(), ip.coords.end(), op.coords.begin(), cfg.snapConfig, ws);
+		if ((cfg.stats & cfg.SM_SUM) && cfg.statsFormat != cfg.SF_TEXT) {
+			summary.snap.latency.record(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+		}
+		if (cfg.planeCoords) {
+			RationalPoint & opp = job.opp;
+			opp.clear();
+			opp.resize(op.coords.size());
+			auto pos = proj.sphere2Plane(op.coords.begin(), op.coords.end(), opp.coords.begin());
+			using std::swap;
+			swap(opp.coords, op.coords);
+		}
+	}
+	if (cfg.check) {
+		if (!op.valid()) {
+			info << "Invalid projection for point " << ip << std::endl;
+		}
+		for(std::size_t i(0), s(op.coords.size()); i < s; ++i) {
+			auto const & opc = op.coords[i];
+			auto const & ipc = ip.coords[i];
+			if (cfg.snapType & (ST_GUARANTEE_SIZE|ST_FX)) {
+				auto numBits = ::mpz_sizeinbase(opc.get_den_mpz_t(), 2);
+				if (numBits > 2*cfg.significands+1) {
+					info << "Point " << job.id << " exceeds requested denominator size" << std::endl;
+				} 
+			}
+			if (cfg.snapType & (ST_GUARANTEE_DISTANCE|ST_FX|ST_FL)) {
+				if (abs(opc - convert<mpq_class>(ipc)) > mpq_class(mpz_class(1), mpz_class(1) << cfg.significands)) {
+					info << "Point " << job.id << " exceeds requested distance" << std::endl;
+				}
+			}
+		}
+	}
+	if ((cfg.stats & cfg.SM_SIZE_IN_BITS) && (cfg.stats & cfg.SM_EACH)) {
+		job.bitSize = 0;
+		for(auto const & x : op.coords) {
+			job.bitSize = std::max({job.bitSize, mpz_sizeinbase(x.get_den_mpz_t(), 2), mpz_sizeinbase(x.get_num_mpz_t(), 2)});
+		}
+	}
+	if (cfg.stats & (cfg.SM_DISTANCE_DOUBLE | cfg.SM_DISTANCE_RATIONAL)) {
+		job.maxNorm = ip.c.maxNorm(ip.coords.begin(), ip.coords.end(), op.coords.begin());
+	}
+	if ((cfg.stats & cfg.SM_SUM) && cfg.statsFormat == cfg.SF_TEXT) {
+		if (cfg.stats & cfg.SM_SIZE_IN_BITS) {
+			summary.bc.update(op.coords.begin(), op.coords.end());
+		}
+		if (cfg.stats & (cfg.SM_DISTANCE_DOUBLE | cfg.SM_DISTANCE_RATIONAL)) {
+			summary.apxds.update(job.maxNorm.get_d());
+		}
+	}
+	else if (cfg.stats & cfg.SM_SUM) {
+		if (cfg.stats & cfg.SM_SIZE_IN_BITS) {
+			summary.snap.update(op.coords.begin(), op.coords.end());
+		}
+		else {
+			++summary.snap.points;
+		}
+		if (cfg.stats & (cfg.SM_DISTANCE_DOUBLE | cfg.SM_DISTANCE_RATIONAL)) {
+			summary.snap.distance.record(job.maxNorm.get_d());
+		}
+	}
+}
+
+///Writes the job to the output, jobs have to be written in order
+void writeJob(const Config & cfg, const Job & job, InputOutput & io, PointIO & pio) {
+	bool textOutput = !pio.binaryOutput || (cfg.stats & cfg.SM_EACH);
+	for(std::size_t i(0); textOutput && i < job.blankLines; ++i) {
+		io.output().put('\n');
+	}
+	if (!job.hasPoint) {
+		return;
+	}
+	if (job.info.size()) {
+		io.info() << job.info;
+	}
+	const RationalPoint & op = job.op;
+	if (!(cfg.stats & cfg.SM_EACH)) {
+		if (pio.binaryOutput) {
+			pio.binaryOutput->write(op);
+		}
+		else if (job.homogeneous) {
+			job.hop.print(io.output());
+		}
+		else {
+			op.print(io.output(), cfg.outFormat);
+		}
+	}
+	if (cfg.stats & cfg.SM_EACH) {
+		bool hasPrev = false;
+		if (cfg.stats & cfg.SM_SIZE_IN_BITS) {
+			io.output() << job.bitSize;
+			hasPrev = true;
+		}
+		if (cfg.stats & cfg.SM_DISTANCE_DOUBLE) {
+			if (hasPrev) {
+				io.output() << ';';
+			}
+			io.output() << mpfr::mpreal(job.maxNorm.get_d());
+			hasPrev = true;
+		}
+		if (cfg.stats & cfg.SM_DISTANCE_RATIONAL) {
+			if (hasPrev) {
+				io.output() << ';';
+			}
+			io.output() << job.maxNorm;
+			hasPrev = true;
+		}
+	}
+
+	if (textOutput && job.separator) {
+		io.output().put(' ');
+	}
+	else if (textOutput && pio.binaryInput) {
+		io.output().put('\n');
+	}
+	
+	std::size_t counter = job.id+1;
+	if (cfg.progress && counter % 1000 == 0) {
+		io.info() << '\xd' << counter/1000 << "k" << std::flush;
+	}
+}
+
+void runSequential(const Config & cfg, const ProjectSN & proj, InputOutput & io, PointIO & pio, Summary & summary) {
+	Job job;
+	TextPointParser parser;
+	SnapWorkspace<mpfr::mpreal> ws;
+	for(std::size_t counter(0); readJob(cfg, io, pio, job); ) {
+		job.id = counter;
+		snapJob(cfg, proj, parser, ws, job, io.info(), summary);
+		writeJob(cfg, job, io, pio);
+		if (job.hasPoint) {
+			++counter;
+		}
+	}
+}
+
+///The calling thread reads the input, cfg.threads workers snap and a writer thread restores the input order
+///Jobs are recycled by the writer, so at most 64*cfg.threads jobs are in flight. This also bounds the reorder buffer of the writer if a single point is slow.
+void runParallel(const Config & cfg, const ProjectSN & proj, InputOutput & io, PointIO & pio, Summary & summary) {
+	using JobPtr = std::unique_ptr<Job>;
+	using JobQueue = internal::BoundedQueue<JobPtr>;
+	
+	std::size_t queueSize = 64*cfg.threads;
+	JobQueue todo(queueSize);
+	JobQueue done(queueSize);
+	JobQueue unused(queueSize);
+	for(std::size_t i(0); i < queueSize; ++i) {
+		unused.push(JobPtr(new Job()));
+	}
+	
+	std::vector<std::thread> workers;
+	std::vector<Summary> workerSummaries(cfg.threads);
+	for(std::size_t i(0); i < cfg.threads; ++i) {
+		workers.emplace_back([&cfg, &proj, &todo, &done, &mySummary = workerSummaries[i]]() {
+			ProjectSN myProj(proj);
+			TextPointParser parser;
+			SnapWorkspace<mpfr::mpreal> ws;
+			std::ostringstream info;
+			JobPtr job;
+			while (todo.pop(job)) {
+				try {
+					info.str(std::string());
+					snapJob(cfg, myProj, parser, ws, *job, info, mySummary);
+					job->info = info.str();
+				}
+				catch (...) {
+					job->error = std::current_exception();
+				}
+				done.push(std::move(job));
+			}
+		});
+	}
+	
+	std::thread writer([&cfg, &io, &pio, &done, &unused]() {
+		std::map<std::size_t, JobPtr> pending;
+		std::size_t nextSeq = 0;
+		JobPtr job;
+		while (done.pop(job)) {
+			std::size_t seq = job->seq;
+			pending.emplace(seq, std::move(job));
+			for(auto it = pending.begin(); it != pending.end() && it->first == nextSeq; it = pending.erase(it), ++nextSeq) {
+				if (it->second->error) {
+					//same behavior as an uncaught exception in sequential mode
+					std::rethrow_exception(it->second->error);
+				}
+				writeJob(cfg, *(it->second), io, pio);
+				unused.push(std::move(it->second));
+			}
+		}
+	});
+	
+	for(std::size_t seq(0), counter(0); ; ++seq) {
+		//blocks while all jobs are in flight
+		JobPtr job;
+		unused.pop(job);
+		job->error = nullptr;
+		if (!readJob(cfg, io, pio, *job)) {
+			break;
+		}
+		job->seq = seq;
+		job->id = counter;
+		if (job->hasPoint) {
+			++counter;
+		}
+		todo.push(std::move(job));
+	}
+	todo.close();
+	for(std::thread & t : workers) {
+		t.join();
+	}
+	done.close();
+	writer.join();
+	for(const Summary & s : workerSummaries) {
+		summary.merge(s);
+	}
+}
+
 int main(int argc, char ** argv) {
 	Config cfg;
 	ProjectSN proj;
-	ratss::BitCount bc;
-	MinMaxMeanStats<double> apxds;
+	Summary summary;
 
 	int ret = cfg.parse(argc, argv); 
 	
@@ -57,9 +453,31 @@ int main(int argc, char ** argv) {
 		return ret;
 	}
 	
+	cfg.snapConfig = ProjectSN::SnapConfig(cfg.snapType, cfg.precision, cfg.significands);
+	if (cfg.cacheSize) {
+		cfg.snapConfig.setCache(std::make_shared<SnapCache>(cfg.cacheSize));
+	}
+	
 	InputOutput io;
-	io.setInput(cfg.inFileName);
-	io.setOutput(cfg.outFileName);
+	io.setInput(cfg.inFileName, cfg.binaryInput() ? std::ios_base::in|std::ios_base::binary : std::ios_base::in);
+	io.setOutput(cfg.outFileName, cfg.binaryOutput() ? std::ios_base::out|std::ios_base::binary : std::ios_base::out);
+	
+	PointIO pio;
+	if (cfg.binaryInput()) {
+		pio.binaryInput.reset(new BinaryPointReader(io.input()));
+	}
+	else if (cfg.inFileName.size()) {
+		try {
+			pio.mappedInput.open(cfg.inFileName);
+			pio.mappedPos = pio.mappedInput.data();
+		}
+		catch (const std::runtime_error &) {
+			//not a regular file, use the input stream
+		}
+	}
+	if (cfg.binaryOutput()) {
+		pio.binaryOutput.reset(new BinaryPointWriter(io.output(), cfg.outFormat));
+	}
 	
 	if (cfg.verbose) {
 		cfg.print(io.info());
@@ -89,142 +507,37 @@ int main(int argc, char ** argv) {
 		io.output() << std::setprecision(std::numeric_limits<double>::digits10+1);
 	}
 	
-	FloatPoint ip;
-	RationalPoint op;
-	RationalPoint opp;
-	
 	if (cfg.progress) {
 		io.info() << std::endl;
 	}
-	std::size_t counter = 0;
-	while( io.input().good() ) {
-		for( ; io.input().good() && io.input().peek() == '\n'; ) {
-			io.input().get();
-			io.output().put('\n');
-		}
-		if (!io.input().good()) {
-			break;
+	
+	if (cfg.threads > 1) {
+		runParallel(cfg, proj, io, pio, summary);
+	}
+	else {
+		runSequential(cfg, proj, io, pio, summary);
+	}
+	
+	if (cfg.verbose && cfg.snapConfig.cache()) {
+		const SnapCache & cache = *cfg.snapConfig.cache();
+		io.info() << "Cache hit rate: " << cache.hitRate() << " (" << cache.hits() << " hits, " << cache.misses() << " misses, " << cache.evictions() << " evictions)" << std::endl;
+	}
+	
+	if ((cfg.stats & cfg.SM_SUM) && cfg.statsFormat == cfg.SF_TEXT) {
+		io.info() << summary.bc << std::endl;
+		if (cfg.stats & (cfg.SM_DISTANCE_DOUBLE | cfg.SM_DISTANCE_RATIONAL)) {
+			io.info() << "Distance to input:" << std::endl;
+			summary.apxds.print(io.info(), "\t");
+			io.info() << std::endl;
 		}
-		bool opFromIp = !cfg.rationalPassThrough;
-		if (cfg.rationalPassThrough) {
-			op.assign(io.input(), cfg.inFormat, cfg.precision);
-			if (!op.valid()) {
-				if (!(cfg.snapType & ST_NORMALIZE)) {
-					std::cerr << "Input point read that is not on sphere but no normalization was requested" << std::endl;
-				}
-				else {
-					ip.assign(op.coords.begin(), op.coords.end(), cfg.precision);
-					opFromIp = true;
-				}
-			}
+	}
+	else if (cfg.stats & cfg.SM_SUM) {
+		if (cfg.statsFormat == cfg.SF_JSON) {
+			summary.snap.printJson(io.info());
 		}
 		else {
-			ip.assign(io.input(), cfg.inFormat, cfg.precision);
-		}
-		
-		if (opFromIp) {
-			if (cfg.snapType & ST_NORMALIZE) {
-				if (cfg.verbose) {
-					io.info() << "Normalizing (" << ip << ") to ";
-				}
-				ip.normalize();
-				if (cfg.verbose) {
-					io.info() << '(' << ip << ')' << '\n';
-				}
-			}
-			ip.setPrecision(cfg.precision);
-			op.clear();
-			op.resize(ip.coords.size());
-			proj.snap(ip.coords.begin(), ip.coords.end(), op.coords.begin(), cfg.snapType, cfg.significands);
-			if (cfg.planeCoords) {
-				opp.clear();
-				opp.resize(op.coords.size());
-				auto pos = proj.sphere2Plane(op.coords.begin(), op.coords.end(), opp.coords.begin());
-				using std::swap;
-				swap(opp.coords, op.coords);
-			}
-		}
-		if (cfg.check) {
-			if (!op.valid()) {
-				io.info() << "Invalid projection for point " << ip << std::endl;
-			}
-			for(std::size_t i(0), s(op.coords.size()); i < s; ++i) {
-				auto const & opc = op.coords[i];
-				auto const & ipc = ip.coords[i];
-				if (cfg.snapType & (ST_GUARANTEE_SIZE|ST_FX)) {
-					auto numBits = ::mpz_sizeinbase(opc.get_den_mpz_t(), 2);
-					if (numBits > 2*cfg.significands+1) {
-						io.info() << "Point " << counter << " exceeds requested denominator size" << std::endl;
-					} 
-				}
-				if (cfg.snapType & (ST_GUARANTEE_DISTANCE|ST_FX|ST_FL)) {
-					if (abs(opc - convert<mpq_class>(ipc)) > mpq_class(mpz_class(1), mpz_class(1) << cfg.significands)) {
-						io.info() << "Point " << counter << " exceeds requested distance" << std::endl;
-					}
-				}
-			}
+			summary.snap.printCsv(io.info());
 		}
-		if (!(cfg.stats & cfg.SM_EACH)) {
-			op.print(io.output(), cfg.outFormat);
-		}
-		if (cfg.stats) {
-			bool hasPrev = false;
-			if (cfg.stats & cfg.SM_SIZE_IN_BITS) {
-				if (cfg.stats & cfg.SM_SUM) {
-					bc.update(op.coords.begin(), op.coords.end());
-				}
-				if (cfg.stats & cfg.SM_EACH) {
-					size_t v = 0;
-					for(auto const & x : op.coords) {
-						v = std::max({v, mpz_sizeinbase(x.get_den_mpz_t(), 2), mpz_sizeinbase(x.get_num_mpz_t(), 2)});
-					}
-					io.output() << v;
-					hasPrev = true;
-				}
-			}
-			if (cfg.stats & (cfg.SM_DISTANCE_DOUBLE | cfg.SM_DISTANCE_RATIONAL)) {
-				auto mn = ip.c.maxNorm(ip.coords.begin(), ip.coords.end(), op.coords.begin());
-				if (cfg.stats & cfg.SM_DISTANCE_DOUBLE) {
-					if (cfg.stats & cfg.SM_SUM) {
-						apxds.update(mn.get_d());
-					}
-					if (cfg.stats & cfg.SM_EACH) {
-						if (hasPrev) {
-							io.output() << ';';
-						}
-						io.output() << mpfr::mpreal(mn.get_d());
-						hasPrev = true;
-					}
-				}
-				if (cfg.stats & cfg.SM_DISTANCE_RATIONAL) {
-					if (cfg.stats & cfg.SM_SUM) {
-						apxds.update(mn.get_d());
-					}
-					if (cfg.stats & cfg.SM_EACH) {
-						if (hasPrev) {
-							io.output() << ';';
-						}
-						io.output() << mn;
-						hasPrev = true;
-					}
-				}
-			}
-		}
-
-		if (io.input().peek() != '\n') {
-			io.output().put(' ');
-		}
-		
-		++counter;
-		if (cfg.progress && counter % 1000 == 0) {
-			io.info() << '\xd' << counter/1000 << "k" << std::flush;
-		}
-	}
-	
-	if (cfg.stats & cfg.SM_SUM) {
-		io.info() << bc << std::endl;
-		io.info() << "Distance to input:" << std::endl;
-		apxds.print(io.info(), "\t");
 		io.info() << std::endl;
 	}
 	
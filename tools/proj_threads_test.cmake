@@ -0,0 +1,57 @@
+#Checks that proj --threads writes the same output as the sequential proj
+#Usage: cmake -DPROJ=<proj> -DRNDPOINTS=<rndpoints> -DWORK_DIR=<dir> -P proj_threads_test.cmake
+
+file(MAKE_DIRECTORY "${WORK_DIR}")
+set(INPUT "${WORK_DIR}/input.txt")
+
+execute_process(
+	COMMAND "${RNDPOINTS}" -g nsphere -f float -d 3 -n 2000
+	OUTPUT_FILE "${INPUT}"
+	RESULT_VARIABLE result
+)
+if (NOT result EQUAL 0)
+	message(FATAL_ERROR "rndpoints failed: ${result}")
+endif()
+#blank lines and a last point without a line break
+file(READ "${INPUT}" inputText)
+file(WRITE "${WORK_DIR}/input_no_newline.txt" "${inputText}\n\n1 0 0")
+
+function(compare_proj name input)
+	set(options ${ARGN})
+	foreach(threads 1 4)
+		execute_process(
+			COMMAND "${PROJ}" ${options} --threads ${threads} -i "${input}" -o "${WORK_DIR}/${name}_${threads}_file.txt"
+			OUTPUT_FILE "${WORK_DIR}/${name}_${threads}_file_info.txt"
+			RESULT_VARIABLE result
+		)
+		if (NOT result EQUAL 0)
+			message(FATAL_ERROR "proj ${name} with ${threads} threads failed: ${result}")
+		endif()
+		execute_process(
+			COMMAND "${PROJ}" ${options} --threads ${threads}
+			INPUT_FILE "${input}"
+			OUTPUT_FILE "${WORK_DIR}/${name}_${threads}_stream.txt"
+			RESULT_VARIABLE result
+		)
+		if (NOT result EQUAL 0)
+			message(FATAL_ERROR "proj ${name} with ${threads} threads on stdin failed: ${result}")
+		endif()
+	endforeach()
+	foreach(suffix file file_info stream)
+		execute_process(
+			COMMAND ${CMAKE_COMMAND} -E compare_files "${WORK_DIR}/${name}_1_${suffix}.txt" "${WORK_DIR}/${name}_4_${suffix}.txt"
+			RESULT_VARIABLE result
+		)
+		if (NOT result EQUAL 0)
+			message(FATAL_ERROR "proj ${name}: output of --threads 4 differs from sequential output (${suffix})")
+		endif()
+	endforeach()
+endfunction()
+
+#-i memory maps the input, stdin is read through streams
+compare_proj(fx "${INPUT}" -if float -of rational -s fx -p 31)
+compare_proj(cf "${INPUT}" -if float -of split -s cf -p 31)
+compare_proj(homogeneous "${INPUT}" -if float -of homogeneous -s fx -p 31)
+compare_proj(each "${INPUT}" -if float -of rational -s jp -p 31 --stats each --stats bits --stats distd)
+compare_proj(sum "${INPUT}" -if float -of rational -s fx -p 31 --stats sum --stats bits)
+compare_proj(no_newline "${WORK_DIR}/input_no_newline.txt" -if float -of rational -s fx -p 31)
@@ -95,6 +95,11 @@ int main(int argc, char ** argv) {
 		return ret;
 	}
 	
+	if (cfg.binaryInput() || cfg.binaryOutput()) {
+		std::cerr << "Binary point formats are only supported by proj" << std::endl;
+		return -1;
+	}
+	
 	InputOutput io;
 	io.setInput(cfg.inFileName);
 	io.setOutput(cfg.outFileName);
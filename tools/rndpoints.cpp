@@ -112,6 +112,8 @@ struct GeoPointGenerator: PointGenerator {
 
 struct GeoGridGenerator: PointGenerator {
 	ProjectS2 proj;
+	//every latitude and longitude occurs many times
+	GeoCalc::TrigCache trig;
 	
 	virtual ~GeoGridGenerator() {}
 	
@@ -144,7 +146,7 @@ struct GeoGridGenerator: PointGenerator {
 			for( uint32_t sLon=0; sLon < 4*nofSlices; ++sLon ){
 				RationalPoint ret(3);
 				double lon = angleInc * sLon;
-				proj.projectFromGeo( mpfr::mpreal(lat), mpfr::mpreal(lon), ret.coords[0], ret.coords[1], ret.coords[2]);
+				proj.projectFromGeo( mpfr::mpreal(lat), mpfr::mpreal(lon), ret.coords[0], ret.coords[1], ret.coords[2], -1, ST_FX | ST_PLANE | ST_NORMALIZE, &trig);
 				result.push_back( ret );
 			}
 		}
@@ -47,6 +47,11 @@ int main(int argc, char ** argv) {
 		cfg.help(std::cout);
 	}
 	
+	if (cfg.binaryInput()) {
+		std::cerr << "Binary point formats are only supported by proj" << std::endl;
+		return -1;
+	}
+	
 	InputOutput io;
 	io.setInput(cfg.inFileName);
 	io.setOutput(cfg.outFileName);